@@ -8,6 +8,7 @@
 
 /* Included standard headers */
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <limits>
 #include <stdint.h>
@@ -21,6 +22,9 @@
 /* Include the tested architecture-specific header */
 #include "arch_device_api.h"
 
+/* Velocity moment kernels tested in test 9 */
+#include "../vlasovsolver/cpu_block_moments.h"
+
 /* Host execution of min() and max() require using std namespace */
 using namespace std;
 
@@ -355,6 +359,88 @@ typename std::enable_if<I == 8, std::tuple<bool, double, double>>::type test(){
   return std::make_tuple(success, arch_time, host_time);
 }
 
+/* Velocity moments of a distribution: the fused single pass of the moment 
+ * kernels (blockVelocityMoments, zeroth, first and second moment sums relative 
+ * to a shift velocity) against the previous two-pass evaluation (first moments, 
+ * then second moments about the resulting bulk velocity).
+ */
+template<uint I>
+typename std::enable_if<I == 9, std::tuple<bool, double, double>>::type test(){
+
+  volatile uint size = 1e4;
+  const uint n_blocks = size;
+  const Real dv = 1.0e4, shift = 5.0e5;
+
+  /* Distribution values and block parameters of a drifting population */
+  std::vector<Realf> f(n_blocks * WID3);
+  std::vector<Real> params(n_blocks * BlockParams::N_VELOCITY_BLOCK_PARAMS);
+  for (uint b = 0; b < n_blocks; ++b){
+    Real *p = &params[b * BlockParams::N_VELOCITY_BLOCK_PARAMS];
+    p[BlockParams::VXCRD] = (Real)((b >> 0) % 32) * WID * dv + 4.0e5;
+    p[BlockParams::VYCRD] = (Real)((b >> 5) % 32) * WID * dv + 4.0e5;
+    p[BlockParams::VZCRD] = (Real)((b >> 10) % 32) * WID * dv + 4.0e5;
+    p[BlockParams::DVX] = p[BlockParams::DVY] = p[BlockParams::DVZ] = dv;
+    for (uint c = 0; c < WID3; ++c)
+      f[b * WID3 + c] = (Realf)(1.0e-15 * (1 + (b * WID3 + c) % 97));
+  }
+  arch::buf<Realf> fBuffer(f.data(), f.size() * sizeof(Realf));
+  arch::buf<Real> paramsBuffer(params.data(), params.size() * sizeof(Real));
+
+  Real sum_arch[7] = {};
+  clock_t arch_start = clock();
+  blockVelocityMoments(fBuffer, paramsBuffer, shift, shift, shift, sum_arch, n_blocks);
+  double arch_time = (double)((clock() - arch_start) * 1e6 / CLOCKS_PER_SEC);
+
+  double sum_host[4] = {};
+  double second_host[3] = {};
+  clock_t host_start = clock();
+  for (uint b = 0; b < n_blocks; ++b){
+    const Real *p = &params[b * BlockParams::N_VELOCITY_BLOCK_PARAMS];
+    const double dv3 = p[BlockParams::DVX] * p[BlockParams::DVY] * p[BlockParams::DVZ];
+    for (uint k = 0; k < WID; ++k)
+      for (uint j = 0; j < WID; ++j)
+        for (uint i = 0; i < WID; ++i){
+          const double n = f[b * WID3 + cellIndex(i, j, k)] * dv3;
+          sum_host[0] += n;
+          sum_host[1] += n * (p[BlockParams::VXCRD] + (i + 0.5) * p[BlockParams::DVX]);
+          sum_host[2] += n * (p[BlockParams::VYCRD] + (j + 0.5) * p[BlockParams::DVY]);
+          sum_host[3] += n * (p[BlockParams::VZCRD] + (k + 0.5) * p[BlockParams::DVZ]);
+        }
+  }
+  const double bulk_host[3] = {sum_host[1] / sum_host[0], sum_host[2] / sum_host[0], sum_host[3] / sum_host[0]};
+  for (uint b = 0; b < n_blocks; ++b){
+    const Real *p = &params[b * BlockParams::N_VELOCITY_BLOCK_PARAMS];
+    const double dv3 = p[BlockParams::DVX] * p[BlockParams::DVY] * p[BlockParams::DVZ];
+    for (uint k = 0; k < WID; ++k)
+      for (uint j = 0; j < WID; ++j)
+        for (uint i = 0; i < WID; ++i){
+          const double n = f[b * WID3 + cellIndex(i, j, k)] * dv3;
+          const double vx = p[BlockParams::VXCRD] + (i + 0.5) * p[BlockParams::DVX] - bulk_host[0];
+          const double vy = p[BlockParams::VYCRD] + (j + 0.5) * p[BlockParams::DVY] - bulk_host[1];
+          const double vz = p[BlockParams::VZCRD] + (k + 0.5) * p[BlockParams::DVZ] - bulk_host[2];
+          second_host[0] += n * vx * vx;
+          second_host[1] += n * vy * vy;
+          second_host[2] += n * vz * vz;
+        }
+  }
+  double host_time = (double)((clock() - host_start) * 1e6 / CLOCKS_PER_SEC);
+
+  /* Second moments about the bulk velocity from the shifted sums, as in the 
+   * moment kernels. The kernel accumulates in Real, so the tolerance follows 
+   * its precision (about 5e-3 for float, 6e-6 for double). */
+  const double tol = std::cbrt(std::numeric_limits<Real>::epsilon());
+  bool success = std::abs(sum_arch[0] - sum_host[0]) <= tol * sum_host[0];
+  for (uint d = 0; d < 3; ++d){
+    const double flux = sum_arch[1 + d] + shift * sum_arch[0];
+    const double delta = flux / sum_arch[0] - shift;
+    const double second = sum_arch[4 + d] - 2.0 * delta * sum_arch[1 + d] + delta * delta * sum_arch[0];
+    success = success && std::abs(flux - sum_host[1 + d]) <= tol * std::abs(sum_host[1 + d]);
+    success = success && std::abs(second - second_host[d]) <= tol * second_host[d];
+  }
+
+  return std::make_tuple(success, arch_time, host_time);
+}
+
 /* Instantiate each test function by recursively calling the
  * driver function in a descending order beginning from `N - 1`
  */
@@ -376,7 +462,7 @@ struct test_instatiator<N, 0> {
 int main(){
     
   /* Specify the number of tests and set function pointers */
-  constexpr uint n_tests = 9;
+  constexpr uint n_tests = 10;
   std::tuple<bool, double, double>(*fptr_test[n_tests])();
   test_instatiator<n_tests, n_tests>::driver(fptr_test);
 
@@ -23,32 +23,34 @@
 #include "../common.h"
 #include "../definitions.h"
 #include "../parameters.h"
+#include "../logger.h"
 #include "cmath"
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
 #include "backgroundfield.h"
 #include "fieldfunction.hpp"
 #include "integratefunction.hpp"
 
-//FieldFunction should be initialized
-void setBackgroundField(
-   FieldFunction& bgFunction,
-   FsGrid< Real, fsgrids::bgbfield::N_BGB, FS_STENCIL_WIDTH> & BgBGrid,
-   bool append) {
-   
-   /*if we do not add a new background to the existing one we first put everything to zero*/
-   if(append==false) {
-      setBackgroundFieldToZero(BgBGrid);
-   }
-   
+extern Logger logFile;
+
+/*! Integrates the face and volume averages of the background field and their derivatives over one fsgrid cell.
+ * \param bgFunction The field function, its component and derivative settings are changed
+ * \param start Coordinates of the lower corner of the cell
+ * \param dx Size of the cell
+ * \param result Array of fsgrids::bgbfield::N_BGB values the averages are added to
+ */
+static void integrateBackgroundField(FieldFunction& bgFunction,const double start[3],const double dx[3],double* result) {
    //these are doubles, as the averaging functions copied from Gumics
    //use internally doubles. In any case, it should provide more
    //accurate results also for float simulations
-   double accuracy = 1e-17;
-   double start[3];
+   const double accuracy = 1e-17;
    double end[3];
-   double dx[3];
    unsigned int faceCoord1[3];
    unsigned int faceCoord2[3];
-   
+
    //the coordinates of the edges face with a normal in the third coordinate direction, stored here to enable looping
    faceCoord1[0]=1;
    faceCoord2[0]=2;
@@ -56,75 +58,183 @@ void setBackgroundField(
    faceCoord2[1]=2;
    faceCoord1[2]=0;
    faceCoord2[2]=1;
-   
+
+   end[0]=start[0]+dx[0];
+   end[1]=start[1]+dx[1];
+   end[2]=start[2]+dx[2];
+
+   //Face averages
+   for(uint fComponent=0; fComponent<3; fComponent++){
+      bgFunction.setDerivative(0);
+      bgFunction.setComponent((coordinate)fComponent);
+      result[fsgrids::bgbfield::BGBX+fComponent] +=
+         surfaceAverage(bgFunction,
+            (coordinate)fComponent,
+                        accuracy,
+                        start,
+                        dx[faceCoord1[fComponent]],
+                        dx[faceCoord2[fComponent]]
+                       );
+
+      //Compute derivatives. Note that we scale by dx[] as the arrays are assumed to contain differences, not true derivatives!
+      bgFunction.setDerivative(1);
+      bgFunction.setDerivComponent((coordinate)faceCoord1[fComponent]);
+      result[fsgrids::bgbfield::dBGBxdy+2*fComponent] +=
+         dx[faceCoord1[fComponent]] *
+         surfaceAverage(bgFunction,
+            (coordinate)fComponent,
+                        accuracy,
+                        start,
+                        dx[faceCoord1[fComponent]],
+                        dx[faceCoord2[fComponent]]
+                       );
+      bgFunction.setDerivComponent((coordinate)faceCoord2[fComponent]);
+      result[fsgrids::bgbfield::dBGBxdy+1+2*fComponent] +=
+         dx[faceCoord2[fComponent]] *
+         surfaceAverage(bgFunction,
+            (coordinate)fComponent,
+                        accuracy,
+                        start,
+                        dx[faceCoord1[fComponent]],
+                        dx[faceCoord2[fComponent]]
+                       );
+   }
+
+   //Volume averages
+   for(unsigned int fComponent=0;fComponent<3;fComponent++){
+      bgFunction.setDerivative(0);
+      bgFunction.setComponent((coordinate)fComponent);
+      result[fsgrids::bgbfield::BGBXVOL+fComponent] += volumeAverage(bgFunction,accuracy,start,end);
+
+      //Compute derivatives. Note that we scale by dx[] as the arrays are assumed to contain differences, not true derivatives!
+      bgFunction.setDerivative(1);
+      bgFunction.setDerivComponent((coordinate)faceCoord1[fComponent]);
+      result[fsgrids::bgbfield::dBGBXVOLdy+2*fComponent] += dx[faceCoord1[fComponent]] * volumeAverage(bgFunction,accuracy,start,end);
+      bgFunction.setDerivComponent((coordinate)faceCoord2[fComponent]);
+      result[fsgrids::bgbfield::dBGBXVOLdy+1+2*fComponent] += dx[faceCoord2[fComponent]] * volumeAverage(bgFunction,accuracy,start,end);
+   }
+}
+
+/*! Cache key of the background field of a function on the local part of the fsgrid.
+ * \return Empty string if the field is not cached.
+ */
+static std::string getBackgroundFieldCacheKey(
+   const FieldFunction& bgFunction,
+   FsGrid< Real, fsgrids::bgbfield::N_BGB, FS_STENCIL_WIDTH> & BgBGrid
+) {
+   if (Parameters::bgFieldCachePath.size() == 0) return std::string();
+   const std::string functionKey = bgFunction.getCacheKey();
+   if (functionKey.size() == 0) return std::string();
+
    auto localSize = BgBGrid.getLocalSize();
+   std::array<double, 3> localStart = BgBGrid.getPhysicalCoords(0, 0, 0);
+   std::ostringstream key;
+   key << std::setprecision(17) << functionKey
+       << " size " << localSize[0] << " " << localSize[1] << " " << localSize[2]
+       << " start " << localStart[0] << " " << localStart[1] << " " << localStart[2]
+       << " dx " << BgBGrid.DX << " " << BgBGrid.DY << " " << BgBGrid.DZ;
+   return key.str();
+}
+
+static std::string getBackgroundFieldCacheFileName(const std::string& key) {
+   std::ostringstream fileName;
+   fileName << Parameters::bgFieldCachePath << "/bgfield_" << std::hex << std::hash<std::string>()(key) << ".bin";
+   return fileName.str();
+}
+
+/*! Reads the cached background field of the local part of the fsgrid.
+ * \param key Cache key, stored in the file and compared in full
+ * \param field Values of the cells, in the order of setBackgroundField
+ * \return If false, there was no valid cache file and field is unchanged
+ */
+static bool readBackgroundFieldCache(const std::string& key,std::vector<double>& field) {
+   std::ifstream file(getBackgroundFieldCacheFileName(key).c_str(), std::ios::binary);
+   if (!file) return false;
+   uint64_t keyLength, fieldSize;
+   file.read(reinterpret_cast<char*>(&keyLength), sizeof(keyLength));
+   if (!file || keyLength != key.size()) return false;
+   std::string fileKey(keyLength, ' ');
+   file.read(&(fileKey[0]), keyLength);
+   file.read(reinterpret_cast<char*>(&fieldSize), sizeof(fieldSize));
+   if (!file || fileKey != key || fieldSize != field.size()) return false;
+   std::vector<double> fileField(fieldSize);
+   file.read(reinterpret_cast<char*>(fileField.data()), fieldSize*sizeof(double));
+   if (!file) return false;
+   field.swap(fileField);
+   return true;
+}
+
+static bool writeBackgroundFieldCache(const std::string& key,const std::vector<double>& field) {
+   const std::string fileName = getBackgroundFieldCacheFileName(key);
+   // Written to a temporary file first so that an interrupted write never leaves a truncated cache
+   const std::string tmpFileName = fileName + ".tmp";
+   std::ofstream file(tmpFileName.c_str(), std::ios::binary | std::ios::trunc);
+   const uint64_t keyLength = key.size();
+   const uint64_t fieldSize = field.size();
+   file.write(reinterpret_cast<const char*>(&keyLength), sizeof(keyLength));
+   file.write(key.data(), keyLength);
+   file.write(reinterpret_cast<const char*>(&fieldSize), sizeof(fieldSize));
+   file.write(reinterpret_cast<const char*>(field.data()), fieldSize*sizeof(double));
+   file.close();
+   if (!file) return false;
+   return std::rename(tmpFileName.c_str(), fileName.c_str()) == 0;
+}
+
+//FieldFunction should be initialized
+void setBackgroundField(
+   FieldFunction& bgFunction,
+   FsGrid< Real, fsgrids::bgbfield::N_BGB, FS_STENCIL_WIDTH> & BgBGrid,
+   bool append) {
+   
+   /*if we do not add a new background to the existing one we first put everything to zero*/
+   if(append==false) {
+      setBackgroundFieldToZero(BgBGrid);
+   }
    
-   // Do not thread this blindly, the bgFunction.set* calls below are not thread-safe at the moment.
+   auto localSize = BgBGrid.getLocalSize();
+   const int nCells = localSize[0]*localSize[1]*localSize[2];
+   std::vector<double> field(nCells*fsgrids::bgbfield::N_BGB, 0.0);
+
+   const std::string cacheKey = getBackgroundFieldCacheKey(bgFunction, BgBGrid);
+   const bool cached = cacheKey.size() > 0 && readBackgroundFieldCache(cacheKey, field);
+
+   if (!cached) {
+      // Each thread integrates with its own copy of the function, the set* calls change its state.
+      // Functions that cannot be copied are integrated serially.
+      FieldFunction* testClone = bgFunction.clone();
+      const bool threaded = (testClone != NULL);
+      delete testClone;
+
+      const double dx[3] = {BgBGrid.DX, BgBGrid.DY, BgBGrid.DZ};
+      #pragma omp parallel if(threaded)
+      {
+         FieldFunction* threadFunction = threaded ? bgFunction.clone() : &bgFunction;
+         #pragma omp for collapse(3) schedule(dynamic)
+         for (int x = 0; x < localSize[0]; ++x) {
+            for (int y = 0; y < localSize[1]; ++y) {
+               for (int z = 0; z < localSize[2]; ++z) {
+                  std::array<double, 3> start3 = BgBGrid.getPhysicalCoords(x, y, z);
+                  const double start[3] = {start3[0], start3[1], start3[2]};
+                  const int cell = (x*localSize[1] + y)*localSize[2] + z;
+                  integrateBackgroundField(*threadFunction, start, dx, &(field[cell*fsgrids::bgbfield::N_BGB]));
+               }
+            }
+         }
+         if (threaded) delete threadFunction;
+      }
+
+      if (cacheKey.size() > 0 && writeBackgroundFieldCache(cacheKey, field) == false) {
+         logFile << "(BACKGROUNDFIELD) WARNING: could not write background field cache to " << Parameters::bgFieldCachePath << std::endl << writeVerbose;
+      }
+   }
+
+   #pragma omp parallel for collapse(3)
    for (int x = 0; x < localSize[0]; ++x) {
       for (int y = 0; y < localSize[1]; ++y) {
          for (int z = 0; z < localSize[2]; ++z) {
-            std::array<double, 3> start3 = BgBGrid.getPhysicalCoords(x, y, z);
-            start[0] = start3[0];
-            start[1] = start3[1];
-            start[2] = start3[2];
-            
-            dx[0] = BgBGrid.DX;
-            dx[1] = BgBGrid.DY;
-            dx[2] = BgBGrid.DZ;
-            
-            end[0]=start[0]+dx[0];
-            end[1]=start[1]+dx[1];
-            end[2]=start[2]+dx[2];
-            
-            //Face averages
-            for(uint fComponent=0; fComponent<3; fComponent++){
-               bgFunction.setDerivative(0);
-               bgFunction.setComponent((coordinate)fComponent);
-               BgBGrid.get(x,y,z)[fsgrids::bgbfield::BGBX+fComponent] += 
-                  surfaceAverage(bgFunction,
-                     (coordinate)fComponent,
-                                 accuracy,
-                                 start,
-                                 dx[faceCoord1[fComponent]],
-                                 dx[faceCoord2[fComponent]]
-                                );
-               
-               //Compute derivatives. Note that we scale by dx[] as the arrays are assumed to contain differences, not true derivatives!
-               bgFunction.setDerivative(1);
-               bgFunction.setDerivComponent((coordinate)faceCoord1[fComponent]);
-               BgBGrid.get(x,y,z)[fsgrids::bgbfield::dBGBxdy+2*fComponent] +=
-                  dx[faceCoord1[fComponent]] * 
-                  surfaceAverage(bgFunction, 
-                     (coordinate)fComponent,
-                                 accuracy,
-                                 start,
-                                 dx[faceCoord1[fComponent]],
-                                 dx[faceCoord2[fComponent]]
-                                );
-               bgFunction.setDerivComponent((coordinate)faceCoord2[fComponent]);
-               BgBGrid.get(x,y,z)[fsgrids::bgbfield::dBGBxdy+1+2*fComponent] +=
-                  dx[faceCoord2[fComponent]] *
-                  surfaceAverage(bgFunction,
-                     (coordinate)fComponent,
-                                 accuracy,
-                                 start,
-                                 dx[faceCoord1[fComponent]],
-                                 dx[faceCoord2[fComponent]]
-                                );
-            }
-            
-            //Volume averages
-            for(unsigned int fComponent=0;fComponent<3;fComponent++){
-               bgFunction.setDerivative(0);
-               bgFunction.setComponent((coordinate)fComponent);
-               BgBGrid.get(x,y,z)[fsgrids::bgbfield::BGBXVOL+fComponent] += volumeAverage(bgFunction,accuracy,start,end);
-               
-               //Compute derivatives. Note that we scale by dx[] as the arrays are assumed to contain differences, not true derivatives!      
-               bgFunction.setDerivative(1);
-               bgFunction.setDerivComponent((coordinate)faceCoord1[fComponent]);
-               BgBGrid.get(x,y,z)[fsgrids::bgbfield::dBGBXVOLdy+2*fComponent] += dx[faceCoord1[fComponent]] * volumeAverage(bgFunction,accuracy,start,end);
-               bgFunction.setDerivComponent((coordinate)faceCoord2[fComponent]);
-               BgBGrid.get(x,y,z)[fsgrids::bgbfield::dBGBXVOLdy+1+2*fComponent] += dx[faceCoord2[fComponent]] * volumeAverage(bgFunction,accuracy,start,end);
+            const int cell = (x*localSize[1] + y)*localSize[2] + z;
+            for (int i = 0; i < fsgrids::bgbfield::N_BGB; ++i) {
+               BgBGrid.get(x,y,z)[i] += field[cell*fsgrids::bgbfield::N_BGB + i];
             }
          }
       }
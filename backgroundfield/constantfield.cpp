@@ -25,6 +25,8 @@ Background magnetic field class of Vlasiator.
 
 #include <stdlib.h>
 #include <math.h>
+#include <iomanip>
+#include <sstream>
 #include "constantfield.hpp"
 #include "../common.h"
 
@@ -51,8 +53,9 @@ double ConstantField::call( double , double , double ) const
    return 0; // dummy, but prevents gcc from yelling
 }
 
-
-
-
-
-
+std::string ConstantField::getCacheKey() const {
+   std::ostringstream key;
+   key << std::setprecision(17) << "ConstantField";
+   for (int i=0; i<3; ++i) key << " " << _B[i];
+   return key.str();
+}
@@ -43,6 +43,8 @@ public:
    
    void initialize(const double Bx,const double By, const double Bz);
    virtual double call(double x, double y, double z) const;
+   virtual FieldFunction* clone() const { return new ConstantField(*this); }
+   virtual std::string getCacheKey() const;
 };
 
 #endif
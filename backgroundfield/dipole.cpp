@@ -25,6 +25,8 @@ Background magnetic field class of Vlasiator.
 
 #include <stdlib.h>
 #include <math.h>
+#include <iomanip>
+#include <sstream>
 #include "dipole.hpp"
 #include "../common.h"
 
@@ -83,8 +85,12 @@ double Dipole::call( double x, double y, double z) const
    return 0; // dummy, but prevents gcc from yelling
 }
 
-
-
-
-
-
+std::string Dipole::getCacheKey() const {
+   if(this->initialized==false)
+      return std::string();
+   std::ostringstream key;
+   key << std::setprecision(17) << "Dipole";
+   for (int i=0; i<3; ++i) key << " " << q[i];
+   for (int i=0; i<3; ++i) key << " " << center[i];
+   return key.str();
+}
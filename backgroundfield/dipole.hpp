@@ -41,6 +41,8 @@ public:
    }
    void initialize(const double moment,const double center_x, const double center_y, const double center_z, const double tilt_angle);
    virtual double call(double x, double y, double z) const;  
+   virtual FieldFunction* clone() const { return new Dipole(*this); }
+   virtual std::string getCacheKey() const;
    virtual ~Dipole() {}
 };
 
@@ -28,6 +28,7 @@ Background magnetic field class of Vlasiator.
 #include "functions.hpp"
 #include <iostream>
 #include <cstdlib>
+#include <string>
 
 class FieldFunction: public T3DFunction {
 private:
@@ -52,6 +53,12 @@ public:
          std::exit(1);
       } 
    }
+   /*! Copy of the function, used to evaluate it in several threads at once. If NULL,
+    * the function is evaluated serially.*/
+   virtual FieldFunction* clone() const { return NULL; }
+   /*! String uniquely identifying the field of the function, used as the key of the
+    * background field cache. If empty, the field is not cached.*/
+   virtual std::string getCacheKey() const { return std::string(); }
 };
 #endif
 
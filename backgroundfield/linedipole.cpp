@@ -25,6 +25,8 @@ Background magnetic field class of Vlasiator.
 
 #include <stdlib.h>
 #include <math.h>
+#include <iomanip>
+#include <sstream>
 #include "linedipole.hpp"
 #include "../common.h"
 
@@ -96,8 +98,12 @@ double LineDipole::call( double x, double y, double z) const
    return 0;   // dummy, but prevents gcc from yelling
 }
 
-
-
-
-
-
+std::string LineDipole::getCacheKey() const {
+   if(this->initialized==false)
+      return std::string();
+   std::ostringstream key;
+   key << std::setprecision(17) << "LineDipole";
+   for (int i=0; i<3; ++i) key << " " << q[i];
+   for (int i=0; i<3; ++i) key << " " << center[i];
+   return key.str();
+}
@@ -43,6 +43,8 @@ public:
    void initialize(const double moment, const double center_x, const double center_y, const double center_z);
   
    virtual double call(double x, double y, double z) const;
+   virtual FieldFunction* clone() const { return new LineDipole(*this); }
+   virtual std::string getCacheKey() const;
   
    virtual ~LineDipole() {}
 };
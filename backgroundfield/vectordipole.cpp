@@ -26,6 +26,8 @@ Background magnetic field class of Vlasiator.
 
 #include <stdlib.h>
 #include <math.h>
+#include <iomanip>
+#include <sstream>
 #include "vectordipole.hpp"
 #include "../common.h"
 
@@ -350,8 +352,14 @@ double VectorDipole::call( double x, double y, double z) const
    return 0; // dummy, but prevents gcc from yelling
 }
 
-
-
-
-
-
+std::string VectorDipole::getCacheKey() const {
+   if(this->initialized==false)
+      return std::string();
+   std::ostringstream key;
+   key << std::setprecision(17) << "VectorDipole";
+   for (int i=0; i<3; ++i) key << " " << q[i];
+   for (int i=0; i<3; ++i) key << " " << center[i];
+   for (int i=0; i<2; ++i) key << " " << xlimit[i];
+   for (int i=0; i<3; ++i) key << " " << IMF[i];
+   return key.str();
+}
@@ -44,6 +44,8 @@ public:
    }
    void initialize(const double moment,const double center_x, const double center_y, const double center_z, const double tilt_angle_phi, const double tilt_angle_theta, const double xlimit_f, const double xlimit_z, const double IMF_Bx, const double IMF_By, const double IMF_Bz);
    virtual double call(double x, double y, double z) const;  
+   virtual FieldFunction* clone() const { return new VectorDipole(*this); }
+   virtual std::string getCacheKey() const;
    virtual ~VectorDipole() {}
 };
 
@@ -0,0 +1,72 @@
+/*
+ * This file is part of Vlasiator.
+ * Copyright 2010-2016 Finnish Meteorological Institute
+ *
+ * For details of usage, see the COPYING file and read the "Rules of the Road"
+ * at http://www.physics.helsinki.fi/vlasiator/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef BFLOAT16_H
+#define BFLOAT16_H
+
+#include <stdint.h>
+#include <cstring>
+
+/*!
+ 16-bit brain floating point number, used as the storage type of the
+ distribution function when compiled with -DHPF.
+
+ The value is the upper half of an IEEE single precision float, so it has
+ the same exponent range as float (the distribution function spans many
+ orders of magnitude, so no scaling is needed) but only 8 bits of mantissa,
+ i.e. a relative precision of about 0.4 %. All arithmetic is done in float:
+ values are converted when read and rounded to nearest even when written.
+*/
+class BFloat16 {
+ public:
+   BFloat16() = default;
+   BFloat16(const float value): bits(fromFloat(value)) { }
+
+   operator float() const {
+      const uint32_t u = static_cast<uint32_t>(bits) << 16;
+      float value;
+      std::memcpy(&value,&u,sizeof(float));
+      return value;
+   }
+
+   BFloat16& operator=(const float value) {bits = fromFloat(value); return *this;}
+   BFloat16& operator+=(const float value) {return *this = static_cast<float>(*this) + value;}
+   BFloat16& operator-=(const float value) {return *this = static_cast<float>(*this) - value;}
+   BFloat16& operator*=(const float value) {return *this = static_cast<float>(*this) * value;}
+   BFloat16& operator/=(const float value) {return *this = static_cast<float>(*this) / value;}
+
+ private:
+   uint16_t bits;
+
+   static uint16_t fromFloat(const float value) {
+      uint32_t u;
+      std::memcpy(&u,&value,sizeof(float));
+      if ((u & 0x7fffffff) > 0x7f800000) {
+         // NaN, keep it a (quiet) NaN after truncation
+         return static_cast<uint16_t>((u >> 16) | 0x0040);
+      }
+      // round to nearest, ties to even
+      u += 0x7fff + ((u >> 16) & 1);
+      return static_cast<uint16_t>(u >> 16);
+   }
+};
+
+#endif
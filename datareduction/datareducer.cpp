@@ -1171,6 +1171,83 @@ bool DataReducer::reduceData(const SpatialCell* cell,const unsigned int& operato
    return true;
 }
 
+/** Request several DataReductionOperators to calculate their output data for a list of cells.
+ * The cells are divided between threads, and each thread applies all the operators to a cell
+ * before moving on to the next one, so the data of a cell is brought to cache only once. Each
+ * thread uses its own copies of the operators. Operators that cannot be copied (see
+ * DRO::DataReductionOperator::clone) are applied to all cells afterwards by one thread.
+ * @param mpiGrid Parallel grid.
+ * @param cells Cells whose data is reduced.
+ * @param operatorIDs ID numbers of the applied DataReductionOperators.
+ * @param buffers Output buffer of each operator, with room for the data vectors of all cells.
+ * @param success Set for each operator to true if it reduced the data of all cells successfully.
+ */
+void DataReducer::reduceData(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                             const std::vector<CellID>& cells,
+                             const std::vector<unsigned int>& operatorIDs,
+                             const std::vector<char*>& buffers,
+                             std::vector<bool>& success) {
+   const size_t nOperators = operatorIDs.size();
+   std::vector<uint64_t> cellStride(nOperators, 0);
+   std::vector<bool> threaded(nOperators, false);
+   std::vector<unsigned char> operatorSuccess(nOperators, true);
+   for (size_t op=0; op<nOperators; ++op) {
+      std::string dataType;
+      unsigned int dataSize, vectorSize;
+      if (getDataVectorInfo(operatorIDs[op], dataType, dataSize, vectorSize) == false) {
+         operatorSuccess[op] = false;
+         continue;
+      }
+      cellStride[op] = dataSize * vectorSize;
+      DRO::DataReductionOperator* copy = operators[operatorIDs[op]]->clone();
+      threaded[op] = (copy != NULL);
+      delete copy;
+   }
+
+   #pragma omp parallel
+   {
+      std::vector<DRO::DataReductionOperator*> threadOperators(nOperators, NULL);
+      std::vector<unsigned char> threadSuccess(nOperators, true);
+      for (size_t op=0; op<nOperators; ++op) {
+         if (threaded[op] && operatorSuccess[op]) threadOperators[op] = operators[operatorIDs[op]]->clone();
+      }
+
+      #pragma omp for schedule(guided)
+      for (size_t c=0; c<cells.size(); ++c) {
+         const SpatialCell* cell = mpiGrid[cells[c]];
+         for (size_t op=0; op<nOperators; ++op) {
+            if (threadOperators[op] == NULL) continue;
+            if (threadOperators[op]->setSpatialCell(cell) == false
+                || threadOperators[op]->reduceData(cell, buffers[op] + c*cellStride[op]) == false) {
+               threadSuccess[op] = false;
+            }
+         }
+      }
+
+      for (size_t op=0; op<nOperators; ++op) {
+         delete threadOperators[op];
+      }
+      #pragma omp critical
+      {
+         for (size_t op=0; op<nOperators; ++op) {
+            operatorSuccess[op] = operatorSuccess[op] && threadSuccess[op];
+         }
+      }
+   }
+
+   for (size_t op=0; op<nOperators; ++op) {
+      if (threaded[op] || operatorSuccess[op] == false) continue;
+      for (size_t c=0; c<cells.size(); ++c) {
+         if (reduceData(mpiGrid[cells[c]], operatorIDs[op], buffers[op] + c*cellStride[op]) == false) {
+            operatorSuccess[op] = false;
+            break;
+         }
+      }
+   }
+
+   success.assign(operatorSuccess.begin(), operatorSuccess.end());
+}
+
 /** Request a DataReductionOperator to calculate its output data and to write it to the given variable.
  * @param cell Pointer to spatial cell whose data is to be reduced.
  * @param operatorID ID number of the applied DataReductionOperator.
@@ -1186,6 +1263,91 @@ bool DataReducer::reduceDiagnostic(const SpatialCell* cell,const unsigned int& o
    return true;
 }
 
+/** Calculate the diagnostic values of all DataReductionOperators over the given cells in one
+ * threaded sweep. Operators that implement clone() are evaluated by all threads, each using
+ * its own copy, the rest serially after the sweep.
+ * @param mpiGrid Parallel grid.
+ * @param cells Cells whose data is reduced.
+ * @param minValues Minimum diagnostic value of each operator over the cells.
+ * @param maxValues Maximum diagnostic value of each operator over the cells.
+ * @param sums Sum of the diagnostic values of each operator over the cells.
+ * @param success If false, the operator returned false for some cell.
+ */
+void DataReducer::reduceDiagnostic(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                                   const std::vector<CellID>& cells,
+                                   std::vector<Real>& minValues,
+                                   std::vector<Real>& maxValues,
+                                   std::vector<Real>& sums,
+                                   std::vector<bool>& success) {
+   const size_t nOperators = operators.size();
+   std::vector<bool> threaded(nOperators, false);
+   std::vector<unsigned char> operatorSuccess(nOperators, true);
+   minValues.assign(nOperators, std::numeric_limits<Real>::max());
+   maxValues.assign(nOperators, std::numeric_limits<Real>::min());
+   sums.assign(nOperators, 0.0);
+   for (size_t op=0; op<nOperators; ++op) {
+      DRO::DataReductionOperator* copy = operators[op]->clone();
+      threaded[op] = (copy != NULL);
+      delete copy;
+   }
+
+   #pragma omp parallel
+   {
+      std::vector<DRO::DataReductionOperator*> threadOperators(nOperators, NULL);
+      std::vector<unsigned char> threadSuccess(nOperators, true);
+      std::vector<Real> threadMin(nOperators, std::numeric_limits<Real>::max());
+      std::vector<Real> threadMax(nOperators, std::numeric_limits<Real>::min());
+      std::vector<Real> threadSum(nOperators, 0.0);
+      // As in the serial loop, a failing cell leaves the previous value of the operator in place
+      std::vector<Real> buffer(nOperators, 0.0);
+      for (size_t op=0; op<nOperators; ++op) {
+         if (threaded[op]) threadOperators[op] = operators[op]->clone();
+      }
+
+      #pragma omp for schedule(guided)
+      for (size_t c=0; c<cells.size(); ++c) {
+         const SpatialCell* cell = mpiGrid[cells[c]];
+         for (size_t op=0; op<nOperators; ++op) {
+            if (threadOperators[op] == NULL) continue;
+            if (threadOperators[op]->setSpatialCell(cell) == false
+                || threadOperators[op]->reduceDiagnostic(cell, &(buffer[op])) == false) {
+               threadSuccess[op] = false;
+            }
+            threadMin[op] = std::min(buffer[op], threadMin[op]);
+            threadMax[op] = std::max(buffer[op], threadMax[op]);
+            threadSum[op] += buffer[op];
+         }
+      }
+
+      for (size_t op=0; op<nOperators; ++op) {
+         delete threadOperators[op];
+      }
+      #pragma omp critical
+      {
+         for (size_t op=0; op<nOperators; ++op) {
+            if (threaded[op] == false) continue;
+            operatorSuccess[op] = operatorSuccess[op] && threadSuccess[op];
+            minValues[op] = std::min(threadMin[op], minValues[op]);
+            maxValues[op] = std::max(threadMax[op], maxValues[op]);
+            sums[op] += threadSum[op];
+         }
+      }
+   }
+
+   for (size_t op=0; op<nOperators; ++op) {
+      if (threaded[op]) continue;
+      Real buffer = 0.0;
+      for (size_t c=0; c<cells.size(); ++c) {
+         if (reduceDiagnostic(mpiGrid[cells[c]], op, &buffer) == false) operatorSuccess[op] = false;
+         minValues[op] = std::min(buffer, minValues[op]);
+         maxValues[op] = std::max(buffer, maxValues[op]);
+         sums[op] += buffer;
+      }
+   }
+
+   success.assign(operatorSuccess.begin(), operatorSuccess.end());
+}
+
 /** Get the number of DataReductionOperators stored in DataReducer.
  * @return Number of DataReductionOperators stored in DataReducer.
  */
@@ -54,7 +54,18 @@ class DataReducer {
    bool handlesWriting(const unsigned int& operatorID) const;
    bool hasParameters(const unsigned int& operatorID) const;
    bool reduceData(const SpatialCell* cell,const unsigned int& operatorID,char* buffer);
+   void reduceData(const dccrg::Dccrg<spatial_cell::SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                   const std::vector<CellID>& cells,
+                   const std::vector<unsigned int>& operatorIDs,
+                   const std::vector<char*>& buffers,
+                   std::vector<bool>& success);
    bool reduceDiagnostic(const SpatialCell* cell,const unsigned int& operatorID,Real * result);
+   void reduceDiagnostic(const dccrg::Dccrg<spatial_cell::SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                         const std::vector<CellID>& cells,
+                         std::vector<Real>& minValues,
+                         std::vector<Real>& maxValues,
+                         std::vector<Real>& sums,
+                         std::vector<bool>& success);
    unsigned int size() const;
    bool writeData(const unsigned int& operatorID,
                   const dccrg::Dccrg<spatial_cell::SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
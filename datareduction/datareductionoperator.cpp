@@ -46,6 +46,14 @@ namespace DRO {
    /** DataReductionOperator base class virtual destructor. The destructor is empty.*/
    DataReductionOperator::~DataReductionOperator() { }
 
+   /** Create a copy of this operator for reducing data in another thread.
+    * @return The copy, or NULL if the operator can only be used by one thread at a time.
+    * The caller deletes the copy.
+    */
+   DataReductionOperator* DataReductionOperator::clone() const {
+      return NULL;
+   }
+
    /** Reduce the data and write the data vector to the given vlsv output buffer.
     * @param cell the SpatialCell to reduce data out of
     * @param buffer Buffer in which the reduced data is written.
@@ -49,6 +49,8 @@ namespace DRO {
     * are loaded when the simulation initializes.
     *
     * Datareduction oeprators are not thread-safe, some of the more intensive ones are threaded within. 
+    * Operators that implement clone() are evaluated by several threads, each using its own copy.
+    * Operators that open their own OpenMP parallel region in reduceData must not implement clone().
     */
 
    class DataReductionOperator {
@@ -76,6 +78,7 @@ namespace DRO {
       virtual bool reduceData(const SpatialCell* cell,char* buffer);
       virtual bool reduceDiagnostic(const SpatialCell* cell,Real * result);
       virtual bool setSpatialCell(const SpatialCell* cell) = 0;
+      virtual DataReductionOperator* clone() const;
       
    protected:
       std::string unit;
@@ -149,6 +152,7 @@ namespace DRO {
       virtual bool reduceData(const SpatialCell* cell,char* buffer);
       virtual bool reduceDiagnostic(const SpatialCell* cell,Real * result);
       virtual bool setSpatialCell(const SpatialCell* cell);
+      virtual DataReductionOperator* clone() const {return new DataReductionOperatorCellParams(*this);}
       
    protected:
       uint _parameterIndex;
@@ -161,12 +165,14 @@ namespace DRO {
    public:
       DataReductionOperatorDerivatives(const std::string& name,const unsigned int parameterIndex,const unsigned int vectorSize);
       virtual bool setSpatialCell(const SpatialCell* cell);
+      virtual DataReductionOperator* clone() const {return new DataReductionOperatorDerivatives(*this);}
    };
    
    class DataReductionOperatorBVOLDerivatives: public DataReductionOperatorCellParams {
    public:
       DataReductionOperatorBVOLDerivatives(const std::string& name,const unsigned int parameterIndex,const unsigned int vectorSize);
       virtual bool setSpatialCell(const SpatialCell* cell);
+      virtual DataReductionOperator* clone() const {return new DataReductionOperatorBVOLDerivatives(*this);}
    };
    
    class MPIrank: public DataReductionOperator {
@@ -193,6 +199,7 @@ namespace DRO {
       virtual std::string getName() const;
       virtual bool reduceData(const SpatialCell* cell,char* buffer);
       virtual bool setSpatialCell(const SpatialCell* cell);
+      virtual DataReductionOperator* clone() const {return new BoundaryType(*this);}
       
    protected:
       int boundaryType;
@@ -207,6 +214,7 @@ namespace DRO {
       virtual std::string getName() const;
       virtual bool reduceData(const SpatialCell* cell,char* buffer);
       virtual bool setSpatialCell(const SpatialCell* cell);
+      virtual DataReductionOperator* clone() const {return new BoundaryLayer(*this);}
       
    protected:
       int boundaryLayer;
@@ -222,6 +230,7 @@ namespace DRO {
       virtual bool reduceData(const SpatialCell* cell,char* buffer);
       virtual bool reduceDiagnostic(const SpatialCell* cell,Real* buffer);
       virtual bool setSpatialCell(const SpatialCell* cell);
+      virtual DataReductionOperator* clone() const {return new Blocks(*this);}
       
    protected:
       uint nBlocks;
@@ -238,6 +247,7 @@ namespace DRO {
       virtual std::string getName() const;
       virtual bool reduceData(const SpatialCell* cell,char* buffer);
       virtual bool setSpatialCell(const SpatialCell* cell);
+      virtual DataReductionOperator* clone() const {return new VariableBVol(*this);}
       
    protected:
       Real B[3];
@@ -253,6 +263,7 @@ namespace DRO {
       virtual std::string getName() const;
       virtual bool reduceData(const SpatialCell* cell,char* buffer);
       virtual bool setSpatialCell(const SpatialCell* cell);
+      virtual DataReductionOperator* clone() const {return new VariablePressureSolver(*this);}
       
    protected:
       Real Pressure;
@@ -522,6 +533,7 @@ namespace DRO {
       virtual bool reduceData(const SpatialCell* cell,char* buffer);
       virtual bool reduceDiagnostic(const spatial_cell::SpatialCell* cell,Real* result);
       virtual bool setSpatialCell(const SpatialCell* cell);
+      virtual DataReductionOperator* clone() const {return new VariableEffectiveSparsityThreshold(*this);}
       
    protected:
       uint popID;
@@ -94,6 +94,8 @@ namespace DRO {
 
          return true;
       }
+
+      virtual DataReductionOperator* clone() const {return new DataReductionOperatorPopulations<T>(*this);}
       
    protected:
       uint _byteOffset;
@@ -27,8 +27,15 @@
 #include <limits>
 
 //set floating point precision for storing the distribution function here. Default is single precision, use -DDPF to set double precision
+//or -DHPF to store it in 16-bit bfloat16 (computations are still done in single precision)
 #ifdef DPF
 typedef double Realf;
+#elif defined(HPF)
+#ifdef USE_CUDA
+#error "16-bit distribution function storage (HPF) is not supported by the CUDA solvers"
+#endif
+#include "bfloat16.h"
+typedef BFloat16 Realf;
 #else
 typedef float Realf;
 #endif
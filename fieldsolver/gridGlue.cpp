@@ -72,7 +72,6 @@ template <typename T, int TDim, int stencil> void computeCoupling(dccrg::Dccrg<S
         
         int process = mpiGrid.get_process(dccrgCell);
         int64_t  fsgridLid = momentsGrid.LocalIDForCoords(i,j,k);
-        int64_t  fsgridGid = momentsGrid.GlobalIDForCoords(i,j,k);
         onFsgridMapRemoteProcess[process].insert(dccrgCell); //cells are ordered (sorted) in set
         onFsgridMapCells[dccrgCell].push_back(fsgridLid);
       }
@@ -92,105 +91,195 @@ template <typename T, int TDim, int stencil> void computeCoupling(dccrg::Dccrg<S
   }
 }
 
-void feedMomentsIntoFsGrid(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
-                           const std::vector<CellID>& cells,
-                           FsGrid<Real, fsgrids::moments::N_MOMENTS, FS_STENCIL_WIDTH> & momentsGrid,
-                           FsGrid< fsgrids::technical, 1, FS_STENCIL_WIDTH> & technicalGrid,
+/*! Buffers and persistent MPI requests of one coupling exchange.
+ *
+ * An exchange is one direction of the coupling (dccrg => fsgrid or fsgrid => dccrg) with a fixed
+ * number of Reals per dccrg cell. Buffers are flat, one contiguous slab per remote rank in the
+ * rank order of the coupling plan, so the persistent requests can be created once and restarted
+ * with MPI_Startall on every transfer.
+ */
+struct CouplingExchange {
+   int stride;                               /*!< Number of Reals transferred per dccrg cell.*/
+   std::vector<Real> sendBuffer;
+   std::vector<Real> receiveBuffer;
+   std::vector<MPI_Request> sendRequests;
+   std::vector<MPI_Request> receiveRequests;
+};
+
+/*! Cached DCCRG <=> FSGRID coupling plan.
+ *
+ * The fsgrid decomposition never changes, so the coupling only depends on the dccrg partitioning.
+ * The plan is computed once after a load balance (flattened from computeCoupling) and reused
+ * by all coupling transfers until invalidateFsGridCoupling() is called.
+ *
+ * Cell lists are stored per remote rank in ascending CellID order, which is the order both the
+ * sending and the receiving side agree on.
+ */
+struct CouplingPlan {
+   bool valid {false};
+
+   std::vector<CellID> localCells;           /*!< Sorted local dccrg cells the plan was built for.*/
+
+   // dccrg side: fsgrid ranks owning fsgrid cells covered by local dccrg cells
+   std::vector<int> dccrgSideRanks;
+   std::vector<size_t> dccrgSideOffsets;     /*!< Offsets into dccrgSideCells, size dccrgSideRanks.size()+1.*/
+   std::vector<CellID> dccrgSideCells;
+   std::vector<uint> dccrgSideCellIndex;     /*!< Index of each dccrgSideCells entry in localCells.*/
+
+   // fsgrid side: dccrg ranks owning dccrg cells covering local fsgrid cells
+   std::vector<int> fsgridSideRanks;
+   std::vector<size_t> fsgridSideOffsets;    /*!< Offsets into fsgridSideCells, size fsgridSideRanks.size()+1.*/
+   std::vector<CellID> fsgridSideCells;
+   std::vector<size_t> fsgridSideLidOffsets; /*!< Offsets into fsgridSideLids, size fsgridSideCells.size()+1.*/
+   std::vector<int64_t> fsgridSideLids;      /*!< Local fsgrid ids covered by each fsgridSideCells entry.*/
+
+   std::map<int, CouplingExchange> exchanges; /*!< Exchanges created so far, keyed by their MPI tag.*/
+};
+
+static CouplingPlan couplingPlan;
+
+// MPI tags of the coupling exchanges
+static const int COUPLING_TAG_MOMENTS = 1;
+static const int COUPLING_TAG_FIELDS = 2;
+static const int COUPLING_TAG_MOMENTS_FUSED = 3;
+
+void invalidateFsGridCoupling() {
+   for (auto& tagExchange : couplingPlan.exchanges) {
+      for (auto& request : tagExchange.second.sendRequests) {
+         MPI_Request_free(&request);
+      }
+      for (auto& request : tagExchange.second.receiveRequests) {
+         MPI_Request_free(&request);
+      }
+   }
+   couplingPlan = CouplingPlan();
+}
 
-                           bool dt2 /*=false*/) {
+/*! Make sure the coupling plan is valid for the given cells, rebuilding it if needed.
+ * The fsgrid is only used for its decomposition, which is shared by all fsgrids.
+ */
+template <typename T, int TDim, int stencil> static CouplingPlan& getCouplingPlan(
+   dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+   const std::vector<CellID>& cells,
+   FsGrid< T, TDim, stencil>& fsgrid
+) {
+   // The plan is only rebuilt after an explicit invalidateFsGridCoupling(), which every change
+   // of the dccrg partitioning or refinement has to call
+   if (couplingPlan.valid) {
+      return couplingPlan;
+   }
 
-  int ii;
-  //sorted list of dccrg cells. cells is typicall already sorted, but just to make sure....
-  std::vector<CellID> dccrgCells = cells;
-  std::sort(dccrgCells.begin(), dccrgCells.end());
+   phiprof::start("compute-fsgrid-coupling");
+   invalidateFsGridCoupling();
+
+   std::map<int, std::set<CellID> > onDccrgMapRemoteProcess;
+   std::map<int, std::set<CellID> > onFsgridMapRemoteProcess;
+   std::map<CellID, std::vector<int64_t> > onFsgridMapCells;
+   computeCoupling(mpiGrid, cells, fsgrid, onDccrgMapRemoteProcess, onFsgridMapRemoteProcess, onFsgridMapCells);
+
+   CouplingPlan& plan = couplingPlan;
+   plan.localCells = cells;
+   std::sort(plan.localCells.begin(), plan.localCells.end());
+
+   plan.dccrgSideOffsets.push_back(0);
+   for (auto const &snd : onDccrgMapRemoteProcess) {
+      plan.dccrgSideRanks.push_back(snd.first);
+      for (CellID cell : snd.second) {
+         plan.dccrgSideCells.push_back(cell);
+         plan.dccrgSideCellIndex.push_back(
+            std::lower_bound(plan.localCells.begin(), plan.localCells.end(), cell) - plan.localCells.begin());
+      }
+      plan.dccrgSideOffsets.push_back(plan.dccrgSideCells.size());
+   }
 
-  //Datastructure for coupling
-  std::map<int, std::set<CellID> > onDccrgMapRemoteProcess; 
-  std::map<int, std::set<CellID> > onFsgridMapRemoteProcess; 
-  std::map<CellID, std::vector<int64_t> >  onFsgridMapCells;
-    
-  // map receive process => receive buffers 
-  std::map<int, std::vector<Real> > receivedData; 
+   plan.fsgridSideOffsets.push_back(0);
+   plan.fsgridSideLidOffsets.push_back(0);
+   for (auto const &rcv : onFsgridMapRemoteProcess) {
+      plan.fsgridSideRanks.push_back(rcv.first);
+      for (CellID cell : rcv.second) {
+         plan.fsgridSideCells.push_back(cell);
+         const std::vector<int64_t>& lids = onFsgridMapCells[cell];
+         plan.fsgridSideLids.insert(plan.fsgridSideLids.end(), lids.begin(), lids.end());
+         plan.fsgridSideLidOffsets.push_back(plan.fsgridSideLids.size());
+      }
+      plan.fsgridSideOffsets.push_back(plan.fsgridSideCells.size());
+   }
 
-  // send buffers  to each process
-  std::map<int, std::vector<Real> > sendData;
+   plan.valid = true;
+   phiprof::stop("compute-fsgrid-coupling");
+   return plan;
+}
 
-  //list of requests
-  std::vector<MPI_Request> sendRequests;
-  std::vector<MPI_Request> receiveRequests;
- 
-  //computeCoupling
-  computeCoupling(mpiGrid, cells, momentsGrid, onDccrgMapRemoteProcess, onFsgridMapRemoteProcess, onFsgridMapCells);
- 
-  // Post receives
-  receiveRequests.resize(onFsgridMapRemoteProcess.size());  
-  ii=0;
-  for(auto const &receives: onFsgridMapRemoteProcess){
-    int process = receives.first;
-    int count = receives.second.size();
-    receivedData[process].resize(count * fsgrids::moments::N_MOMENTS);
-    MPI_Irecv(receivedData[process].data(), count * fsgrids::moments::N_MOMENTS * sizeof(Real),
-	      MPI_BYTE, process, 1, MPI_COMM_WORLD,&(receiveRequests[ii++]));
-  }
-  
-  // Launch sends
-  ii=0;
-  sendRequests.resize(onDccrgMapRemoteProcess.size());
-  for (auto const &snd : onDccrgMapRemoteProcess){
-    int targetProc = snd.first; 
-    auto& sendBuffer=sendData[targetProc];
-    for(CellID sendCell: snd.second){
-      //Collect data to send for this dccrg cell
-      auto cellParams = mpiGrid[sendCell]->get_cell_parameters();
-      if(!dt2) {
-        sendBuffer.push_back(cellParams[CellParams::RHOM]);
-	sendBuffer.push_back(cellParams[CellParams::RHOQ]);
-	sendBuffer.push_back(cellParams[CellParams::VX]);
-	sendBuffer.push_back(cellParams[CellParams::VY]);
-        sendBuffer.push_back(cellParams[CellParams::VZ]);
-	sendBuffer.push_back(cellParams[CellParams::P_11]);
-	sendBuffer.push_back(cellParams[CellParams::P_22]);
-        sendBuffer.push_back(cellParams[CellParams::P_33]);
-      } else {
-        sendBuffer.push_back(cellParams[CellParams::RHOM_DT2]);
-	sendBuffer.push_back(cellParams[CellParams::RHOQ_DT2]);
-	sendBuffer.push_back(cellParams[CellParams::VX_DT2]);
-	sendBuffer.push_back(cellParams[CellParams::VY_DT2]);
-        sendBuffer.push_back(cellParams[CellParams::VZ_DT2]);
-	sendBuffer.push_back(cellParams[CellParams::P_11_DT2]);
-	sendBuffer.push_back(cellParams[CellParams::P_22_DT2]);
-        sendBuffer.push_back(cellParams[CellParams::P_33_DT2]);
-      }
-    }
-    int count = sendBuffer.size(); //note, compared to receive this includes all elements to be sent
-    MPI_Isend(sendBuffer.data(), sendBuffer.size() * sizeof(Real),
-	      MPI_BYTE, targetProc, 1, MPI_COMM_WORLD,&(sendRequests[ii]));
-    ii++;
-  }
+/*! Get (creating on first use) the exchange with the given tag from the plan.
+ * \param tag MPI tag, identifies the exchange
+ * \param stride Number of Reals per dccrg cell
+ * \param toFsgrid If true data flows from the dccrg side to the fsgrid side, otherwise the other way around
+ */
+static CouplingExchange& getCouplingExchange(CouplingPlan& plan, int tag, int stride, bool toFsgrid) {
+   auto it = plan.exchanges.find(tag);
+   if (it != plan.exchanges.end()) {
+      return it->second;
+   }
 
-  
-  MPI_Waitall(receiveRequests.size(), receiveRequests.data(), MPI_STATUSES_IGNORE);
-
-  for(auto const &receives: onFsgridMapRemoteProcess){
-    int process = receives.first; //data received from this process
-    Real* receiveBuffer = receivedData[process].data(); // data received from process
-    for(auto const &cell: receives.second){ //loop over cellids (dccrg) for receive
-      // this part heavily relies on both sender and receiver having cellids sorted!
-      for(auto lid: onFsgridMapCells[cell]){
-	auto fsgridData = momentsGrid.get(lid);
-	for(int l = 0; l < fsgrids::moments::N_MOMENTS; l++)   {
-	  fsgridData[l] = receiveBuffer[l];
-	}
-      }
-      
-      receiveBuffer+=fsgrids::moments::N_MOMENTS;
-    }
-  }
+   CouplingExchange& exchange = plan.exchanges[tag];
+   exchange.stride = stride;
 
-  MPI_Waitall(sendRequests.size(), sendRequests.data(), MPI_STATUSES_IGNORE);
+   const std::vector<int>& sendRanks = toFsgrid ? plan.dccrgSideRanks : plan.fsgridSideRanks;
+   const std::vector<size_t>& sendOffsets = toFsgrid ? plan.dccrgSideOffsets : plan.fsgridSideOffsets;
+   const std::vector<int>& receiveRanks = toFsgrid ? plan.fsgridSideRanks : plan.dccrgSideRanks;
+   const std::vector<size_t>& receiveOffsets = toFsgrid ? plan.fsgridSideOffsets : plan.dccrgSideOffsets;
 
+   exchange.sendBuffer.resize(sendOffsets.back() * stride);
+   exchange.receiveBuffer.resize(receiveOffsets.back() * stride);
 
+   exchange.receiveRequests.resize(receiveRanks.size());
+   for (uint i = 0; i < receiveRanks.size(); i++) {
+      const size_t count = (receiveOffsets[i+1] - receiveOffsets[i]) * stride;
+      MPI_Recv_init(exchange.receiveBuffer.data() + receiveOffsets[i] * stride, count * sizeof(Real),
+                    MPI_BYTE, receiveRanks[i], tag, MPI_COMM_WORLD, &(exchange.receiveRequests[i]));
+   }
+   exchange.sendRequests.resize(sendRanks.size());
+   for (uint i = 0; i < sendRanks.size(); i++) {
+      const size_t count = (sendOffsets[i+1] - sendOffsets[i]) * stride;
+      MPI_Send_init(exchange.sendBuffer.data() + sendOffsets[i] * stride, count * sizeof(Real),
+                    MPI_BYTE, sendRanks[i], tag, MPI_COMM_WORLD, &(exchange.sendRequests[i]));
+   }
+   return exchange;
+}
 
+/*! Copy the moments of one dccrg cell into a transfer buffer, in fsgrids::moments order.
+ * \param cellParams Cell parameters of the dccrg cell
+ * \param buffer Buffer with room for fsgrids::moments::N_MOMENTS values
+ * \param dt2 Whether to copy base moments, or _DT2 moments
+ */
+static inline void packMoments(const Real* cellParams, Real* buffer, bool dt2) {
+  if(!dt2) {
+    buffer[fsgrids::moments::RHOM] = cellParams[CellParams::RHOM];
+    buffer[fsgrids::moments::RHOQ] = cellParams[CellParams::RHOQ];
+    buffer[fsgrids::moments::VX]   = cellParams[CellParams::VX];
+    buffer[fsgrids::moments::VY]   = cellParams[CellParams::VY];
+    buffer[fsgrids::moments::VZ]   = cellParams[CellParams::VZ];
+    buffer[fsgrids::moments::P_11] = cellParams[CellParams::P_11];
+    buffer[fsgrids::moments::P_22] = cellParams[CellParams::P_22];
+    buffer[fsgrids::moments::P_33] = cellParams[CellParams::P_33];
+  } else {
+    buffer[fsgrids::moments::RHOM] = cellParams[CellParams::RHOM_DT2];
+    buffer[fsgrids::moments::RHOQ] = cellParams[CellParams::RHOQ_DT2];
+    buffer[fsgrids::moments::VX]   = cellParams[CellParams::VX_DT2];
+    buffer[fsgrids::moments::VY]   = cellParams[CellParams::VY_DT2];
+    buffer[fsgrids::moments::VZ]   = cellParams[CellParams::VZ_DT2];
+    buffer[fsgrids::moments::P_11] = cellParams[CellParams::P_11_DT2];
+    buffer[fsgrids::moments::P_22] = cellParams[CellParams::P_22_DT2];
+    buffer[fsgrids::moments::P_33] = cellParams[CellParams::P_33_DT2];
+  }
+}
+
+/*! Smooth the moments on refined grids with a boxcar filter. The number of passes is set per
+ * refinement level with AMR.filterpasses. Does nothing if there is no spatial refinement.
+ */
+static void filterMoments(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                          FsGrid<Real, fsgrids::moments::N_MOMENTS, FS_STENCIL_WIDTH> & momentsGrid,
+                          FsGrid< fsgrids::technical, 1, FS_STENCIL_WIDTH> & technicalGrid) {
   if (P::amrMaxSpatialRefLevel>0) {
 
     /*----------------------Filtering------------------------*/
@@ -301,6 +390,94 @@ void feedMomentsIntoFsGrid(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
   }   
 }
 
+void feedMomentsIntoFsGrid(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                           const std::vector<CellID>& cells,
+                           FsGrid<Real, fsgrids::moments::N_MOMENTS, FS_STENCIL_WIDTH> & momentsGrid,
+                           FsGrid< fsgrids::technical, 1, FS_STENCIL_WIDTH> & technicalGrid,
+
+                           bool dt2 /*=false*/) {
+
+  CouplingPlan& plan = getCouplingPlan(mpiGrid, cells, momentsGrid);
+  CouplingExchange& exchange = getCouplingExchange(plan, COUPLING_TAG_MOMENTS, fsgrids::moments::N_MOMENTS, true);
+
+  // Post receives
+  MPI_Startall(exchange.receiveRequests.size(), exchange.receiveRequests.data());
+
+  // Pack and launch sends. Cells are in the same (sorted) order as on the receiving side.
+  #pragma omp parallel for
+  for (size_t c = 0; c < plan.dccrgSideCells.size(); c++) {
+    const Real* cellParams = mpiGrid[plan.dccrgSideCells[c]]->get_cell_parameters();
+    packMoments(cellParams, exchange.sendBuffer.data() + c * fsgrids::moments::N_MOMENTS, dt2);
+  }
+  MPI_Startall(exchange.sendRequests.size(), exchange.sendRequests.data());
+
+  MPI_Waitall(exchange.receiveRequests.size(), exchange.receiveRequests.data(), MPI_STATUSES_IGNORE);
+
+  // Scatter into fsgrid, this part heavily relies on both sender and receiver having cellids sorted!
+  #pragma omp parallel for
+  for (size_t c = 0; c < plan.fsgridSideCells.size(); c++) {
+    const Real* receiveBuffer = exchange.receiveBuffer.data() + c * fsgrids::moments::N_MOMENTS;
+    for (size_t l = plan.fsgridSideLidOffsets[c]; l < plan.fsgridSideLidOffsets[c+1]; l++) {
+      Real* fsgridData = momentsGrid.get(plan.fsgridSideLids[l]);
+      for(int m = 0; m < fsgrids::moments::N_MOMENTS; m++) {
+        fsgridData[m] = receiveBuffer[m];
+      }
+    }
+  }
+
+  MPI_Waitall(exchange.sendRequests.size(), exchange.sendRequests.data(), MPI_STATUSES_IGNORE);
+
+  filterMoments(mpiGrid, momentsGrid, technicalGrid);
+}
+
+
+
+void feedMomentsIntoFsGrid(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                           const std::vector<CellID>& cells,
+                           FsGrid<Real, fsgrids::moments::N_MOMENTS, FS_STENCIL_WIDTH> & momentsGrid,
+                           FsGrid<Real, fsgrids::moments::N_MOMENTS, FS_STENCIL_WIDTH> & momentsDt2Grid,
+                           FsGrid< fsgrids::technical, 1, FS_STENCIL_WIDTH> & technicalGrid) {
+
+  // Base moments followed by _DT2 moments for each cell
+  const int stride = 2 * fsgrids::moments::N_MOMENTS;
+
+  CouplingPlan& plan = getCouplingPlan(mpiGrid, cells, momentsGrid);
+  CouplingExchange& exchange = getCouplingExchange(plan, COUPLING_TAG_MOMENTS_FUSED, stride, true);
+
+  // Post receives
+  MPI_Startall(exchange.receiveRequests.size(), exchange.receiveRequests.data());
+
+  // Pack and launch sends. Cells are in the same (sorted) order as on the receiving side.
+  #pragma omp parallel for
+  for (size_t c = 0; c < plan.dccrgSideCells.size(); c++) {
+    const Real* cellParams = mpiGrid[plan.dccrgSideCells[c]]->get_cell_parameters();
+    packMoments(cellParams, exchange.sendBuffer.data() + c * stride, false);
+    packMoments(cellParams, exchange.sendBuffer.data() + c * stride + fsgrids::moments::N_MOMENTS, true);
+  }
+  MPI_Startall(exchange.sendRequests.size(), exchange.sendRequests.data());
+
+  MPI_Waitall(exchange.receiveRequests.size(), exchange.receiveRequests.data(), MPI_STATUSES_IGNORE);
+
+  // Scatter into both fsgrids, this part heavily relies on both sender and receiver having cellids sorted!
+  #pragma omp parallel for
+  for (size_t c = 0; c < plan.fsgridSideCells.size(); c++) {
+    const Real* receiveBuffer = exchange.receiveBuffer.data() + c * stride;
+    for (size_t l = plan.fsgridSideLidOffsets[c]; l < plan.fsgridSideLidOffsets[c+1]; l++) {
+      Real* fsgridData = momentsGrid.get(plan.fsgridSideLids[l]);
+      Real* fsgridDataDt2 = momentsDt2Grid.get(plan.fsgridSideLids[l]);
+      for(int m = 0; m < fsgrids::moments::N_MOMENTS; m++) {
+        fsgridData[m] = receiveBuffer[m];
+        fsgridDataDt2[m] = receiveBuffer[fsgrids::moments::N_MOMENTS + m];
+      }
+    }
+  }
+
+  MPI_Waitall(exchange.sendRequests.size(), exchange.sendRequests.data(), MPI_STATUSES_IGNORE);
+
+  filterMoments(mpiGrid, momentsGrid, technicalGrid);
+  filterMoments(mpiGrid, momentsDt2Grid, technicalGrid);
+}
+
 
 void getFieldsFromFsGrid(
    FsGrid<Real, fsgrids::volfields::N_VOL, FS_STENCIL_WIDTH> & volumeFieldsGrid,
@@ -313,183 +490,102 @@ void getFieldsFromFsGrid(
   // TODO: solver only needs bgb + PERB, we could combine them
   
   const int fieldsToCommunicate = 21;
-  struct Average {
-    Real sums[fieldsToCommunicate];
-    int cells;
-    Average()  {
-      cells = 0;
-      for(int i = 0; i < fieldsToCommunicate; i++){
-         sums[i] = 0;
-      }
-    }
-    Average operator+=(const Average& rhs) {
-      this->cells += rhs.cells;
-      for(int i = 0; i < fieldsToCommunicate; i++){
-         this->sums[i] += rhs.sums[i];
-      }
-    return *this;
-    }
-  };
+  // Each transferred entry holds the sums of the fields, followed by the number of summed fsgrid cells
+  const int stride = fieldsToCommunicate + 1;
 
-    
-  int ii;
-  //sorted list of dccrg cells. cells is typicall already sorted, but just to make sure....
-  std::vector<CellID> dccrgCells = cells;
-  std::sort(dccrgCells.begin(), dccrgCells.end());
-
-  //Datastructure for coupling
-  std::map<int, std::set<CellID> > onDccrgMapRemoteProcess; 
-  std::map<int, std::set<CellID> > onFsgridMapRemoteProcess; 
-  std::map<CellID, std::vector<int64_t> >  onFsgridMapCells;
-    
-  // map receive process => receive buffers 
-  std::map<int, std::vector<Average> > receivedData; 
-
-  // send buffers  to each process
-  std::map<int, std::vector<Average> > sendData;
-
-  // map where we finally aggregate result for each local dccrg cell
-  std::map<CellID, Average> aggregatedResult;
-
-  //list of requests
-  std::vector<MPI_Request> sendRequests;
-  std::vector<MPI_Request> receiveRequests;
-
-  
-  //computeCoupling
-  computeCoupling(mpiGrid, cells, volumeFieldsGrid, onDccrgMapRemoteProcess, onFsgridMapRemoteProcess, onFsgridMapCells);
+  CouplingPlan& plan = getCouplingPlan(mpiGrid, cells, volumeFieldsGrid);
+  CouplingExchange& exchange = getCouplingExchange(plan, COUPLING_TAG_FIELDS, stride, false);
 
   //post receives
-  ii=0;
-  receiveRequests.resize(onDccrgMapRemoteProcess.size());
-  for (auto const &rcv : onDccrgMapRemoteProcess){
-    int remoteRank = rcv.first; 
-    int count = rcv.second.size();
-    auto& receiveBuffer=receivedData[remoteRank];
-    
-    receiveBuffer.resize(count);
-    MPI_Irecv(receiveBuffer.data(), count * sizeof(Average),
-		 MPI_BYTE, remoteRank, 1, MPI_COMM_WORLD,&(receiveRequests[ii++]));
-  }
-
-  //compute average and weight for each field that we want to send to dccrg grid
-  for(auto const &snd: onFsgridMapRemoteProcess){
-    int remoteRank = snd.first;
-    int count = snd.second.size();
-    auto& sendBuffer = sendData[remoteRank];
-    sendBuffer.resize(count);
-    
-    ii=0;
-    for(auto const dccrgCell: snd.second){
-      //loop over dccrg cells to which we shall send data for this remoteRank
-      auto const &fsgridCells = onFsgridMapCells[dccrgCell];
-      for (auto const fsgridCell: fsgridCells){
-        //loop over fsgrid cells for which we compute the average that is sent to dccrgCell on rank remoteRank
-        if(technicalGrid.get(fsgridCell)->sysBoundaryFlag == sysboundarytype::DO_NOT_COMPUTE) {
-           continue;
-        }
-        Real* volcell = volumeFieldsGrid.get(fsgridCell);
-	      Real* bgcell = BgBGrid.get(fsgridCell);
-	      Real* egradpecell = EGradPeGrid.get(fsgridCell);	
-	
-        sendBuffer[ii].sums[0 ] += volcell[fsgrids::volfields::PERBXVOL];
-        sendBuffer[ii].sums[1 ] += volcell[fsgrids::volfields::PERBYVOL];
-        sendBuffer[ii].sums[2 ] += volcell[fsgrids::volfields::PERBZVOL];
-        sendBuffer[ii].sums[6 ] += volcell[fsgrids::volfields::dPERBXVOLdy] / technicalGrid.DY;
-        sendBuffer[ii].sums[7 ] += volcell[fsgrids::volfields::dPERBXVOLdz] / technicalGrid.DZ;
-        sendBuffer[ii].sums[8 ] += volcell[fsgrids::volfields::dPERBYVOLdx] / technicalGrid.DX;
-        sendBuffer[ii].sums[9 ] += volcell[fsgrids::volfields::dPERBYVOLdz] / technicalGrid.DZ;
-        sendBuffer[ii].sums[10] += volcell[fsgrids::volfields::dPERBZVOLdx] / technicalGrid.DX;
-        sendBuffer[ii].sums[11] += volcell[fsgrids::volfields::dPERBZVOLdy] / technicalGrid.DY;
-        sendBuffer[ii].sums[12] += bgcell[fsgrids::bgbfield::BGBXVOL];
-        sendBuffer[ii].sums[13] += bgcell[fsgrids::bgbfield::BGBYVOL];
-        sendBuffer[ii].sums[14] += bgcell[fsgrids::bgbfield::BGBZVOL];
-        sendBuffer[ii].sums[15] += egradpecell[fsgrids::egradpe::EXGRADPE];
-        sendBuffer[ii].sums[16] += egradpecell[fsgrids::egradpe::EYGRADPE];
-        sendBuffer[ii].sums[17] += egradpecell[fsgrids::egradpe::EZGRADPE];
-	sendBuffer[ii].sums[18] += volcell[fsgrids::volfields::EXVOL];
-	sendBuffer[ii].sums[19] += volcell[fsgrids::volfields::EYVOL];
-	sendBuffer[ii].sums[20] += volcell[fsgrids::volfields::EZVOL];
-        sendBuffer[ii].cells++;
+  MPI_Startall(exchange.receiveRequests.size(), exchange.receiveRequests.data());
+
+  //compute sum and weight for each field that we want to send to dccrg grid
+  #pragma omp parallel for
+  for (size_t c = 0; c < plan.fsgridSideCells.size(); c++) {
+    Real* sums = exchange.sendBuffer.data() + c * stride;
+    for (int i = 0; i < stride; i++) {
+      sums[i] = 0;
+    }
+    for (size_t l = plan.fsgridSideLidOffsets[c]; l < plan.fsgridSideLidOffsets[c+1]; l++) {
+      //loop over fsgrid cells for which we compute the average that is sent to this dccrg cell
+      const int64_t fsgridCell = plan.fsgridSideLids[l];
+      if(technicalGrid.get(fsgridCell)->sysBoundaryFlag == sysboundarytype::DO_NOT_COMPUTE) {
+         continue;
       }
-      ii++;
+      Real* volcell = volumeFieldsGrid.get(fsgridCell);
+      Real* bgcell = BgBGrid.get(fsgridCell);
+      Real* egradpecell = EGradPeGrid.get(fsgridCell);
+
+      sums[0 ] += volcell[fsgrids::volfields::PERBXVOL];
+      sums[1 ] += volcell[fsgrids::volfields::PERBYVOL];
+      sums[2 ] += volcell[fsgrids::volfields::PERBZVOL];
+      sums[6 ] += volcell[fsgrids::volfields::dPERBXVOLdy] / technicalGrid.DY;
+      sums[7 ] += volcell[fsgrids::volfields::dPERBXVOLdz] / technicalGrid.DZ;
+      sums[8 ] += volcell[fsgrids::volfields::dPERBYVOLdx] / technicalGrid.DX;
+      sums[9 ] += volcell[fsgrids::volfields::dPERBYVOLdz] / technicalGrid.DZ;
+      sums[10] += volcell[fsgrids::volfields::dPERBZVOLdx] / technicalGrid.DX;
+      sums[11] += volcell[fsgrids::volfields::dPERBZVOLdy] / technicalGrid.DY;
+      sums[12] += bgcell[fsgrids::bgbfield::BGBXVOL];
+      sums[13] += bgcell[fsgrids::bgbfield::BGBYVOL];
+      sums[14] += bgcell[fsgrids::bgbfield::BGBZVOL];
+      sums[15] += egradpecell[fsgrids::egradpe::EXGRADPE];
+      sums[16] += egradpecell[fsgrids::egradpe::EYGRADPE];
+      sums[17] += egradpecell[fsgrids::egradpe::EZGRADPE];
+      sums[18] += volcell[fsgrids::volfields::EXVOL];
+      sums[19] += volcell[fsgrids::volfields::EYVOL];
+      sums[20] += volcell[fsgrids::volfields::EZVOL];
+      sums[fieldsToCommunicate] += 1;
     }
   }
-  
+
   //post sends
-  sendRequests.resize(onFsgridMapRemoteProcess.size());
-  ii=0;
-  for(auto const &sends: onFsgridMapRemoteProcess){
-    int remoteRank = sends.first;
-    int count = sends.second.size();
-    MPI_Isend(sendData[remoteRank].data(), count * sizeof(Average),
-	     MPI_BYTE, remoteRank, 1, MPI_COMM_WORLD,&(sendRequests[ii++]));
-  }
-  
-  MPI_Waitall(receiveRequests.size(), receiveRequests.data(), MPI_STATUSES_IGNORE);
-
-
-  //Aggregate receives, compute the weighted average of these
-  ii=0;
-  for (auto const &rcv : onDccrgMapRemoteProcess){
-    int remoteRank = rcv.first; 
-    std::vector<Average>& receiveBuffer=receivedData[remoteRank];
-    ii=0;
-    for (CellID dccrgCell: rcv.second ) {
-      //aggregate result. Average strct has operator += and a constructor
-      aggregatedResult[dccrgCell] += receiveBuffer[ii++];
+  MPI_Startall(exchange.sendRequests.size(), exchange.sendRequests.data());
+
+  MPI_Waitall(exchange.receiveRequests.size(), exchange.receiveRequests.data(), MPI_STATUSES_IGNORE);
+
+  //Aggregate receives, a dccrg cell may get contributions from several fsgrid ranks
+  std::vector<Real> aggregatedResult(plan.localCells.size() * stride, 0.0);
+  for (size_t c = 0; c < plan.dccrgSideCells.size(); c++) {
+    const Real* received = exchange.receiveBuffer.data() + c * stride;
+    Real* aggregate = aggregatedResult.data() + plan.dccrgSideCellIndex[c] * stride;
+    for (int i = 0; i < stride; i++) {
+      aggregate[i] += received[i];
     }
   }
-  
-  //Store data in dccrg
-  for (auto const &cellAggregate : aggregatedResult) {
-    auto cellParams = mpiGrid[cellAggregate.first]->get_cell_parameters();
-    if ( cellAggregate.second.cells > 0) {
-      cellParams[CellParams::PERBXVOL] = cellAggregate.second.sums[0] / cellAggregate.second.cells;
-      cellParams[CellParams::PERBYVOL] = cellAggregate.second.sums[1] / cellAggregate.second.cells;
-      cellParams[CellParams::PERBZVOL] = cellAggregate.second.sums[2] / cellAggregate.second.cells;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBXVOLdy] = cellAggregate.second.sums[6] / cellAggregate.second.cells;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBXVOLdz] = cellAggregate.second.sums[7] / cellAggregate.second.cells;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBYVOLdx] = cellAggregate.second.sums[8] / cellAggregate.second.cells;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBYVOLdz] = cellAggregate.second.sums[9] / cellAggregate.second.cells;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBZVOLdx] = cellAggregate.second.sums[10] / cellAggregate.second.cells;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBZVOLdy] = cellAggregate.second.sums[11] / cellAggregate.second.cells;
-      cellParams[CellParams::BGBXVOL]  = cellAggregate.second.sums[12] / cellAggregate.second.cells;
-      cellParams[CellParams::BGBYVOL]  = cellAggregate.second.sums[13] / cellAggregate.second.cells;
-      cellParams[CellParams::BGBZVOL]  = cellAggregate.second.sums[14] / cellAggregate.second.cells;
-      cellParams[CellParams::EXGRADPE] = cellAggregate.second.sums[15] / cellAggregate.second.cells;
-      cellParams[CellParams::EYGRADPE] = cellAggregate.second.sums[16] / cellAggregate.second.cells;
-      cellParams[CellParams::EZGRADPE] = cellAggregate.second.sums[17] / cellAggregate.second.cells;
-      cellParams[CellParams::EXVOL] = cellAggregate.second.sums[18] / cellAggregate.second.cells;
-      cellParams[CellParams::EYVOL] = cellAggregate.second.sums[19] / cellAggregate.second.cells;
-      cellParams[CellParams::EZVOL] = cellAggregate.second.sums[20] / cellAggregate.second.cells;
-    }
-    else{
-      // This could happpen if all fsgrid cells are do not compute
-      cellParams[CellParams::PERBXVOL] = 0;
-      cellParams[CellParams::PERBYVOL] = 0;
-      cellParams[CellParams::PERBZVOL] = 0;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBXVOLdy] = 0;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBXVOLdz] = 0;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBYVOLdx] = 0;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBYVOLdz] = 0;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBZVOLdx] = 0;
-      mpiGrid[cellAggregate.first]->derivativesBVOL[bvolderivatives::dPERBZVOLdy] = 0;
-      cellParams[CellParams::BGBXVOL]  = 0;
-      cellParams[CellParams::BGBYVOL]  = 0;
-      cellParams[CellParams::BGBZVOL]  = 0;
-      cellParams[CellParams::EXGRADPE] = 0;
-      cellParams[CellParams::EYGRADPE] = 0;
-      cellParams[CellParams::EZGRADPE] = 0;
-      cellParams[CellParams::EXVOL] = 0;
-      cellParams[CellParams::EYVOL] = 0;
-      cellParams[CellParams::EZVOL] = 0;
-    }
+
+  //Store data in dccrg, compute the weighted average
+  #pragma omp parallel for
+  for (size_t c = 0; c < plan.localCells.size(); c++) {
+    const CellID dccrgCell = plan.localCells[c];
+    const Real* sums = aggregatedResult.data() + c * stride;
+    const Real nCells = sums[fieldsToCommunicate];
+    // Zero if all fsgrid cells are do not compute
+    const Real weight = nCells > 0 ? 1.0 / nCells : 0.0;
+    auto cellParams = mpiGrid[dccrgCell]->get_cell_parameters();
+    cellParams[CellParams::PERBXVOL] = sums[0] * weight;
+    cellParams[CellParams::PERBYVOL] = sums[1] * weight;
+    cellParams[CellParams::PERBZVOL] = sums[2] * weight;
+    mpiGrid[dccrgCell]->derivativesBVOL[bvolderivatives::dPERBXVOLdy] = sums[6] * weight;
+    mpiGrid[dccrgCell]->derivativesBVOL[bvolderivatives::dPERBXVOLdz] = sums[7] * weight;
+    mpiGrid[dccrgCell]->derivativesBVOL[bvolderivatives::dPERBYVOLdx] = sums[8] * weight;
+    mpiGrid[dccrgCell]->derivativesBVOL[bvolderivatives::dPERBYVOLdz] = sums[9] * weight;
+    mpiGrid[dccrgCell]->derivativesBVOL[bvolderivatives::dPERBZVOLdx] = sums[10] * weight;
+    mpiGrid[dccrgCell]->derivativesBVOL[bvolderivatives::dPERBZVOLdy] = sums[11] * weight;
+    cellParams[CellParams::BGBXVOL]  = sums[12] * weight;
+    cellParams[CellParams::BGBYVOL]  = sums[13] * weight;
+    cellParams[CellParams::BGBZVOL]  = sums[14] * weight;
+    cellParams[CellParams::EXGRADPE] = sums[15] * weight;
+    cellParams[CellParams::EYGRADPE] = sums[16] * weight;
+    cellParams[CellParams::EZGRADPE] = sums[17] * weight;
+    cellParams[CellParams::EXVOL] = sums[18] * weight;
+    cellParams[CellParams::EYVOL] = sums[19] * weight;
+    cellParams[CellParams::EZVOL] = sums[20] * weight;
   }
   
-  MPI_Waitall(sendRequests.size(), sendRequests.data(), MPI_STATUSES_IGNORE);
+  MPI_Waitall(exchange.sendRequests.size(), exchange.sendRequests.data(), MPI_STATUSES_IGNORE);
 }
 
+
 /*
 Map from dccrg cell id to fsgrid global cell ids when they aren't identical (ie. when dccrg has refinement).
 */
@@ -7,13 +7,23 @@
 std::vector<CellID> mapDccrgIdToFsGridGlobalID(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
 					       CellID dccrgID);
 
+/*! Invalidate the cached DCCRG <=> FsGrid coupling plan.
+ *
+ * Has to be called whenever the dccrg partitioning or refinement changes (balanceLoad and the
+ * initial refinement and load balance in initializeGrids do this), the plan is then rebuilt on the
+ * next coupling transfer. Also frees the persistent MPI requests of the plan, so it should be
+ * called before MPI_Finalize.
+ */
+void invalidateFsGridCoupling();
+
 /*! Take input moments from DCCRG grid and put them into the Fieldsolver grid
  * \param mpiGrid The DCCRG grid carrying rho, rhoV and P
  * \param cells List of local cells
  * \param momentsGrid Fieldsolver grid for these quantities
  * \param dt2 Whether to copy base moments, or _DT2 moments
  *
- * This function assumes that proper grid coupling has been set up.
+ * The coupling is taken from the cached coupling plan, which is computed on first use
+ * after invalidateFsGridCoupling().
  */
 void feedMomentsIntoFsGrid(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
                            const std::vector<CellID>& cells,
@@ -21,12 +31,29 @@ void feedMomentsIntoFsGrid(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
                            FsGrid< fsgrids::technical, 1, FS_STENCIL_WIDTH> & technicalGrid,
                            bool dt2=false);
 
+/*! Take input moments from DCCRG grid and put them into the Fieldsolver grids, transferring
+ * both base and _DT2 moments in a single exchange (one message per peer instead of two).
+ * \param mpiGrid The DCCRG grid carrying rho, rhoV and P
+ * \param cells List of local cells
+ * \param momentsGrid Fieldsolver grid receiving the base moments
+ * \param momentsDt2Grid Fieldsolver grid receiving the _DT2 moments
+ *
+ * The coupling is taken from the cached coupling plan, which is computed on first use
+ * after invalidateFsGridCoupling().
+ */
+void feedMomentsIntoFsGrid(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                           const std::vector<CellID>& cells,
+                           FsGrid<Real, fsgrids::moments::N_MOMENTS, FS_STENCIL_WIDTH> & momentsGrid,
+                           FsGrid<Real, fsgrids::moments::N_MOMENTS, FS_STENCIL_WIDTH> & momentsDt2Grid,
+                           FsGrid< fsgrids::technical, 1, FS_STENCIL_WIDTH> & technicalGrid);
+
 /*! Copy field solver result (VOLB, VOLE, VOLPERB derivatives, gradpe) and store them back into DCCRG
  * \param mpiGrid The DCCRG grid carrying fields.
  * \param cells List of local cells
  * \param volumeFieldsGrid Fieldsolver grid for these quantities
  *
- * This function assumes that proper grid coupling has been set up.
+ * The coupling is taken from the cached coupling plan, which is computed on first use
+ * after invalidateFsGridCoupling().
  */
 void getFieldsFromFsGrid(FsGrid<Real, fsgrids::volfields::N_VOL, FS_STENCIL_WIDTH> & volumeFieldsGrid,
 			 FsGrid<Real, fsgrids::bgbfield::N_BGB, FS_STENCIL_WIDTH> & BgBGrid,
@@ -172,6 +172,7 @@ void initializeGrids(
    phiprof::start("Refine spatial cells");
    if(P::amrMaxSpatialRefLevel > 0 && project.refineSpatialCells(mpiGrid)) {
       recalculateLocalCellsCache();
+      invalidateFsGridCoupling();
    }
    phiprof::stop("Refine spatial cells");
    
@@ -184,6 +185,7 @@ void initializeGrids(
    if (myRank == MASTER_RANK) logFile << "(INIT): Starting initial load balance." << endl << writeVerbose;
    mpiGrid.balance_load(); // Direct DCCRG call, recalculate cache afterwards
    recalculateLocalCellsCache();
+   invalidateFsGridCoupling();
 
    if(P::amrMaxSpatialRefLevel > 0) {
       setFaceNeighborRanks( mpiGrid );
@@ -299,6 +301,7 @@ void initializeGrids(
       
       for (size_t i=0; i<cells.size(); ++i) {
          mpiGrid[cells[i]]->parameters[CellParams::LBWEIGHTCOUNTER] = 0;
+         mpiGrid[cells[i]]->parameters[CellParams::LBWEIGHTTIME] = 0;
       }
 
       for (uint popID=0; popID<getObjectWrapper().particleSpecies.size(); ++popID) {
@@ -371,12 +374,12 @@ void initializeGrids(
    phiprof::stop("setProjectBField");
    
    phiprof::start("Finish fsgrid setup");
-   feedMomentsIntoFsGrid(mpiGrid, cells, momentsGrid,technicalGrid, false);
    if(!P::isRestart) {
+      feedMomentsIntoFsGrid(mpiGrid, cells, momentsGrid,technicalGrid, false);
       // WARNING this means moments and dt2 moments are the same here at t=0, which is a feature so far.
       feedMomentsIntoFsGrid(mpiGrid, cells, momentsDt2Grid, technicalGrid, false);
    } else {
-      feedMomentsIntoFsGrid(mpiGrid, cells, momentsDt2Grid, technicalGrid, true);
+      feedMomentsIntoFsGrid(mpiGrid, cells, momentsGrid, momentsDt2Grid, technicalGrid);
    }
    momentsGrid.updateGhostCells();
    momentsDt2Grid.updateGhostCells();
@@ -467,6 +470,8 @@ void setFaceNeighborRanks( dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
 void balanceLoad(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid, SysBoundary& sysBoundaries){
    // Invalidate cached cell lists
    Parameters::meshRepartitioned = true;
+   // Invalidate cached dccrg <=> fsgrid coupling, it is recomputed on first use after repartitioning
+   invalidateFsGridCoupling();
 
    // tell other processes which velocity blocks exist in remote spatial cells
    phiprof::initializeTimer("Balancing load", "Load balance");
@@ -479,12 +484,36 @@ void balanceLoad(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid, S
    phiprof::stop("deallocate boundary data");
    //set weights based on each cells LB weight counter
    const vector<CellID>& cells = getLocalCells();
+
+   // Blend the block count based counter with the measured compute time. The
+   // time is scaled to the same global sum as the counter so that the blend
+   // weight is independent of the units of the two. If no time has been
+   // measured (e.g. at initialization) only the counter is used.
+   Real measuredCostWeight = P::loadBalanceMeasuredCostWeight;
+   Real timeScale = 0.0;
+   if (measuredCostWeight > 0.0) {
+      Real localSums[2] = {0.0, 0.0};
+      Real globalSums[2];
+      for (size_t i=0; i<cells.size(); ++i) {
+         localSums[0] += mpiGrid[cells[i]]->parameters[CellParams::LBWEIGHTCOUNTER];
+         localSums[1] += mpiGrid[cells[i]]->parameters[CellParams::LBWEIGHTTIME];
+      }
+      MPI_Allreduce(localSums, globalSums, 2, MPI_Type<Real>(), MPI_SUM, MPI_COMM_WORLD);
+      if (globalSums[1] > 0.0) {
+         timeScale = globalSums[0] / globalSums[1];
+      } else {
+         measuredCostWeight = 0.0;
+      }
+   }
+
    for (size_t i=0; i<cells.size(); ++i){
       //Set weight. If acceleration is enabled then we use the weight
       //counter which is updated in acceleration, otherwise we just
       //use the number of blocks.
 //      if (P::propagateVlasovAcceleration) 
-      mpiGrid.set_cell_weight(cells[i], mpiGrid[cells[i]]->parameters[CellParams::LBWEIGHTCOUNTER]);
+      const Real* cellParams = mpiGrid[cells[i]]->parameters.data();
+      mpiGrid.set_cell_weight(cells[i], (1.0 - measuredCostWeight) * cellParams[CellParams::LBWEIGHTCOUNTER]
+                              + measuredCostWeight * timeScale * cellParams[CellParams::LBWEIGHTTIME]);
 //      else
 //         mpiGrid.set_cell_weight(cells[i], mpiGrid[cells[i]]->get_number_of_all_velocity_blocks());
       //reset counter
@@ -500,47 +529,114 @@ void balanceLoad(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid, S
    const std::unordered_set<CellID>& outgoing_cells = mpiGrid.get_cells_removed_by_balance_load();
    std::vector<CellID> outgoing_cells_list (outgoing_cells.begin(),outgoing_cells.end()); 
    
-   /*transfer cells in parts to preserve memory*/
+   /*transfer cells in batches to preserve memory*/
    phiprof::start("Data transfers");
-   const uint64_t num_part_transfers=5;
-   for (uint64_t transfer_part=0; transfer_part<num_part_transfers; transfer_part++) {
-      //Set transfers on/off for the incoming cells in this transfer set and prepare for receive
-      for (unsigned int i=0;i<incoming_cells_list.size();i++){
-         CellID cell_id=incoming_cells_list[i];
-         SpatialCell* cell = mpiGrid[cell_id];
-         if (cell_id%num_part_transfers!=transfer_part) {
-            cell->set_mpi_transfer_enabled(false);
-         } else {
-            cell->set_mpi_transfer_enabled(true);
+   for (unsigned int i=0; i<incoming_cells_list.size(); i++) mpiGrid[incoming_cells_list[i]]->set_mpi_transfer_enabled(true);
+   for (unsigned int i=0; i<outgoing_cells_list.size(); i++) mpiGrid[outgoing_cells_list[i]]->set_mpi_transfer_enabled(true);
+
+   // Transfer the velocity block list sizes of all migrating cells first, so
+   // that the receivers know the amount of block data to be moved. The rank
+   // of the sending process is transferred along with them.
+   int myRank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &myRank);
+   for (unsigned int i=0; i<outgoing_cells_list.size(); i++) mpiGrid[outgoing_cells_list[i]]->lbTransferSource = myRank;
+   for (size_t p=0; p<getObjectWrapper().particleSpecies.size(); ++p) {
+      SpatialCell::setCommunicatedSpecies(p);
+      if (p == 0) {
+         SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_LIST_STAGE1 | Transfer::CELL_LB_TRANSFER_SOURCE);
+      } else {
+         SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_LIST_STAGE1);
+      }
+      mpiGrid.continue_balance_load();
+   }
+
+   // The receiver allocates the block data, so it packs its incoming cells (in
+   // cell ID order) into batches that stay within the memory budget. A cell
+   // larger than the budget gets a batch of its own. The number of batches is
+   // set by the process needing the most, the transfers are collective.
+   const uint64_t budget = max((uint64_t)(P::loadBalanceTransferBudget * 1024 * 1024), (uint64_t)1);
+   uint64_t localBatches = 0;
+   {
+      vector<CellID> sortedIncoming(incoming_cells_list);
+      sort(sortedIncoming.begin(), sortedIncoming.end());
+      uint64_t batchBytes = 0;
+      for (size_t i=0; i<sortedIncoming.size(); ++i) {
+         SpatialCell* cell = mpiGrid[sortedIncoming[i]];
+         uint64_t cellBytes = 0;
+         for (size_t p=0; p<getObjectWrapper().particleSpecies.size(); ++p) {
+            cellBytes += cell->get_population(p).N_blocks * WID3 * sizeof(Realf);
+         }
+         if (localBatches == 0 || (batchBytes > 0 && batchBytes + cellBytes > budget)) {
+            ++localBatches;
+            batchBytes = 0;
          }
+         cell->lbTransferBatch = localBatches - 1;
+         batchBytes += cellBytes;
+      }
+   }
+   uint64_t num_batches;
+   MPI_Allreduce(&localBatches, &num_batches, 1, MPI_Type<uint64_t>(), MPI_MAX, MPI_COMM_WORLD);
+   num_batches = max(num_batches, (uint64_t)1);
+
+   // Tell the senders the batch of each of their outgoing cells, as (cell, batch) pairs
+   {
+      int nProcesses;
+      MPI_Comm_size(MPI_COMM_WORLD, &nProcesses);
+      vector<vector<uint64_t>> sendPlans(nProcesses);
+      for (unsigned int i=0; i<incoming_cells_list.size(); i++) {
+         const SpatialCell* cell = mpiGrid[incoming_cells_list[i]];
+         sendPlans[cell->lbTransferSource].push_back(incoming_cells_list[i]);
+         sendPlans[cell->lbTransferSource].push_back(cell->lbTransferBatch);
+      }
+      vector<int> sendCounts(nProcesses), sendDispls(nProcesses), recvCounts(nProcesses), recvDispls(nProcesses);
+      vector<uint64_t> sendBuffer;
+      for (int r=0; r<nProcesses; ++r) {
+         sendCounts[r] = sendPlans[r].size();
+         sendDispls[r] = sendBuffer.size();
+         sendBuffer.insert(sendBuffer.end(), sendPlans[r].begin(), sendPlans[r].end());
+      }
+      MPI_Alltoall(sendCounts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+      int recvSize = 0;
+      for (int r=0; r<nProcesses; ++r) {
+         recvDispls[r] = recvSize;
+         recvSize += recvCounts[r];
+      }
+      vector<uint64_t> recvBuffer(recvSize);
+      MPI_Alltoallv(sendBuffer.data(), sendCounts.data(), sendDispls.data(), MPI_Type<uint64_t>(),
+                    recvBuffer.data(), recvCounts.data(), recvDispls.data(), MPI_Type<uint64_t>(), MPI_COMM_WORLD);
+      for (int i=0; i+1<recvSize; i+=2) {
+         mpiGrid[recvBuffer[i]]->lbTransferBatch = recvBuffer[i+1];
+      }
+   }
+
+   for (size_t p=0; p<getObjectWrapper().particleSpecies.size(); ++p) {
+      SpatialCell::setCommunicatedSpecies(p);
+      SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_LIST_STAGE2);
+      mpiGrid.continue_balance_load();
+   }
+
+   // Block lists are now known on both ends, only the block data is moved in batches
+   for (uint64_t transfer_batch=0; transfer_batch<num_batches; transfer_batch++) {
+      //Set transfers on/off for the incoming cells in this transfer set
+      for (unsigned int i=0;i<incoming_cells_list.size();i++){
+         SpatialCell* cell = mpiGrid[incoming_cells_list[i]];
+         cell->set_mpi_transfer_enabled(cell->lbTransferBatch == transfer_batch);
       }
       
       //Set transfers on/off for the outgoing cells in this transfer set
       for (unsigned int i=0; i<outgoing_cells_list.size(); i++) {
-         CellID cell_id=outgoing_cells_list[i];
-         SpatialCell* cell = mpiGrid[cell_id];
-         if (cell_id%num_part_transfers!=transfer_part) {
-            cell->set_mpi_transfer_enabled(false);
-         } else {
-            cell->set_mpi_transfer_enabled(true);
-         }
+         SpatialCell* cell = mpiGrid[outgoing_cells_list[i]];
+         cell->set_mpi_transfer_enabled(cell->lbTransferBatch == transfer_batch);
       }
 
       for (size_t p=0; p<getObjectWrapper().particleSpecies.size(); ++p) {
          // Set active population
          SpatialCell::setCommunicatedSpecies(p);
 
-         //Transfer velocity block list
-         SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_LIST_STAGE1);
-         mpiGrid.continue_balance_load();
-         SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_LIST_STAGE2);
-         mpiGrid.continue_balance_load();
-      
          int receives = 0;
          for (unsigned int i=0; i<incoming_cells_list.size(); i++) {
-            CellID cell_id=incoming_cells_list[i];
-            SpatialCell* cell = mpiGrid[cell_id];
-            if (cell_id % num_part_transfers == transfer_part) {
+            SpatialCell* cell = mpiGrid[incoming_cells_list[i]];
+            if (cell->lbTransferBatch == transfer_batch) {
                receives++;
                phiprof::start("Preparing receives");
                // reserve space for velocity block data in arriving remote cells
@@ -563,16 +659,15 @@ void balanceLoad(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid, S
 
          // Free memory for cells that have been sent (the block data)
          for (unsigned int i=0;i<outgoing_cells_list.size();i++){
-            CellID cell_id=outgoing_cells_list[i];
-            SpatialCell* cell = mpiGrid[cell_id];
+            SpatialCell* cell = mpiGrid[outgoing_cells_list[i]];
             
             // Free memory of this cell as it has already been transferred, 
             // it will not be used anymore. NOTE: Only clears memory allocated 
             // to the active population.
-            if (cell_id % num_part_transfers == transfer_part) cell->clear(p);
+            if (cell->lbTransferBatch == transfer_batch) cell->clear(p);
          }
       } // for-loop over populations
-   } // for-loop over transfer parts
+   } // for-loop over transfer batches
    phiprof::stop("Data transfers");
 
    //finish up load balancing
@@ -664,6 +759,42 @@ void balanceLoad(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid, S
    phiprof::stop("Balancing load");
 }
 
+/*
+  Adjust the velocity blocks of one cell given its spatial neighbors, and
+  rescale the distribution to conserve mass if requested for the population.
+  Empty blocks are removed only if doDeleteEmptyBlocks is true.
+*/
+static void adjustCellVelocityBlocks(SpatialCell* cell,
+                                     const vector<SpatialCell*>& neighbor_ptrs,
+                                     const uint popID,
+                                     const bool doDeleteEmptyBlocks) {
+   Real density_pre_adjust=0.0;
+   Real density_post_adjust=0.0;
+   if (getObjectWrapper().particleSpecies[popID].sparse_conserve_mass) {
+      for (size_t i=0; i<cell->get_number_of_velocity_blocks(popID)*WID3; ++i) {
+         density_pre_adjust += cell->get_data(popID)[i];
+      }
+   }
+   cell->adjust_velocity_blocks(neighbor_ptrs,popID,doDeleteEmptyBlocks);
+
+   if (getObjectWrapper().particleSpecies[popID].sparse_conserve_mass) {
+      for (size_t i=0; i<cell->get_number_of_velocity_blocks(popID)*WID3; ++i) {
+         density_post_adjust += cell->get_data(popID)[i];
+      }
+      if (density_post_adjust != 0.0) {
+         for (size_t i=0; i<cell->get_number_of_velocity_blocks(popID)*WID3; ++i) {
+            cell->get_data(popID)[i] *= density_pre_adjust/density_post_adjust;
+         }
+      }
+   }
+#ifdef USE_CUDA
+   // Flag cell data as updated on host
+   vmesh::VelocityBlockContainer<vmesh::LocalID>& blockContainer = cell->get_velocity_blocks(popID);
+   blockContainer.dev_needsUpdatingBlocks = true;
+   blockContainer.dev_needsUpdatingParameters = true;
+#endif
+}
+
 /*
   Adjust sparse velocity space to make it consistent in all 6 dimensions.
 
@@ -699,8 +830,6 @@ bool adjustVelocityBlocks(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& m
    phiprof::start("Adjusting blocks");
    #pragma omp parallel for schedule(dynamic)
    for (size_t i=0; i<cellsToAdjust.size(); ++i) {
-      Real density_pre_adjust=0.0;
-      Real density_post_adjust=0.0;
       CellID cell_id=cellsToAdjust[i];
       SpatialCell* cell = mpiGrid[cell_id];
 
@@ -717,29 +846,7 @@ bool adjustVelocityBlocks(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& m
          }
          neighbor_ptrs.push_back(mpiGrid[neighbor_id]);
       }
-      if (getObjectWrapper().particleSpecies[popID].sparse_conserve_mass) {
-         for (size_t i=0; i<cell->get_number_of_velocity_blocks(popID)*WID3; ++i) {
-            density_pre_adjust += cell->get_data(popID)[i];
-         }
-      }
-      cell->adjust_velocity_blocks(neighbor_ptrs,popID);
-
-      if (getObjectWrapper().particleSpecies[popID].sparse_conserve_mass) {
-         for (size_t i=0; i<cell->get_number_of_velocity_blocks(popID)*WID3; ++i) {
-            density_post_adjust += cell->get_data(popID)[i];
-         }
-         if (density_post_adjust != 0.0) {
-            for (size_t i=0; i<cell->get_number_of_velocity_blocks(popID)*WID3; ++i) {
-               cell->get_data(popID)[i] *= density_pre_adjust/density_post_adjust;
-            }
-         }
-      }
-#ifdef USE_CUDA
-      // Flag cell data as updated on host
-      vmesh::VelocityBlockContainer<vmesh::LocalID>& blockContainer = cell->get_velocity_blocks(popID);
-      blockContainer.dev_needsUpdatingBlocks = true;
-      blockContainer.dev_needsUpdatingParameters = true;
-#endif
+      adjustCellVelocityBlocks(cell, neighbor_ptrs, popID, true);
    }
    phiprof::stop("Adjusting blocks");
 
@@ -752,6 +859,20 @@ bool adjustVelocityBlocks(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& m
    return true;
 }
 
+/*
+  Adjust the velocity blocks of a single local cell based on its own velocity
+  space only. Further documentation in grid.h
+*/
+void adjustLocalVelocityBlocks(SpatialCell* cell,const uint popID) {
+   //neighbor_ptrs is empty, so blocks that only the neighbors still
+   //need would look empty here. Deleting them would lose their mass,
+   //so empty blocks are kept until the neighbor-aware adjustment.
+   const vector<SpatialCell*> neighbor_ptrs;
+   cell->updateSparseMinValue(popID);
+   cell->update_velocity_block_content_lists(popID);
+   adjustCellVelocityBlocks(cell, neighbor_ptrs, popID, false);
+}
+
 /*! Shrink to fit velocity space data to save memory.
  * \param mpiGrid Spatial grid
  */
@@ -95,6 +95,18 @@ bool adjustVelocityBlocks(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& m
                           bool doPrepareToReceiveBlocks,
                             const uint popID);
 
+/*!
+ Adjust the velocity blocks of a single local cell using only its own velocity space
+ content, i.e., without any data from spatial neighbors. Blocks are added next to blocks
+ with content as in adjustVelocityBlocks, but empty blocks are not removed, since without
+ the neighbors it is not known which of them the neighbors still need. Remote cells are
+ not updated, so a call to adjustVelocityBlocks is needed before the cell is translated.
+
+ \param cell  Spatial cell to adjust
+ \param popID  Particle population
+*/
+void adjustLocalVelocityBlocks(SpatialCell* cell,const uint popID);
+
 /*! Estimates memory consumption and writes it into logfile. Collective operation on MPI_COMM_WORLD
  * \param mpiGrid Spatial grid
  */
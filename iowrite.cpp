@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <limits>
 #include <initializer_list>
+#include <thread>
 
 #include "iowrite.h"
 #include "math.h"
@@ -260,7 +261,15 @@ bool writeVelocityDistributionData(const uint popID,Writer& vlsvWriter,
    const uint64_t vectorSize_avgs = WID3; // There are 64 (WID=4) or 512 (WID=8) elements in every velocity block
 
    // Get the data size needed for writing in data
+#ifdef HPF
+   // 16-bit distribution function values are written in single precision,
+   // so they are converted to a temporary buffer first
+   const uint64_t dataSize_avgs = sizeof(float);
+   vector<float> convertedAvgs(WID3 * totalBlocks);
+   uint64_t convertedOffset = 0;
+#else
    uint64_t dataSize_avgs = sizeof(Realf);
+#endif
 
    // Start multi write
    vlsvWriter.startMultiwrite(datatype_avgs,arraySize_avgs,vectorSize_avgs,dataSize_avgs);
@@ -272,7 +281,17 @@ bool writeVelocityDistributionData(const uint popID,Writer& vlsvWriter,
       
       // Get the number of blocks in this cell
       const uint64_t arrayElements = SC->get_number_of_velocity_blocks(popID);
+#ifdef HPF
+      float* convertedData = convertedAvgs.data() + convertedOffset;
+      const Realf* blockData = SC->get_data(popID);
+      for (uint64_t i = 0; i < WID3 * arrayElements; ++i) {
+         convertedData[i] = blockData[i];
+      }
+      convertedOffset += WID3 * arrayElements;
+      char* arrayToWrite = reinterpret_cast<char*>(convertedData);
+#else
       char* arrayToWrite = reinterpret_cast<char*>(SC->get_data(popID));
+#endif
 
       // Add a subarray to write
       vlsvWriter.addMultiwriteUnit(arrayToWrite, arrayElements); // Note: We told beforehands that the vectorsize = WID3 = 64
@@ -295,16 +314,115 @@ bool writeVelocityDistributionData(const uint popID,Writer& vlsvWriter,
    return success;
 }
 
-/*! Writes info received from data reducer. This function writes out the variable arrays into the file
+/*! A variable array staged for writing by the asynchronous writer thread.*/
+struct StagedArray {
+   map<string,string> attribs;
+   string dataType;
+   uint64_t arraySize;
+   uint64_t vectorSize;
+   uint64_t dataSize;
+   vector<char> data;
+};
+
+/*! Variables of a bulk file that are appended to it by the asynchronous writer thread
+ after the rest of the file has been written and closed by the main thread.*/
+struct AsyncWriteJob {
+   string fileName;
+   MPI_Info info;    /*!< File hints of the bulk file, freed by waitForAsyncWrites.*/
+   vector<StagedArray> arrays;
+   uint64_t stagedBytes;
+   bool success;
+   double writeTime;
+   AsyncWriteJob(): info(MPI_INFO_NULL), stagedBytes(0), success(true), writeTime(0.0) { }
+};
+
+/*! The asynchronous writer thread. A normal exit waits for it in waitForAsyncWrites.
+ If the program exits without doing so (error paths), the thread is detached, as
+ destroying a joinable std::thread would call std::terminate and joining could hang
+ in the collective writes.*/
+struct AsyncWriteThread {
+   std::thread thread;
+   ~AsyncWriteThread() {
+      if (thread.joinable()) thread.detach();
+   }
+};
+
+static AsyncWriteThread asyncWriteThread;
+static AsyncWriteJob asyncWriteJob;
+static MPI_Comm asyncWriteComm = MPI_COMM_NULL;
+
+/*! Check whether bulk files can be written asynchronously. The writer thread calls MPI
+ concurrently with the main thread, which needs MPI_THREAD_MULTIPLE.
+ \return True if io.write_async is set and supported by the MPI library
+ */
+static bool asyncWritesEnabled() {
+   if (P::writeAsync == false) return false;
+   int provided;
+   MPI_Query_thread(&provided);
+   if (provided < MPI_THREAD_MULTIPLE) {
+      static bool warned = false;
+      if (!warned) {
+         logFile << "(IO): io.write_async needs MPI_THREAD_MULTIPLE (build with -DASYNC_IO), writing bulk files synchronously" << endl << writeVerbose;
+         warned = true;
+      }
+      return false;
+   }
+   return true;
+}
+
+/*! Body of the asynchronous writer thread. Appends the staged arrays of the job to its file.
+ Does not call phiprof or the logger, which are not thread-safe.*/
+static void runAsyncWriteJob(AsyncWriteJob* job) {
+   const double start = MPI_Wtime();
+   Writer vlsvWriter;
+   const int masterProcessId = 0;
+   const bool append = true;
+   if (vlsvWriter.open(job->fileName, asyncWriteComm, masterProcessId, job->info, append) == false) {
+      job->success = false;
+   } else {
+      vlsvWriter.setBuffer(P::vlsvBufferSize);
+      for (const auto& array : job->arrays) {
+         if (vlsvWriter.writeArray("VARIABLE", array.attribs, array.dataType, array.arraySize, array.vectorSize,
+                                   array.dataSize, array.data.data()) == false) {
+            job->success = false;
+         }
+      }
+      vlsvWriter.close();
+   }
+   job->writeTime = MPI_Wtime() - start;
+}
+
+/*! Wait until the asynchronous writer thread has written the previous bulk file, and report it.*/
+void waitForAsyncWrites() {
+   if (asyncWriteThread.thread.joinable() == false) return;
+   phiprof::start("waitForAsyncWrites");
+   asyncWriteThread.thread.join();
+   phiprof::stop("waitForAsyncWrites");
+   if (asyncWriteJob.info != MPI_INFO_NULL) {
+      MPI_Info_free(&asyncWriteJob.info);
+   }
+   if (asyncWriteJob.success == false) {
+      logFile << "(MAIN) writeGrid: ERROR failed to write datareductionoperator data to file " << asyncWriteJob.fileName << endl << writeVerbose;
+   }
+   logFile << "(writeGrid) Appended " << asyncWriteJob.arrays.size() << " variables (" << asyncWriteJob.stagedBytes/1.0e6
+           << " MB on this process) to " << asyncWriteJob.fileName << " in the background in "
+           << asyncWriteJob.writeTime << " seconds" << endl << writeVerbose;
+   asyncWriteJob = AsyncWriteJob();
+}
+
+/*! Writes out the variable array of one data reducer, reduced earlier by writeDataReducers.
  \param mpiGrid The Vlasiator's grid
  \param cells List of local cells (no ghost cells included)
  \param writeAsFloat If true, the data reducer writes variable arrays as float instead of double
  \param dataReducer The data reducer which contains the necessary functions for calculating variables
- \param dataReducerIndex Index in the data reducer (determines which variable to read) Note: size of the data reducer can be retrieved with dataReducer.size()
+ \param dataReducerIndex Index in the data reducer (determines which variable to read)
+ \param varBuffer The reduced data of all cells
+ \param reduceSuccess True if the data of all cells was reduced successfully, otherwise fsgrid data is written
  \param vlsvWriter Some vlsv writer with a file open
+ \param job If not NULL, the reduced data is copied to this job for the asynchronous writer instead of written
  \return Returns true if operation was successful
  */
-bool writeDataReducer(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+bool writeReducedData(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
                       const std::vector<CellID>& cells,
                       FsGrid<Real, fsgrids::bfield::N_BFIELD, FS_STENCIL_WIDTH> & perBGrid,
                       FsGrid<Real, fsgrids::efield::N_EFIELD, FS_STENCIL_WIDTH> & EGrid,
@@ -319,7 +437,10 @@ bool writeDataReducer(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
                       const bool writeAsFloat,
                       DataReducer& dataReducer,
                       int dataReducerIndex,
-                      Writer& vlsvWriter){
+                      char* varBuffer,
+                      const bool reduceSuccess,
+                      Writer& vlsvWriter,
+                      AsyncWriteJob* job){
    map<string,string> attribs;
    string variableName,dataType,unitString,unitStringLaTeX, variableStringLaTeX, unitConversionFactor;
    bool success=true;
@@ -328,14 +449,6 @@ bool writeDataReducer(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
    variableName = dataReducer.getName(dataReducerIndex);
    phiprof::start("DRO_"+variableName);
 
-   // If the DataReducer can write its data directly to the output file, do it here.
-   // Otherwise the output data is buffered and written below.
-   if (dataReducer.handlesWriting(dataReducerIndex) == true) {
-      success = dataReducer.writeData(dataReducerIndex,mpiGrid,cells,meshName,vlsvWriter);
-      phiprof::stop("DRO_"+variableName);
-      return success;
-   }
-
    //Get basic data on a variable:
    uint dataSize,vectorSize;
    attribs["mesh"] = meshName;
@@ -357,33 +470,30 @@ bool writeDataReducer(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
    attribs["unitConversion"]=unitConversionFactor;
    attribs["variableLaTeX"]=variableStringLaTeX;
 
-   // If DRO has a vector size of 0 it means this DRO should not write out anything. This is used e.g. for DROs we want only for certain populations.
-   if (vectorSize == 0) {
-      phiprof::stop("DRO_"+variableName);
-      return true;
-   }
-
-   const uint64_t varBufferArraySize = cells.size()*vectorSize*dataSize;
-   
-   //Request DataReductionOperator to calculate the reduced data for all local cells:
-   char* varBuffer = NULL;
-   try {
-      varBuffer = new char[varBufferArraySize];
-   } catch( bad_alloc& ) {
-      cerr << "ERROR, FAILED TO ALLOCATE MEMORY AT: " << __FILE__ << " " << __LINE__ << endl;
-      logFile << "(MAIN) writeGrid: ERROR FAILED TO ALLOCATE MEMORY AT: " << __FILE__ << " " << __LINE__ << endl << writeVerbose;
-      phiprof::stop("DRO_"+variableName);
-      return false;
-   }
-
-   for (size_t cell=0; cell<cells.size(); ++cell) {
-      //Reduce data ( return false if the operation fails )
-      if (dataReducer.reduceData(mpiGrid[cells[cell]],dataReducerIndex,varBuffer + cell*vectorSize*dataSize) == false){
-         success = false;
-         // Note that this is not an error (anymore), since fsgrid reducers will return false here.
+   if( reduceSuccess && job != NULL ) {
+      // Stage the data for the asynchronous writer, converting it to float if requested
+      job->arrays.push_back(StagedArray());
+      StagedArray& array = job->arrays.back();
+      array.attribs = attribs;
+      array.dataType = dataType;
+      array.arraySize = cells.size();
+      array.vectorSize = vectorSize;
+      if( (writeAsFloat == true && dataType.compare("float") == 0) && dataSize == sizeof(double) ) {
+         array.dataSize = sizeof(float);
+         array.data.resize(cells.size() * vectorSize * sizeof(float));
+         const double* varBuffer_double = reinterpret_cast<const double*>(varBuffer);
+         float* stagedData = reinterpret_cast<float*>(array.data.data());
+         #pragma omp parallel for
+         for( uint64_t i = 0; i < cells.size() * vectorSize; ++i ) {
+            stagedData[i] = (float)(varBuffer_double[i]);
+         }
+      } else {
+         array.dataSize = dataSize;
+         array.data.assign(varBuffer, varBuffer + cells.size() * vectorSize * dataSize);
       }
-   }
-   if( success ) {
+      job->stagedBytes += array.data.size();
+
+   } else if( reduceSuccess ) {
 
       if( (writeAsFloat == true && dataType.compare("float") == 0) && dataSize == sizeof(double) ) {
          double * varBuffer_double = reinterpret_cast<double*>(varBuffer);
@@ -392,24 +502,23 @@ bool writeDataReducer(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
          const uint32_t vectorSize_smaller = vectorSize;
          const uint32_t dataSize_smaller = sizeof(float);
          const string dataType_smaller = dataType;
-         float * varBuffer_smaller = NULL;
+         std::vector<float> varBuffer_smaller;
          try {
-            varBuffer_smaller = new float[arraySize_smaller * vectorSize_smaller];
+            varBuffer_smaller.resize(arraySize_smaller * vectorSize_smaller);
          } catch( bad_alloc& ) {
             cerr << "ERROR, FAILED TO ALLOCATE MEMORY AT: " << __FILE__ << " " << __LINE__ << endl;
             logFile << "(MAIN) writeGrid: ERROR FAILED TO ALLOCATE MEMORY AT: " << __FILE__ << " " << __LINE__ << endl << writeVerbose;
-            delete[] varBuffer;
-            varBuffer = NULL;
             phiprof::stop("DRO_"+variableName);
             return false;
          }
          //Input varBuffer_double into varBuffer_smaller:
+         #pragma omp parallel for
          for( uint64_t i = 0; i < arraySize_smaller * vectorSize_smaller; ++i ) {
             const double value = varBuffer_double[i];
             varBuffer_smaller[i] = (float)(value);
          }
          //Cast the varBuffer to char:
-         char * varBuffer_smaller_char = reinterpret_cast<char*>(varBuffer_smaller);
+         char * varBuffer_smaller_char = reinterpret_cast<char*>(varBuffer_smaller.data());
          //Write the array:
          phiprof::start("writeArray");
          if (vlsvWriter.writeArray("VARIABLE", attribs, dataType_smaller, arraySize_smaller, vectorSize_smaller, dataSize_smaller, varBuffer_smaller_char) == false) {
@@ -417,8 +526,6 @@ bool writeDataReducer(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
             logFile << "(MAIN) writeGrid: ERROR failed to write datareductionoperator data to file!" << endl << writeVerbose;
          }
          phiprof::stop("writeArray");
-         delete[] varBuffer_smaller;
-         varBuffer_smaller = NULL;
       } else {
          // Write  reduced data to file if DROP was successful:
          phiprof::start("writeArray");
@@ -442,12 +549,130 @@ bool writeDataReducer(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
       success = dataReducer.writeParameters(dataReducerIndex,vlsvWriter);
    }
 
-   delete[] varBuffer;
-   varBuffer = NULL;
    phiprof::stop("DRO_"+variableName);
    return success;
 }
 
+/*! Writes out the variable arrays of all data reducers. The data reducers are evaluated in
+ batches whose output fits in a buffer of P::reducerBufferSize bytes, with all the reducers of a
+ batch applied to each cell in one threaded pass over the cells. The buffer is reused between
+ the batches of one output file and released when all of them have been written.
+ \param mpiGrid The Vlasiator's grid
+ \param cells List of local cells (no ghost cells included)
+ \param writeAsFloat If true, the data reducer writes variable arrays as float instead of double
+ \param dataReducer The data reducer which contains the necessary functions for calculating variables
+ \param vlsvWriter Some vlsv writer with a file open
+ \param job If not NULL, reduced data is staged to this job for the asynchronous writer, as long as the
+ staged data of every process fits in P::asyncWriteBufferSize bytes
+ \return Returns true if operation was successful
+ */
+bool writeDataReducers(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                       const std::vector<CellID>& cells,
+                       FsGrid<Real, fsgrids::bfield::N_BFIELD, FS_STENCIL_WIDTH> & perBGrid,
+                       FsGrid<Real, fsgrids::efield::N_EFIELD, FS_STENCIL_WIDTH> & EGrid,
+                       FsGrid<Real, fsgrids::ehall::N_EHALL, FS_STENCIL_WIDTH> & EHallGrid,
+                       FsGrid<Real, fsgrids::egradpe::N_EGRADPE, FS_STENCIL_WIDTH> & EGradPeGrid,
+                       FsGrid<Real, fsgrids::moments::N_MOMENTS, FS_STENCIL_WIDTH> & momentsGrid,
+                       FsGrid<Real, fsgrids::dperb::N_DPERB, FS_STENCIL_WIDTH> & dPerBGrid,
+                       FsGrid<Real, fsgrids::dmoments::N_DMOMENTS, FS_STENCIL_WIDTH> & dMomentsGrid,
+                       FsGrid<Real, fsgrids::bgbfield::N_BGB, FS_STENCIL_WIDTH> & BgBGrid,
+                       FsGrid<Real, fsgrids::volfields::N_VOL, FS_STENCIL_WIDTH> & volGrid,
+                       FsGrid< fsgrids::technical, 1, FS_STENCIL_WIDTH> & technicalGrid,
+                       const bool writeAsFloat,
+                       DataReducer& dataReducer,
+                       Writer& vlsvWriter,
+                       AsyncWriteJob* job){
+   // Output buffer of the reducers, reused between batches and freed on return
+   std::vector<double> varBufferArena;
+   bool success = true;
+
+   uint i = 0;
+   while (i < dataReducer.size()) {
+      // Reducers that write their data directly to the output file
+      if (dataReducer.handlesWriting(i) == true) {
+         const string variableName = dataReducer.getName(i);
+         phiprof::start("DRO_"+variableName);
+         if (dataReducer.writeData(i,mpiGrid,cells,"SpatialGrid",vlsvWriter) == false) success = false;
+         phiprof::stop("DRO_"+variableName);
+         ++i;
+         continue;
+      }
+
+      // Collect the next batch of reducers, in order, until the buffer is full or a
+      // reducer writing its own data is met. Buffers are aligned to doubles.
+      vector<unsigned int> batch;
+      vector<uint64_t> batchOffsets;
+      uint64_t batchSize = 0;
+      while (i < dataReducer.size() && dataReducer.handlesWriting(i) == false) {
+         string dataType;
+         uint dataSize,vectorSize;
+         if (dataReducer.getDataVectorInfo(i,dataType,dataSize,vectorSize) == false) {
+            cerr << "ERROR when requesting info from DRO " << i << endl;
+            return false;
+         }
+         // If DRO has a vector size of 0 it means this DRO should not write out anything. This is used e.g. for DROs we want only for certain populations.
+         if (vectorSize == 0) {
+            ++i;
+            continue;
+         }
+         const uint64_t varBufferSize = (cells.size()*vectorSize*dataSize + sizeof(double) - 1) / sizeof(double);
+         if (batch.size() > 0 && (batchSize + varBufferSize) * sizeof(double) > P::reducerBufferSize) break;
+         batch.push_back(i);
+         batchOffsets.push_back(batchSize);
+         batchSize += varBufferSize;
+         ++i;
+      }
+      if (batch.size() == 0) continue;
+
+      if (varBufferArena.size() < batchSize) {
+         try {
+            varBufferArena.resize(batchSize);
+         } catch( bad_alloc& ) {
+            cerr << "ERROR, FAILED TO ALLOCATE MEMORY AT: " << __FILE__ << " " << __LINE__ << endl;
+            logFile << "(MAIN) writeGrid: ERROR FAILED TO ALLOCATE MEMORY AT: " << __FILE__ << " " << __LINE__ << endl << writeVerbose;
+            return false;
+         }
+      }
+      vector<char*> buffers(batch.size());
+      for (size_t b=0; b<batch.size(); ++b) {
+         buffers[b] = reinterpret_cast<char*>(varBufferArena.data() + batchOffsets[b]);
+      }
+
+      //Request DataReductionOperators to calculate the reduced data for all local cells:
+      phiprof::start("reduceData");
+      vector<bool> reduceSuccess;
+      dataReducer.reduceData(mpiGrid, cells, batch, buffers, reduceSuccess);
+      phiprof::stop("reduceData");
+
+      // The batch is staged only if it fits in the staging buffer of every process, all
+      // processes have to write the same variables collectively.
+      bool stageBatch = false;
+      if (job != NULL) {
+         uint64_t stagedBytes = job->stagedBytes;
+         for (size_t b=0; b<batch.size(); ++b) {
+            if (reduceSuccess[b] == false) continue;
+            string dataType;
+            uint dataSize,vectorSize;
+            dataReducer.getDataVectorInfo(batch[b],dataType,dataSize,vectorSize);
+            if (writeAsFloat == true && dataType.compare("float") == 0 && dataSize == sizeof(double)) dataSize = sizeof(float);
+            stagedBytes += cells.size()*vectorSize*dataSize;
+         }
+         uint64_t maxStagedBytes;
+         MPI_Allreduce(&stagedBytes, &maxStagedBytes, 1, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+         stageBatch = (maxStagedBytes <= P::asyncWriteBufferSize);
+      }
+
+      for (size_t b=0; b<batch.size(); ++b) {
+         if (writeReducedData(mpiGrid, cells, perBGrid, EGrid, EHallGrid, EGradPeGrid, momentsGrid, dPerBGrid, dMomentsGrid,
+                              BgBGrid, volGrid, technicalGrid, writeAsFloat, dataReducer, batch[b], buffers[b],
+                              reduceSuccess[b], vlsvWriter, stageBatch ? job : NULL) == false) {
+            success = false;
+         }
+      }
+   }
+   return success;
+}
+
 
 
 
@@ -1158,6 +1383,12 @@ bool writeGrid(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
    double allStart = MPI_Wtime();
    bool success = true;
    int myRank;
+   // Only one bulk file is written in the background at a time
+   waitForAsyncWrites();
+   const bool writeAsync = asyncWritesEnabled();
+   if (writeAsync && asyncWriteComm == MPI_COMM_NULL) {
+      MPI_Comm_dup(MPI_COMM_WORLD, &asyncWriteComm);
+   }
    phiprof::initializeTimer("Barrier-entering-writegrid","MPI","Barrier");
    phiprof::start("Barrier-entering-writegrid");
    MPI_Barrier(MPI_COMM_WORLD);
@@ -1209,6 +1440,8 @@ bool writeGrid(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
    phiprof::stop("open");
    
    if( MPIinfo != MPI_INFO_NULL ) {
+      // The background writer appends to the file with the same hints
+      if (writeAsync) MPI_Info_dup(MPIinfo, &asyncWriteJob.info);
       MPI_Info_free(&MPIinfo);
    }
    
@@ -1273,11 +1506,11 @@ bool writeGrid(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
    //Write necessary variables:
    //Determines whether we write in floats or doubles
    phiprof::start("writeDataReducer");
-   if (dataReducer != NULL) for( uint i = 0; i < dataReducer->size(); ++i ) {
-      if( writeDataReducer( mpiGrid, local_cells,
+   if (dataReducer != NULL) {
+      if( writeDataReducers( mpiGrid, local_cells,
                perBGrid, EGrid, EHallGrid, EGradPeGrid, momentsGrid, dPerBGrid, dMomentsGrid,
                BgBGrid, volGrid, technicalGrid,
-               (P::writeAsFloat==1), *dataReducer, i, vlsvWriter ) == false ) return false;
+               (P::writeAsFloat==1), *dataReducer, vlsvWriter, writeAsync ? &asyncWriteJob : NULL ) == false ) return false;
    }
    phiprof::stop("writeDataReducer");
    
@@ -1308,6 +1541,14 @@ bool writeGrid(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
    phiprof::start("close");
    vlsvWriter.close();
    phiprof::stop("close");
+
+   // Append the staged variables to the closed file in the background
+   if (asyncWriteJob.arrays.size() > 0) {
+      asyncWriteJob.fileName = fname.str();
+      asyncWriteThread.thread = std::thread(runAsyncWriteJob, &asyncWriteJob);
+   } else if (asyncWriteJob.info != MPI_INFO_NULL) {
+      MPI_Info_free(&asyncWriteJob.info);
+   }
    phiprof::stop("writeGrid-reduced",bytesWritten*1e-9,"GB");
    return success;
 }
@@ -1505,12 +1746,10 @@ bool writeRestart(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
    
    //Write necessary variables:
    const bool writeAsFloat = P::writeRestartAsFloat;
-   for (uint i=0; i<restartReducer.size(); ++i) {
-      writeDataReducer(mpiGrid, local_cells,
-            perBGrid, EGrid, EHallGrid, EGradPeGrid, momentsGrid, dPerBGrid, dMomentsGrid,
-            BgBGrid, volGrid, technicalGrid,
-            writeAsFloat, restartReducer, i, vlsvWriter);
-   }
+   writeDataReducers(mpiGrid, local_cells,
+         perBGrid, EGrid, EHallGrid, EGradPeGrid, momentsGrid, dPerBGrid, dMomentsGrid,
+         BgBGrid, volGrid, technicalGrid,
+         writeAsFloat, restartReducer, vlsvWriter, NULL);
    phiprof::stop("reduceddataIO");   
    //write the velocity distribution data -- note: it's expecting a vector of pointers:
    // Note: restart should always write double values to ensure the accuracy of the restart runs. 
@@ -1552,6 +1791,75 @@ bool writeRestart(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
 }
 
 
+/*! Diagnostic values of one step. They are reduced to the master process with a non-blocking
+ reduction, which is completed and written out by the next call of writeDiagnostic.*/
+struct PendingDiagnostic {
+   MPI_Request request;
+   uint nOps;
+   uint tstep;
+   Real t;
+   Real dt;
+   vector<Real> localValues;  /*!< Number of cells, then min, max and sum of each operator, each as a triplet.*/
+   vector<Real> globalValues;
+   PendingDiagnostic(): request(MPI_REQUEST_NULL), nOps(0), tstep(0), t(0.0), dt(0.0) { }
+};
+
+static PendingDiagnostic pendingDiagnostic;
+static MPI_Datatype diagnosticTripletType = MPI_DATATYPE_NULL;
+static MPI_Op diagnosticReduceOp = MPI_OP_NULL;
+
+/*! MPI reduction of (min, max, sum) triplets of diagnostic values.*/
+static void reduceDiagnosticTriplets(void* in, void* inout, int* len, MPI_Datatype* datatype) {
+   const Real* inValues = reinterpret_cast<const Real*>(in);
+   Real* inoutValues = reinterpret_cast<Real*>(inout);
+   for (int i=0; i<*len; ++i) {
+      inoutValues[3*i  ] = min(inValues[3*i  ], inoutValues[3*i  ]);
+      inoutValues[3*i+1] = max(inValues[3*i+1], inoutValues[3*i+1]);
+      inoutValues[3*i+2] = inValues[3*i+2] + inoutValues[3*i+2];
+   }
+}
+
+/*! Complete the pending diagnostic reduction, if any, and write out its values.*/
+void flushDiagnostic() {
+   if (pendingDiagnostic.request == MPI_REQUEST_NULL) return;
+   int myRank;
+   MPI_Comm_rank(MPI_COMM_WORLD,&myRank);
+
+   phiprof::start("diagnostic-wait");
+   MPI_Wait(&(pendingDiagnostic.request), MPI_STATUS_IGNORE);
+   phiprof::stop("diagnostic-wait");
+   if (myRank != MASTER_RANK) return;
+
+   const vector<Real>& globalValues = pendingDiagnostic.globalValues;
+   const Real nCells = globalValues[2];
+   diagnostic << setprecision(12); 
+   diagnostic << pendingDiagnostic.tstep << "\t";
+   diagnostic << pendingDiagnostic.t << "\t";
+   diagnostic << pendingDiagnostic.dt << "\t";
+   for (uint i=0; i<pendingDiagnostic.nOps; ++i) {
+      const Real* values = &(globalValues[3*(i+1)]);
+      Real average;
+      if (nCells != 0.0) average = values[2] / nCells;
+      else average = values[2];
+      diagnostic << values[0] << "\t" <<
+      values[1] << "\t" <<
+      values[2] << "\t" <<
+      average << "\t";
+   }
+   diagnostic << endl << write;
+}
+
+/*! Write out the pending diagnostic values and free the MPI datatype and operation of the reduction.*/
+void finalizeDiagnostic() {
+   flushDiagnostic();
+   if (diagnosticReduceOp != MPI_OP_NULL) {
+      MPI_Op_free(&diagnosticReduceOp);
+   }
+   if (diagnosticTripletType != MPI_DATATYPE_NULL) {
+      MPI_Type_free(&diagnosticTripletType);
+   }
+}
+
 /*!
 
 \brief Write out simulation diagnostics into diagnostic.txt
@@ -1574,11 +1882,9 @@ bool writeDiagnostic(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
    // Exit if the user does not want any diagnostics output
    if (nOps == 0) return true;
 
-   vector<Real> localMin(nOps), localMax(nOps), localSum(nOps+1), localAvg(nOps),
-               globalMin(nOps),globalMax(nOps),globalSum(nOps+1),globalAvg(nOps);
-   localSum[0] = 1.0 * nCells;
-   Real buffer;
-   bool success = true;
+   // Write out the values of the previous diagnostic step
+   flushDiagnostic();
+
    static bool printDiagnosticHeader = true;
    
    if (printDiagnosticHeader == true && myRank == MASTER_RANK) {
@@ -1595,49 +1901,43 @@ bool writeDiagnostic(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
    }
    
    for (uint i=0; i<nOps; ++i) {
-      
       if (dataReducer.getDataVectorInfo(i,dataType,dataSize,vectorSize) == false) {
          cerr << "ERROR when requesting info from diagnostic DRO " << dataReducer.getName(i) << endl;
       }
-      localMin[i] = std::numeric_limits<Real>::max();
-      localMax[i] = std::numeric_limits<Real>::min();
-      localSum[i+1] = 0.0;
-      buffer = 0.0;
-      
-      // Request DataReductionOperator to calculate the reduced data for all local cells:
-      for (uint64_t cell=0; cell<nCells; ++cell) {
-         success = true;
-         if (dataReducer.reduceDiagnostic(mpiGrid[cells[cell]], i, &buffer) == false) success = false;
-         localMin[i] = min(buffer, localMin[i]);
-         localMax[i] = max(buffer, localMax[i]);
-         localSum[i+1] += buffer;
-      }
-      localAvg[i] = localSum[i+1];
-      
-      if (success == false) logFile << "(MAIN) writeDiagnostic: ERROR datareductionoperator '" << dataReducer.getName(i) <<
-                               "' returned false!" << endl << writeVerbose;
    }
-   
-   MPI_Reduce(&localMin[0], &globalMin[0], nOps, MPI_Type<Real>(), MPI_MIN, 0, MPI_COMM_WORLD);
-   MPI_Reduce(&localMax[0], &globalMax[0], nOps, MPI_Type<Real>(), MPI_MAX, 0, MPI_COMM_WORLD);
-   MPI_Reduce(&localSum[0], &globalSum[0], nOps + 1, MPI_Type<Real>(), MPI_SUM, 0, MPI_COMM_WORLD);
-   
-   diagnostic << setprecision(12); 
-   diagnostic << Parameters::tstep << "\t";
-   diagnostic << Parameters::t << "\t";
-   diagnostic << Parameters::dt << "\t";
-   
+
+   // Request DataReducer to calculate the reduced data of all operators for all local cells:
+   vector<Real> localMin, localMax, localSum;
+   vector<bool> success;
+   dataReducer.reduceDiagnostic(mpiGrid, cells, localMin, localMax, localSum, success);
    for (uint i=0; i<nOps; ++i) {
-      if (globalSum[0] != 0.0) globalAvg[i] = globalSum[i+1] / globalSum[0];
-      else globalAvg[i] = globalSum[i+1];
-      if (myRank == MASTER_RANK) {
-         diagnostic << globalMin[i] << "\t" <<
-         globalMax[i] << "\t" <<
-         globalSum[i+1] << "\t" <<
-         globalAvg[i] << "\t";
-      }
+      if (success[i] == false) logFile << "(MAIN) writeDiagnostic: ERROR datareductionoperator '" << dataReducer.getName(i) <<
+                                  "' returned false!" << endl << writeVerbose;
+   }
+
+   if (diagnosticReduceOp == MPI_OP_NULL) {
+      MPI_Type_contiguous(3, MPI_Type<Real>(), &diagnosticTripletType);
+      MPI_Type_commit(&diagnosticTripletType);
+      MPI_Op_create(&reduceDiagnosticTriplets, 1, &diagnosticReduceOp);
+   }
+
+   // All values are reduced with one non-blocking reduction that is completed at the next diagnostic step
+   pendingDiagnostic.nOps = nOps;
+   pendingDiagnostic.tstep = Parameters::tstep;
+   pendingDiagnostic.t = Parameters::t;
+   pendingDiagnostic.dt = Parameters::dt;
+   pendingDiagnostic.localValues.resize(3*(nOps+1));
+   pendingDiagnostic.globalValues.resize(3*(nOps+1));
+   pendingDiagnostic.localValues[0] = 1.0 * nCells;
+   pendingDiagnostic.localValues[1] = 1.0 * nCells;
+   pendingDiagnostic.localValues[2] = 1.0 * nCells;
+   for (uint i=0; i<nOps; ++i) {
+      pendingDiagnostic.localValues[3*(i+1)  ] = localMin[i];
+      pendingDiagnostic.localValues[3*(i+1)+1] = localMax[i];
+      pendingDiagnostic.localValues[3*(i+1)+2] = localSum[i];
    }
-   if (myRank == MASTER_RANK) diagnostic << endl << write;
+   MPI_Ireduce(&(pendingDiagnostic.localValues[0]), &(pendingDiagnostic.globalValues[0]), nOps+1,
+               diagnosticTripletType, diagnosticReduceOp, MASTER_RANK, MPI_COMM_WORLD, &(pendingDiagnostic.request));
    return true;
 }
 
@@ -86,6 +86,14 @@ bool writeRestart(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
 
 /*!
 
+\brief Wait until the variables of the previous bulk file have been written in the background
+
+Called by writeGrid before writing a new bulk file, and at finalization.
+*/
+void waitForAsyncWrites();
+
+/*!
+
 \brief Write out simulation diagnostics into diagnostic.txt
 
 @param mpiGrid   The DCCRG grid with spatial cells
@@ -93,6 +101,23 @@ bool writeRestart(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
 */
 bool writeDiagnostic(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,DataReducer& dataReducer);
 
+/*!
+
+\brief Write out the diagnostics of the previous writeDiagnostic call
+
+The values are reduced in the background and written out when the next diagnostics
+are computed, or when this is called at the end of the simulation.
+*/
+void flushDiagnostic();
+
+/*!
+
+\brief Write out the pending diagnostics and free the MPI resources of their reduction
+
+Called once at the end of the simulation, writeDiagnostic must not be called after this.
+*/
+void finalizeDiagnostic();
+
 bool writeVelocitySpace(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
                         vlsv::Writer& vlsvWriter,int index,const std::vector<uint64_t>& cells);
 
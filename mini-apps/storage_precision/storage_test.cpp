@@ -0,0 +1,183 @@
+/*
+ * This file is part of Vlasiator.
+ * Copyright 2010-2016 Finnish Meteorological Institute
+ *
+ * For details of usage, see the COPYING file and read the "Rules of the Road"
+ * at http://www.physics.helsinki.fi/vlasiator/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+  Conservation and accuracy of the 16-bit (bfloat16, -DHPF) storage of the
+  distribution function compared to single precision storage.
+
+  VECL one-dimensional Maxwellian columns with different temperatures are
+  shifted back and forth with the semi-Lagrangian PPM mapping of the
+  acceleration solver, so that they return to the initial state every
+  2*SHIFT_STEPS steps. All computations are done in the vector precision;
+  between steps the columns are stored in either float or bfloat16, as in
+  Vlasiator. Reported are the relative change of mass, the L1 and maximum
+  differences to the float-stored run, and the time per step. The working
+  set fits in cache, so the times only show the cost of the conversions,
+  not the memory bandwidth saved by the smaller storage.
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "common.h"
+#include "bfloat16.h"
+#include "vlasovsolver/vec.h"
+#include "vlasovsolver/cpu_1d_ppm.hpp"
+
+const int CELLS = 400;          // cells in the columns
+const int BOUNDARY = 4;         // zero padding on both sides of the columns
+const int SHIFT_STEPS = 50;     // steps before the shift changes direction
+const Realv SHIFT = 0.37;       // shift per step, in cells
+const Realv THRESHOLD = 1.0e-15;
+const int TIMING_REPEATS = 5;   // timed runs of each storage type
+
+/* Shift all columns by SHIFT cells to the right (direction 1) or left
+   (direction -1). The source cell values are integrated over the target
+   cells as in the acceleration solver, so mass is conserved exactly in
+   exact arithmetic.*/
+void propagate(Vec* values, Vec* target, const int direction) {
+   for (int k = 0; k < CELLS + 2 * BOUNDARY; ++k) {
+      target[k] = Vec(0.0);
+   }
+   const Vec split((direction > 0) ? 1.0 - SHIFT : SHIFT);
+   for (int k = BOUNDARY; k < CELLS + BOUNDARY; ++k) {
+      Vec a[3];
+      compute_ppm_coeff(values, h6, k, a, THRESHOLD);
+      // integral of the reconstruction from the left edge of the cell to split
+      const Vec partial = split * (a[0] + split * (a[1] + split * a[2]));
+      const Vec total = a[0] + a[1] + a[2];
+      if (direction > 0) {
+         target[k] += partial;
+         target[k + 1] += total - partial;
+      } else {
+         target[k - 1] += partial;
+         target[k] += total - partial;
+      }
+   }
+   for (int k = 0; k < CELLS + 2 * BOUNDARY; ++k) {
+      values[k] = target[k];
+   }
+}
+
+template<typename T> void store(const Vec* values, std::vector<T>& storage) {
+   Realv v[VECL];
+   for (int k = 0; k < CELLS + 2 * BOUNDARY; ++k) {
+      values[k].store(v);
+      for (int i = 0; i < VECL; ++i) {
+         storage[k * VECL + i] = v[i];
+      }
+   }
+}
+
+template<typename T> void load(const std::vector<T>& storage, Vec* values) {
+   Realv v[VECL];
+   for (int k = 0; k < CELLS + 2 * BOUNDARY; ++k) {
+      for (int i = 0; i < VECL; ++i) {
+         v[i] = storage[k * VECL + i];
+      }
+      values[k].load(v);
+   }
+}
+
+/* Run the test with storage type T, returns the time per step.*/
+template<typename T> double run(std::vector<T>& storage, const int steps) {
+   std::vector<Vec> values(CELLS + 2 * BOUNDARY);
+   std::vector<Vec> target(CELLS + 2 * BOUNDARY);
+   const clock_t t = clock();
+   for (int step = 0; step < steps; ++step) {
+      load(storage, values.data());
+      propagate(values.data(), target.data(), ((step / SHIFT_STEPS) % 2 == 0) ? 1 : -1);
+      store(values.data(), storage);
+   }
+   return ((double)(clock() - t) / CLOCKS_PER_SEC) / steps;
+}
+
+template<typename T> double mass(const std::vector<T>& storage, const int lane) {
+   double sum = 0.0;
+   for (int k = 0; k < CELLS + 2 * BOUNDARY; ++k) {
+      sum += storage[k * VECL + lane];
+   }
+   return sum;
+}
+
+int main(void) {
+   const int steps = 20 * SHIFT_STEPS;
+   const Real dv = 30000.0;
+   const Real rho = 1.0e6;
+
+   // Maxwellians with temperatures from 5e5 to 5e7 K, one per vector element
+   std::vector<float> initial((CELLS + 2 * BOUNDARY) * VECL, 0.0);
+   for (int i = 0; i < VECL; ++i) {
+      const Real T = 5.0e5 * pow(100.0, (Real)i / (VECL > 1 ? VECL - 1 : 1));
+      for (int k = BOUNDARY; k < CELLS + BOUNDARY; ++k) {
+         const Real v = (k - BOUNDARY - 0.5 * CELLS + 0.5) * dv;
+         const Real f = rho * pow(physicalconstants::MASS_PROTON / (2.0 * M_PI * physicalconstants::K_B * T), 1.5) *
+            exp(- physicalconstants::MASS_PROTON * v * v / (2.0 * physicalconstants::K_B * T));
+         initial[k * VECL + i] = (f > THRESHOLD) ? f : 0.0;
+      }
+   }
+
+   std::vector<float> singleStorage(initial);
+   std::vector<BFloat16> halfStorage(initial.size());
+   for (size_t i = 0; i < initial.size(); ++i) {
+      halfStorage[i] = initial[i];
+   }
+
+   const std::vector<BFloat16> halfInitial(halfStorage);
+   run(singleStorage, steps);
+   run(halfStorage, steps);
+
+   // The runs above are the warm-up for the timing. The timed runs start
+   // from the initial state and alternate between the storage types, the
+   // best time of each is reported.
+   double singleTime = 0.0, halfTime = 0.0;
+   for (int r = 0; r < TIMING_REPEATS; ++r) {
+      std::vector<float> single(initial);
+      std::vector<BFloat16> half(halfInitial);
+      const double s = run(single, steps);
+      const double h = run(half, steps);
+      singleTime = (r == 0 || s < singleTime) ? s : singleTime;
+      halfTime = (r == 0 || h < halfTime) ? h : halfTime;
+   }
+
+   printf("%d steps of %d cells, shift %g cells per step\n", steps, CELLS, SHIFT);
+   printf("%4s %14s %14s %14s %14s %14s\n", "lane", "dmass float", "dmass bf16", "L1 bf16-float", "Linf bf16-float", "L1 float-init");
+   for (int i = 0; i < VECL; ++i) {
+      const double initialMass = mass(initial, i);
+      double l1 = 0.0, linf = 0.0, l1Initial = 0.0, fmax = 0.0;
+      for (int k = 0; k < CELLS + 2 * BOUNDARY; ++k) {
+         const double s = singleStorage[k * VECL + i];
+         const double d = fabs((double)halfStorage[k * VECL + i] - s);
+         l1 += d;
+         linf = (d > linf) ? d : linf;
+         l1Initial += fabs(s - initial[k * VECL + i]);
+         fmax = (s > fmax) ? s : fmax;
+      }
+      printf("%4d %14.6e %14.6e %14.6e %14.6e %14.6e\n", i,
+             mass(singleStorage, i) / initialMass - 1.0,
+             mass(halfStorage, i) / initialMass - 1.0,
+             l1 / initialMass, linf / fmax, l1Initial / initialMass);
+   }
+   printf("Time per step (best of %d): float %g s, bf16 %g s\n", TIMING_REPEATS, singleTime, halfTime);
+   return 0;
+}
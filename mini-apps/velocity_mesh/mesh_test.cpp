@@ -0,0 +1,126 @@
+/*
+ * This file is part of Vlasiator.
+ * Copyright 2010-2016 Finnish Meteorological Institute
+ *
+ * For details of usage, see the COPYING file and read the "Rules of the Road"
+ * at http://www.physics.helsinki.fi/vlasiator/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+  Tests of the block index bounds of the (non-AMR) velocity mesh.
+
+  The velocity mesh class is also used by MeshDataContainer for the spatial
+  cells, set up with the two-argument initialize() that never sets the mesh
+  ID, and filled with setGrid(globalIDs) using 1-based dccrg cell IDs. The
+  index bounds must not be touched for such a mesh. Build with
+  -fsanitize=address to catch out of bounds accesses.
+*/
+
+#include <stdio.h>
+#include <limits>
+#include <vector>
+#include "definitions.h"
+#include "velocity_mesh_old.h"
+
+static int failures = 0;
+
+static void check(const bool ok, const char* what) {
+   if (!ok) {
+      printf("FAILED: %s\n", what);
+      ++failures;
+   }
+}
+
+static vmesh::MeshParameters meshParameters(const vmesh::LocalID nx, const vmesh::LocalID ny, const vmesh::LocalID nz) {
+   vmesh::MeshParameters params;
+   params.max_velocity_blocks = std::numeric_limits<vmesh::LocalID>::max();
+   params.meshLimits[0] = -1.0; params.meshLimits[1] = 1.0;
+   params.meshLimits[2] = -1.0; params.meshLimits[3] = 1.0;
+   params.meshLimits[4] = -1.0; params.meshLimits[5] = 1.0;
+   params.gridLength[0] = nx;
+   params.gridLength[1] = ny;
+   params.gridLength[2] = nz;
+   params.blockLength[0] = 1;
+   params.blockLength[1] = 1;
+   params.blockLength[2] = 1;
+   params.refLevelMaxAllowed = 0;
+   return params;
+}
+
+/* Spatial mesh as set up by MeshDataContainer::initialize and reallocate.*/
+void testSpatialMesh() {
+   std::vector<vmesh::MeshParameters> meshes;
+   meshes.push_back(meshParameters(4, 3, 2));
+   vmesh::VelocityMesh<uint64_t,unsigned int> mesh;
+   mesh.initialize(0, meshes);
+
+   // dccrg cell IDs start from 1, and AMR children have IDs beyond the base grid
+   std::vector<uint64_t> cells;
+   for (uint64_t c=1; c<=4*3*2; ++c) cells.push_back(c);
+   cells.push_back(1000);
+   mesh.setGrid(cells);
+   mesh.setGrid();
+   check(mesh.size() == cells.size(), "spatial mesh size after setGrid");
+   check(mesh.getLocalID(4*3*2) == 4*3*2-1, "spatial mesh local ID of the last cell");
+
+   unsigned int minIndices[3], maxIndices[3];
+   check(mesh.getBlockIndexBounds(minIndices, maxIndices) == false, "spatial mesh has no block index bounds");
+}
+
+/* Velocity mesh as set up by SpatialCell.*/
+void testVelocityMesh() {
+   std::vector<vmesh::MeshParameters> meshes;
+   meshes.push_back(meshParameters(10, 8, 6));
+   vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID> mesh;
+   mesh.initialize(0);
+   mesh.initialize(0, meshes);
+
+   vmesh::LocalID minIndices[3], maxIndices[3];
+   check(mesh.getBlockIndexBounds(minIndices, maxIndices) == false, "empty velocity mesh has no bounds");
+
+   mesh.push_back(mesh.getGlobalID(0, 2, 3, 4));
+   mesh.push_back(mesh.getGlobalID(0, 7, 1, 5));
+   mesh.push_back(mesh.getGlobalID(0, 5, 7, 0));
+   check(mesh.getBlockIndexBounds(minIndices, maxIndices), "velocity mesh bounds exist");
+   check(minIndices[0] == 2 && minIndices[1] == 1 && minIndices[2] == 0, "velocity mesh minimum indices");
+   check(maxIndices[0] == 7 && maxIndices[1] == 7 && maxIndices[2] == 5, "velocity mesh maximum indices");
+
+   // Removing the last block moves the bounds inwards
+   mesh.pop();
+   mesh.getBlockIndexBounds(minIndices, maxIndices);
+   check(minIndices[2] == 4 && maxIndices[1] == 3, "velocity mesh bounds after pop");
+
+   // Rebuilding the mesh from a block list, as after an MPI transfer
+   std::vector<vmesh::GlobalID> blocks;
+   blocks.push_back(mesh.getGlobalID(0, 9, 0, 2));
+   blocks.push_back(mesh.getGlobalID(0, 0, 7, 3));
+   mesh.setGrid(blocks);
+   mesh.getBlockIndexBounds(minIndices, maxIndices);
+   check(minIndices[0] == 0 && maxIndices[0] == 9, "velocity mesh x bounds after setGrid");
+   check(minIndices[1] == 0 && maxIndices[1] == 7, "velocity mesh y bounds after setGrid");
+   check(minIndices[2] == 2 && maxIndices[2] == 3, "velocity mesh z bounds after setGrid");
+
+   mesh.clear();
+   check(mesh.getBlockIndexBounds(minIndices, maxIndices) == false, "cleared velocity mesh has no bounds");
+}
+
+int main(void) {
+   testSpatialMesh();
+   testVelocityMesh();
+   if (failures == 0) printf("All velocity mesh tests PASSED\n");
+   return failures == 0 ? 0 : 1;
+}
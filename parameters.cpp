@@ -85,9 +85,13 @@ vector<pair<string, string>> P::systemWriteHints;
 Real P::saveRestartWalltimeInterval = -1.0;
 uint P::exitAfterRestarts = numeric_limits<uint>::max();
 uint64_t P::vlsvBufferSize = 0;
+uint64_t P::reducerBufferSize = 268435456;
+bool P::writeAsync = false;
+uint64_t P::asyncWriteBufferSize = 1073741824;
 int P::restartStripeFactor = -1;
 int P::bulkStripeFactor = -1;
 string P::restartWritePath = string("");
+string P::bgFieldCachePath = string("");
 
 uint P::transmit = 0;
 
@@ -100,6 +104,9 @@ bool P::dynamicTimestep = true;
 
 uint P::maxFieldSolverSubcycles = 0.0;
 int P::maxSlAccelerationSubcycles = 0.0;
+bool P::overlapTranslationHalo = false;
+uint P::accelerationSplitThreshold = 0;
+bool P::localAccelerationSubcycling = false;
 Real P::electronTemperature = 0.0;
 Real P::electronDensity = 0.0;
 Real P::electronPTindex = 1.0;
@@ -111,6 +118,8 @@ int P::writeRestartAsFloat = false;
 string P::loadBalanceAlgorithm = string("");
 string P::loadBalanceTolerance = string("");
 uint P::rebalanceInterval = numeric_limits<uint>::max();
+Real P::loadBalanceMeasuredCostWeight = 0.0;
+Real P::loadBalanceTransferBudget = 1024.0;
 
 vector<string> P::outputVariableList;
 vector<string> P::diagnosticVariableList;
@@ -127,16 +136,16 @@ Real P::bailout_max_memory = 1073741824.;
 uint P::bailout_velocity_space_wall_margin = 0;
 
 uint P::amrMaxVelocityRefLevel = 0;
-Realf P::amrRefineLimit = 1.0;
-Realf P::amrCoarsenLimit = 0.5;
+Real P::amrRefineLimit = 1.0;
+Real P::amrCoarsenLimit = 0.5;
 string P::amrVelRefCriterion = string("");
 uint P::amrMaxSpatialRefLevel = 0;
 uint P::amrBoxHalfWidthX = 1;
 uint P::amrBoxHalfWidthY = 1;
 uint P::amrBoxHalfWidthZ = 1;
-Realf P::amrBoxCenterX = 0.0;
-Realf P::amrBoxCenterY = 0.0;
-Realf P::amrBoxCenterZ = 0.0;
+Real P::amrBoxCenterX = 0.0;
+Real P::amrBoxCenterY = 0.0;
+Real P::amrBoxCenterZ = 0.0;
 vector<string> P::blurPassString;
 vector<int> P::numPasses;
 
@@ -205,6 +214,15 @@ bool P::addParameters() {
            numeric_limits<uint>::max());
    RP::add("io.vlsv_buffer_size",
            "Buffer size passed to VLSV writer (bytes, up to uint64_t), default 0 as this is sensible on sisu", 0);
+   RP::add("io.reducer_buffer_size",
+           "Buffer size for data reducers evaluated together in one threaded pass over the cells (bytes, up to uint64_t). "
+           "At least one reducer is always evaluated at a time. The buffer is only allocated while a file is written.", 268435456);
+   RP::add("io.write_async",
+           "If true, variables of bulk files are appended to the file in a background thread while the simulation "
+           "continues. Needs a build with -DASYNC_IO and an MPI library providing MPI_THREAD_MULTIPLE.", false);
+   RP::add("io.async_write_buffer_size",
+           "Maximum size of variables staged per process for the background writer (bytes, up to uint64_t). "
+           "Variables beyond this are written synchronously.", 1073741824);
    RP::add("io.write_restart_stripe_factor", "Stripe factor for restart writing.", -1);
    RP::add("io.write_bulk_stripe_factor", "Stripe factor for bulk file and initial grid writing.", -1);
    RP::add("io.write_as_float", "If true, write in floats instead of doubles", false);
@@ -212,6 +230,10 @@ bool P::addParameters() {
            "Path to the location where restart files should be written. Defaults to the local directory, also if the "
            "specified destination is not writeable.",
            string("./"));
+   RP::add("io.background_field_cache_path",
+           "Directory where the computed background field is cached, keyed by the field parameters and the "
+           "local grid geometry of each process. Disabled if empty.",
+           string(""));
 
    RP::add("propagate_field", "Propagate magnetic field during the simulation", true);
    RP::add("propagate_vlasov_acceleration",
@@ -287,6 +309,19 @@ bool P::addParameters() {
    RP::add("vlasovsolver.maxSlAccelerationRotation",
            "Maximum rotation angle (degrees) allowed by the Semi-Lagrangian solver (Use >25 values with care)", 25.0);
    RP::add("vlasovsolver.maxSlAccelerationSubcycles", "Maximum number of subcycles for acceleration", 1);
+   RP::add("vlasovsolver.overlapTranslationHalo",
+           "Translate velocity blocks that do not exist on the process boundary while the stencil data transfer is "
+           "in flight (no AMR).",
+           false);
+   RP::add("vlasovsolver.accelerationSplitThreshold",
+           "Cells with more velocity blocks than this are accelerated by all threads together, mapping their block "
+           "column sets as OpenMP tasks. 0 uses 8 times the average block count of the accelerated cells.",
+           0);
+   RP::add("vlasovsolver.localAccelerationSubcycling",
+           "Run all acceleration subcycles of a cell in one go, adding velocity blocks without neighbor data "
+           "between subcycles. Empty blocks are kept until the one neighbor-aware block adjustment after the last "
+           "subcycle.",
+           false);
    RP::add("vlasovsolver.maxCFL",
            "The maximum CFL limit for vlasov propagation in ordinary space. Used to set timestep if dynamic_timestep "
            "is true.",
@@ -300,6 +335,15 @@ bool P::addParameters() {
    RP::add("loadBalance.algorithm", "Load balancing algorithm to be used", string("RCB"));
    RP::add("loadBalance.tolerance", "Load imbalance tolerance", string("1.05"));
    RP::add("loadBalance.rebalanceInterval", "Load rebalance interval (steps)", 10);
+   RP::add("loadBalance.transferMemoryBudget",
+           "Memory budget (MiB) per process for the velocity block data received in one batch when the load is "
+           "balanced. Cells are sent in as many batches as needed to keep every receiving process within the "
+           "budget, a cell larger than the budget is sent in a batch of its own.",
+           1024.0);
+   RP::add("loadBalance.measuredCostWeight",
+           "Weight (0..1) of the measured per-cell compute time of acceleration, translation and boundary "
+           "conditions in the load balancing cell weights. The rest of the weight comes from block counts.",
+           0.0);
 
    // Output variable parameters
    // NOTE Do not remove the : before the list of variable names as this is parsed by tools/check_vlasiator_cfg.sh
@@ -409,9 +453,13 @@ void Parameters::getParameters() {
    RP::get("io.restart_walltime_interval", P::saveRestartWalltimeInterval);
    RP::get("io.number_of_restarts", P::exitAfterRestarts);
    RP::get("io.vlsv_buffer_size", P::vlsvBufferSize);
+   RP::get("io.reducer_buffer_size", P::reducerBufferSize);
+   RP::get("io.write_async", P::writeAsync);
+   RP::get("io.async_write_buffer_size", P::asyncWriteBufferSize);
    RP::get("io.write_restart_stripe_factor", P::restartStripeFactor);
    RP::get("io.write_bulk_stripe_factor", P::bulkStripeFactor);
    RP::get("io.restart_write_path", P::restartWritePath);
+   RP::get("io.background_field_cache_path", P::bgFieldCachePath);
    RP::get("io.write_as_float", P::writeAsFloat);
 
    // Checks for validity of io and restart parameters
@@ -678,6 +726,9 @@ void Parameters::getParameters() {
    // Get Vlasov solver parameters
    RP::get("vlasovsolver.maxSlAccelerationRotation", P::maxSlAccelerationRotation);
    RP::get("vlasovsolver.maxSlAccelerationSubcycles", P::maxSlAccelerationSubcycles);
+   RP::get("vlasovsolver.overlapTranslationHalo", P::overlapTranslationHalo);
+   RP::get("vlasovsolver.accelerationSplitThreshold", P::accelerationSplitThreshold);
+   RP::get("vlasovsolver.localAccelerationSubcycling", P::localAccelerationSubcycling);
    RP::get("vlasovsolver.maxCFL", P::vlasovSolverMaxCFL);
    RP::get("vlasovsolver.minCFL", P::vlasovSolverMinCFL);
 
@@ -685,6 +736,20 @@ void Parameters::getParameters() {
    RP::get("loadBalance.algorithm", P::loadBalanceAlgorithm);
    RP::get("loadBalance.tolerance", P::loadBalanceTolerance);
    RP::get("loadBalance.rebalanceInterval", P::rebalanceInterval);
+   RP::get("loadBalance.transferMemoryBudget", P::loadBalanceTransferBudget);
+   if (P::loadBalanceTransferBudget <= 0.0) {
+      if (myRank == MASTER_RANK) {
+         cerr << "ERROR loadBalance.transferMemoryBudget should be positive." << endl;
+      }
+      MPI_Abort(MPI_COMM_WORLD, 1);
+   }
+   RP::get("loadBalance.measuredCostWeight", P::loadBalanceMeasuredCostWeight);
+   if (P::loadBalanceMeasuredCostWeight < 0.0 || P::loadBalanceMeasuredCostWeight > 1.0) {
+      if (myRank == MASTER_RANK) {
+         cerr << "ERROR loadBalance.measuredCostWeight should be between 0 and 1." << endl;
+      }
+      MPI_Abort(MPI_COMM_WORLD, 1);
+   }
 
    // Get output variable parameters
    RP::get("variables.output", P::outputVariableList);
@@ -114,10 +114,14 @@ struct Parameters {
    static Real saveRestartWalltimeInterval; /*!< Interval in walltime seconds for restart data*/
    static uint exitAfterRestarts;           /*!< Exit after this many restarts*/
    static uint64_t vlsvBufferSize;          /*!< Buffer size in bytes passed to VLSV writer. */
+   static uint64_t reducerBufferSize;       /*!< Size in bytes of the buffer of data reducers evaluated together. */
+   static bool writeAsync;                  /*!< If true, variables of bulk files are written in a background thread. */
+   static uint64_t asyncWriteBufferSize;    /*!< Maximum size in bytes of variables staged per process for the background writer. */
    static int restartStripeFactor;          /*!< stripe_factor for restart writing*/
    static int bulkStripeFactor;             /*!< stripe_factor for bulk and initial grid writing*/
    static std::string restartWritePath; /*!< Path to the location where restart files should be written. Defaults to the
                                            local directory, also if the specified destination is not writeable. */
+   static std::string bgFieldCachePath; /*!< Directory of the background field cache, disabled if empty. */
 
    static uint transmit;
    /*!< Indicates the data that needs to be transmitted to remote nodes.
@@ -141,6 +145,12 @@ struct Parameters {
 
    static Real maxSlAccelerationRotation; /*!< Maximum rotation in acceleration for semilagrangian solver*/
    static int maxSlAccelerationSubcycles; /*!< Maximum number of subcycles in acceleration*/
+   static bool overlapTranslationHalo; /*!< If true, translate velocity blocks not present on the process boundary
+                                          while the stencil data transfer is in flight.*/
+   static uint accelerationSplitThreshold; /*!< Cells with more velocity blocks than this are accelerated with their
+                                              block column sets split into OpenMP tasks, 0 for automatic.*/
+   static bool localAccelerationSubcycling; /*!< If true, cells are subcycled to completion with local block adjustments
+                                               only, followed by one neighbor-aware adjustment.*/
 
    static Real hallMinimumRhom; /*!< Minimum mass density value used in the field solver.*/
    static Real hallMinimumRhoq; /*!< Minimum charge density value used for the Hall and electron pressure gradient terms
@@ -149,6 +159,10 @@ struct Parameters {
    static std::string loadBalanceAlgorithm; /*!< Algorithm to be used for load balance.*/
    static std::string loadBalanceTolerance; /*!< Load imbalance tolerance. */
    static uint rebalanceInterval;           /*!< Load rebalance interval (steps). */
+   static Real loadBalanceTransferBudget;   /*!< Memory budget (MiB) per process for velocity block data received
+                                                 in one batch when the load is balanced. */
+   static Real loadBalanceMeasuredCostWeight; /*!< Weight of the measured compute time against the block count
+                                                   based counter in the load balancing cell weights (0..1). */
    static bool prepareForRebalance; /**< If true, propagators should measure their time consumption in preparation
                                      * for mesh repartitioning.*/
 
@@ -173,18 +187,18 @@ struct Parameters {
    static uint bailout_velocity_space_wall_margin; /*!< Safety margin in number of blocks off the v-space wall beyond which bailout occurs. */
 
    static uint amrMaxVelocityRefLevel; /**< Maximum velocity mesh refinement level, defaults to 0.*/
-   static Realf amrCoarsenLimit; /**< If the value of refinement criterion is below this value, block can be coarsened.
-                                  * The value must be smaller than amrRefineLimit.*/
-   static Realf amrRefineLimit;  /**< If the value of refinement criterion is larger than this value, block should be
-                                  * refined.  The value must be larger than amrCoarsenLimit.*/
+   static Real amrCoarsenLimit; /**< If the value of refinement criterion is below this value, block can be coarsened.
+                                 * The value must be smaller than amrRefineLimit.*/
+   static Real amrRefineLimit;  /**< If the value of refinement criterion is larger than this value, block should be
+                                 * refined.  The value must be larger than amrCoarsenLimit.*/
    static std::string amrVelRefCriterion; /**< Name of the velocity block refinement criterion function.*/
    static uint amrMaxSpatialRefLevel;
    static uint amrBoxHalfWidthX;
    static uint amrBoxHalfWidthY;
    static uint amrBoxHalfWidthZ;
-   static Realf amrBoxCenterX;
-   static Realf amrBoxCenterY;
-   static Realf amrBoxCenterZ;
+   static Real amrBoxCenterX;
+   static Real amrBoxCenterY;
+   static Real amrBoxCenterZ;
 
    static bool amrTransShortPencils;        /*!< Use short or longpencils in AMR translation.*/
    static std::vector<std::string> blurPassString;
@@ -27,6 +27,7 @@
 #include <iostream>
 #include <random>
 #include <string.h>
+#include <algorithm>
 #include "particles.h"
 #include "field.h"
 #include "physconst.h"
@@ -100,6 +101,9 @@ int main(int argc, char** argv) {
    std::cerr << "Pushing " << particles.size() << " particles for " << maxsteps << " steps..." << std::endl;
    std::cerr << "[                                                                        ]\x0d[";
 
+   // Reads the next input file in the background while particles are pushed
+   FieldPrefetcher<vlsvinterface::Reader> prefetcher;
+
    /* Push them around */
    for(int step=0; step<maxsteps; step++) {
 
@@ -107,10 +111,10 @@ int main(int argc, char** argv) {
       /* Load newer fields, if neccessary */
       if(step >= 0) {
          newfile = readNextTimestep(filename_pattern, ParticleParameters::start_time + step*dt, 1,E[0], E[1],
-               B[0], B[1], V, scenario->needV, input_file_counter);
+               B[0], B[1], V, scenario->needV, input_file_counter, &prefetcher);
       } else {
          newfile = readNextTimestep(filename_pattern, ParticleParameters::start_time + step*dt, -1,E[1], E[0],
-               B[1], B[0], V, scenario->needV, input_file_counter);
+               B[1], B[0], V, scenario->needV, input_file_counter, &prefetcher);
       }
 
       Interpolated_Field cur_E(E[0],E[1],ParticleParameters::start_time + step*dt);
@@ -123,52 +127,73 @@ int main(int argc, char** argv) {
 
       scenario->beforePush(particles,cur_E,cur_B,V);
 
-#pragma omp parallel for
-      for(unsigned int i=0; i< particles.size(); i++) {
-
-         if(isnan(vector_length(particles[i].x))) {
-            // Skip disabled particles.
-            continue;
+      // Particles are pushed in batches: field values are interpolated per particle
+      // into small component arrays, then the Boris push runs vectorised over the
+      // whole batch. Boundaries are allowed to mangle the particles right after
+      // their push; if they return false, particles get removed afterwards.
+      const size_t batchSize = 64;
+      const size_t nParticles = particles.size();
+      const size_t nBatches = (nParticles + batchSize - 1) / batchSize;
+      std::vector<char> keep(nParticles);
+
+#pragma omp parallel
+      {
+         double Ebuf[3][batchSize], Bbuf[3][batchSize];
+         const double* const Eptr[3] = {Ebuf[0], Ebuf[1], Ebuf[2]};
+         const double* const Bptr[3] = {Bbuf[0], Bbuf[1], Bbuf[2]};
+
+#pragma omp for schedule(dynamic)
+         for(size_t batch=0; batch < nBatches; batch++) {
+            const size_t begin = batch*batchSize;
+            const size_t n = std::min(batchSize, nParticles - begin);
+
+            /* Get E- and B-Field at their position */
+            for(size_t i=0; i<n; i++) {
+               if(particles.isDisabled(begin+i)) {
+                  // Disabled particles have zero velocity, so a zero field leaves them be.
+                  for(int c=0; c<3; c++) {
+                     Ebuf[c][i] = Bbuf[c][i] = 0;
+                  }
+                  continue;
+               }
+
+               Vec3d x = particles.getX(begin+i);
+               Vec3d Eval = cur_E(x);
+               Vec3d Bval = cur_B(x);
+
+               if(dt < 0) {
+                 // If propagating backwards in time, flip B-field pseudovector
+                 Bval *= -1;
+               }
+               for(int c=0; c<3; c++) {
+                  Ebuf[c][i] = Eval[c];
+                  Bbuf[c][i] = Bval[c];
+               }
+            }
+
+            /* Push them around */
+            pushParticles(particles, begin, n, Eptr, Bptr, dt);
+
+            for(size_t i=0; i<n; i++) {
+               Particle p = particles.get(begin+i);
+               bool keep_particle = true;
+               if(!ParticleParameters::boundary_behaviour_x->handleParticle(p)) {
+                  keep_particle = false;
+               }
+               if(!ParticleParameters::boundary_behaviour_y->handleParticle(p)) {
+                  keep_particle = false;
+               }
+               if(!ParticleParameters::boundary_behaviour_z->handleParticle(p)) {
+                  keep_particle = false;
+               }
+               particles.set(begin+i, p);
+               keep[begin+i] = keep_particle;
+            }
          }
-
-         /* Get E- and B-Field at their position */
-         Vec3d Eval,Bval;
-
-         Eval = cur_E(particles[i].x);
-         Bval = cur_B(particles[i].x);
-
-         if(dt < 0) {
-           // If propagating backwards in time, flip B-field pseudovector
-           Bval *= -1;
-         }
-
-         /* Push them around */
-         particles[i].push(Bval,Eval,dt);
-
       }
 
       // Remove all particles that have left the simulation box after this step
-      // (unfortunately, this can not be done in parallel, so it better be fast!)
-      for(auto i = particles.begin(); i != particles.end(); ) {
-
-         // Boundaries are allowed to mangle the particles here.
-         // If they return false, particles are deleted.
-         bool do_erase = false;
-         if(!ParticleParameters::boundary_behaviour_x->handleParticle(*i)) {
-            do_erase = true;
-         }
-         if(!ParticleParameters::boundary_behaviour_y->handleParticle(*i)) {
-            do_erase = true;
-         }
-         if(!ParticleParameters::boundary_behaviour_z->handleParticle(*i)) {
-            do_erase = true;
-         }
-         if(do_erase) {
-            particles.erase(i);
-         } else {
-            i++;
-         }
-      }
+      particles.compact(keep);
 
       scenario->afterPush(step, step*dt, particles, cur_E, cur_B, V);
 
@@ -178,6 +203,7 @@ int main(int argc, char** argv) {
       }
    }
 
+   prefetcher.wait();
    scenario->finalize(particles,E[1],B[1],V);
 
    std::cerr << std::endl;
@@ -20,6 +20,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 #include <vector>
+#include <algorithm>
+#include <limits>
 #include "particles.h"
 #include "physconst.h"
 #include "relativistic_math.h"
@@ -42,6 +44,142 @@ void Particle::push(Vec3d& B, Vec3d& E, double dt) {
    x += dt * v;
 }
 
+void ParticleContainer::push_back(const Particle& p) {
+   for(int c=0; c<3; c++) {
+      x[c].push_back(p.x[c]);
+      v[c].push_back(p.v[c]);
+   }
+   m.push_back(p.m);
+   q.push_back(p.q);
+}
+
+void ParticleContainer::reserve(size_t n) {
+   for(int c=0; c<3; c++) {
+      x[c].reserve(n);
+      v[c].reserve(n);
+   }
+   m.reserve(n);
+   q.reserve(n);
+}
+
+void ParticleContainer::disable(size_t i) {
+   x[0][i] = std::numeric_limits<double>::quiet_NaN();
+   x[1][i] = 0;
+   x[2][i] = 0;
+   v[0][i] = 0;
+   v[1][i] = 0;
+   v[2][i] = 0;
+}
+
+/* Stable stream compaction: every chunk counts its survivors, an exclusive scan
+ * over the chunk counts gives each chunk its output offset, and the chunks are
+ * then scattered into a fresh container independently of each other. */
+void ParticleContainer::compact(const std::vector<char>& keep) {
+   const size_t n = size();
+   const size_t nChunks = 64;
+   const size_t chunkSize = (n + nChunks - 1) / nChunks;
+   std::vector<size_t> offset(nChunks+1, 0);
+
+   #pragma omp parallel for
+   for(size_t chunk=0; chunk<nChunks; chunk++) {
+      const size_t begin = std::min(n, chunk*chunkSize);
+      const size_t end = std::min(n, begin+chunkSize);
+      size_t count = 0;
+      for(size_t i=begin; i<end; i++) {
+         count += keep[i] ? 1 : 0;
+      }
+      offset[chunk+1] = count;
+   }
+   for(size_t chunk=0; chunk<nChunks; chunk++) {
+      offset[chunk+1] += offset[chunk];
+   }
+   const size_t newSize = offset[nChunks];
+   if(newSize == n) {
+      return;
+   }
+
+   ParticleContainer out;
+   for(int c=0; c<3; c++) {
+      out.x[c].resize(newSize);
+      out.v[c].resize(newSize);
+   }
+   out.m.resize(newSize);
+   out.q.resize(newSize);
+
+   #pragma omp parallel for
+   for(size_t chunk=0; chunk<nChunks; chunk++) {
+      const size_t begin = std::min(n, chunk*chunkSize);
+      const size_t end = std::min(n, begin+chunkSize);
+      size_t j = offset[chunk];
+      for(size_t i=begin; i<end; i++) {
+         if(!keep[i]) {
+            continue;
+         }
+         for(int c=0; c<3; c++) {
+            out.x[c][j] = x[c][i];
+            out.v[c][j] = v[c][i];
+         }
+         out.m[j] = m[i];
+         out.q[j] = q[i];
+         j++;
+      }
+   }
+
+   std::swap(*this, out);
+}
+
+/* Structure-of-arrays version of Particle::push, vectorised across particles. */
+void pushParticles(ParticleContainer& p, size_t begin, size_t n,
+      const double* const Efield[3], const double* const Bfield[3], double dt) {
+
+   double* __restrict__ xx = p.x[0].data() + begin;
+   double* __restrict__ xy = p.x[1].data() + begin;
+   double* __restrict__ xz = p.x[2].data() + begin;
+   double* __restrict__ vx = p.v[0].data() + begin;
+   double* __restrict__ vy = p.v[1].data() + begin;
+   double* __restrict__ vz = p.v[2].data() + begin;
+   const Real* __restrict__ m = p.m.data() + begin;
+   const Real* __restrict__ q = p.q.data() + begin;
+   const double* __restrict__ Ex = Efield[0];
+   const double* __restrict__ Ey = Efield[1];
+   const double* __restrict__ Ez = Efield[2];
+   const double* __restrict__ Bx = Bfield[0];
+   const double* __restrict__ By = Bfield[1];
+   const double* __restrict__ Bz = Bfield[2];
+   const double c2 = PhysicalConstantsSI::c * PhysicalConstantsSI::c;
+
+   #pragma omp simd
+   for(size_t i=0; i<n; i++) {
+      const double qdt2m = (q[i] * dt) / (2. * m[i]);
+
+      const double umx = vx[i] + qdt2m * Ex[i];
+      const double umy = vy[i] + qdt2m * Ey[i];
+      const double umz = vz[i] + qdt2m * Ez[i];
+
+      const double g = sqrt(1. + (umx*umx + umy*umy + umz*umz) / c2);
+      double hx = qdt2m * Bx[i] / g;
+      double hy = qdt2m * By[i] / g;
+      double hz = qdt2m * Bz[i] / g;
+
+      const double upx = umx + (umy*hz - umz*hy);
+      const double upy = umy + (umz*hx - umx*hz);
+      const double upz = umz + (umx*hy - umy*hx);
+
+      const double s = 2. / (1. + hx*hx + hy*hy + hz*hz);
+      hx *= s;
+      hy *= s;
+      hz *= s;
+
+      vx[i] = umx + (upy*hz - upz*hy) + qdt2m * Ex[i];
+      vy[i] = umy + (upz*hx - upx*hz) + qdt2m * Ey[i];
+      vz[i] = umz + (upx*hy - upy*hx) + qdt2m * Ez[i];
+
+      xx[i] += dt * vx[i];
+      xy[i] += dt * vy[i];
+      xz[i] += dt * vz[i];
+   }
+}
+
 void writeParticles(ParticleContainer& p,const char* filename) {
 
    vlsv::Writer vlsvWriter;
@@ -52,11 +190,11 @@ void writeParticles(ParticleContainer& p,const char* filename) {
    /* First, store particle positions */
    uint writable_particles=0;
    for(unsigned int i=0; i < p.size(); i++) {
-      if(vector_length(p[i].x) == 0) {
+      if(vector_length(p.getX(i)) == 0) {
         continue;
       }
 
-      p[i].x.store(&(writebuf[3*writable_particles]));
+      p.getX(i).store(&(writebuf[3*writable_particles]));
       writable_particles++;
    }
 
@@ -70,10 +208,10 @@ void writeParticles(ParticleContainer& p,const char* filename) {
    /* Then, velocities */
    writable_particles=0;
    for(unsigned int i=0; i < p.size(); i++) {
-      if(vector_length(p[i].x) == 0) {
+      if(vector_length(p.getX(i)) == 0) {
         continue;
       }
-      p[i].v.store(&(writebuf[3*writable_particles]));
+      p.getV(i).store(&(writebuf[3*writable_particles]));
       writable_particles++;
    }
 
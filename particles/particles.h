@@ -21,6 +21,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 #include <vector>
+#include <cmath>
 #include "vectorclass.h"
 #include "vector3d.h"
 #include "../definitions.h"
@@ -41,7 +42,45 @@ struct Particle {
       void push(Vec3d& B, Vec3d& E, double dt);
 };
 
-typedef std::vector<Particle, aligned_allocator<Particle, 32>> ParticleContainer;
+/* Particle storage as a structure of arrays, so that the pusher can
+ * stream through each component with SIMD instructions. Individual
+ * particles are read and written by value through get()/set().
+ * Disabled particles have a NaN position. */
+struct ParticleContainer {
+      std::vector<double> x[3];
+      std::vector<double> v[3];
+      std::vector<Real> m;
+      std::vector<Real> q;
+
+      size_t size() const { return m.size(); }
+      bool empty() const { return m.empty(); }
+      void push_back(const Particle& p);
+      void reserve(size_t n);
+
+      Vec3d getX(size_t i) const { return Vec3d(x[0][i], x[1][i], x[2][i]); }
+      Vec3d getV(size_t i) const { return Vec3d(v[0][i], v[1][i], v[2][i]); }
+      void setX(size_t i, const Vec3d& pos) {
+         x[0][i] = pos[0]; x[1][i] = pos[1]; x[2][i] = pos[2];
+      }
+      void setV(size_t i, const Vec3d& vel) {
+         v[0][i] = vel[0]; v[1][i] = vel[1]; v[2][i] = vel[2];
+      }
+      Particle get(size_t i) const { return Particle(m[i], q[i], getX(i), getV(i)); }
+      void set(size_t i, const Particle& p) { setX(i, p.x); setV(i, p.v); m[i] = p.m; q[i] = p.q; }
+
+      bool isDisabled(size_t i) const { return std::isnan(x[0][i] + x[1][i] + x[2][i]); }
+      /* Mark a particle as disabled: it keeps its slot but is no longer pushed. */
+      void disable(size_t i);
+
+      /* Remove all particles whose keep flag is zero, preserving the order of the
+       * remaining ones. Runs threaded if called outside of a parallel region. */
+      void compact(const std::vector<char>& keep);
+};
+
+/* Boris push of the n particles starting at index begin, given the E- and
+ * B-field components at their locations (Efield[c][i] for particle begin+i). */
+void pushParticles(ParticleContainer& p, size_t begin, size_t n,
+      const double* const Efield[3], const double* const Bfield[3], double dt);
 
 void writeParticles(ParticleContainer& p, const char* filename);
 
@@ -30,6 +30,8 @@
 #include <string>
 #include <set>
 #include <cstring>
+#include <limits>
+#include <thread>
 
 #define DEBUG
 
@@ -249,132 +251,224 @@ std::vector<double> readFsGridData(Reader& r, std::string& name, unsigned int nu
    return buffer;
 }
 
-/* Read the next logical input file. Depending on sign of dt,
- * this may be a numerically larger or smaller file.
- * Return value: true if a new file was read, otherwise false.
- * TODO: might need some DRY
+/* Read the field data of input file number file_index into E, B (and V, if
+ * doV is set). The fields need to already have the right size.
+ * Return value: false if the file could not be opened.
  */
 template <class Reader>
-bool readNextTimestep(const std::string& filename_pattern, double t, int step, Field& E0, Field& E1,
-      Field& B0, Field& B1, Field& V, bool doV, int& input_file_counter) {
+bool readTimestepFile(const std::string& filename_pattern, int file_index, Field& E, Field& B, Field& V, bool doV) {
 
    char filename_buffer[256];
-   bool retval = false;
+   snprintf(filename_buffer,256,filename_pattern.c_str(),file_index);
 
-   while(t < E0.time || t>= E1.time) {
-      input_file_counter += step;
+   Reader r;
+   if(!r.open(filename_buffer)) {
+      return false;
+   }
+   double t;
+   if(!r.readParameter("time",t)) {
+      if(!r.readParameter("t",t)) {
+         std::cerr << "Time parameter in file " << filename_buffer << " is neither 't' nor 'time'. Bad file format?"
+            << std::endl;
+         exit(1);
+      }
+   }
 
-      E0=E1;
-      B0=B1;
-      snprintf(filename_buffer,256,filename_pattern.c_str(),input_file_counter);
-
-      /* Open next file */
-      Reader r;
-      r.open(filename_buffer);
-      double t;
-      if(!r.readParameter("time",t)) {
-         if(!r.readParameter("t",t)) {
-            std::cerr << "Time parameter in file " << filename_buffer << " is neither 't' nor 'time'. Bad file format?"
-               << std::endl;
-            exit(1);
+   E.time = t;
+   B.time = t;
+
+   uint64_t cells[3];
+   r.readParameter("xcells_ini",cells[0]);
+   r.readParameter("ycells_ini",cells[1]);
+   r.readParameter("zcells_ini",cells[2]);
+
+   /* Read CellIDs and Field data */
+   std::vector<uint64_t> cellIds = readCellIds(r);
+   std::string name(B_field_name);
+   std::vector<double> Bbuffer;
+   std::vector<double> Ebuffer;
+   if (B_field_name == "fg_b" || B_field_name == "fg_b_background") {
+      Bbuffer = readFsGridData(r,name,3u);
+      if (B_field_name == "fg_b_background") {
+         name = "fg_b_perturbed";
+         std::vector<double> perturbedBbuffer = readFsGridData(r,name,3u);
+         for (int i = 0; i < Bbuffer.size(); ++i) {
+            Bbuffer[i] += perturbedBbuffer[i];
+         }
+      }
+      name = E_field_name;
+      Ebuffer = readFsGridData(r,name,3u);
+      for (int i = 0; i < cellIds.size(); ++i) {
+         cellIds[i] = i+1;
+      }
+   } else {
+      Bbuffer = readFieldData(r,name,3u);
+      if (B_field_name == "vg_b_background_vol") {
+         name = "vg_b_perturbed_vol";
+         std::vector<double> perturbedBbuffer = readFieldData(r,name,3u);
+         for (int i = 0; i < Bbuffer.size(); ++i) {
+            Bbuffer[i] += perturbedBbuffer[i];
          }
       }
+      name = E_field_name;
+      Ebuffer = readFieldData(r,name,3u);
+   }
+   std::vector<double> Vbuffer;
+   if(doV) {
+     name = ParticleParameters::V_field_name;
+     std::vector<double> rho_v_buffer = readFieldData(r,name,3u);
+     if(ParticleParameters::divide_rhov_by_rho) {
+       name = ParticleParameters::rho_field_name;
+       std::vector<double> rho_buffer = readFieldData(r,name,1u);
+       for(unsigned int i=0; i<rho_buffer.size(); i++) {
+         Vbuffer.push_back(rho_v_buffer[3*i] / rho_buffer[i]);
+         Vbuffer.push_back(rho_v_buffer[3*i+1] / rho_buffer[i]);
+         Vbuffer.push_back(rho_v_buffer[3*i+2] / rho_buffer[i]);
+       }
+     }
+   }
 
-      E1.time = t;
-      B1.time = t;
-
-      uint64_t cells[3];
-      r.readParameter("xcells_ini",cells[0]);
-      r.readParameter("ycells_ini",cells[1]);
-      r.readParameter("zcells_ini",cells[2]);
-
-      /* Read CellIDs and Field data */
-      std::vector<uint64_t> cellIds = readCellIds(r);
-      std::string name(B_field_name);
-      std::vector<double> Bbuffer;
-      std::vector<double> Ebuffer;
-      if (B_field_name == "fg_b" || B_field_name == "fg_b_background") {
-         Bbuffer = readFsGridData(r,name,3u);
-         if (B_field_name == "fg_b_background") {
-            name = "fg_b_perturbed";
-            std::vector<double> perturbedBbuffer = readFsGridData(r,name,3u);
-            for (int i = 0; i < Bbuffer.size(); ++i) {
-               Bbuffer[i] += perturbedBbuffer[i];
-            }
+   /* Assign them, without sanity checking */
+   /* TODO: Is this actually a good idea? */
+   for(uint i=0; i< cellIds.size(); i++) {
+      uint64_t c = cellIds[i];
+      int64_t x = c % cells[0];
+      int64_t y = (c /cells[0]) % cells[1];
+      int64_t z = c /(cells[0]*cells[1]);
+
+      double* Etgt = E.getCellRef(x,y,z);
+      double* Btgt = B.getCellRef(x,y,z);
+      Etgt[0] = Ebuffer[3*i];
+      Etgt[1] = Ebuffer[3*i+1];
+      Etgt[2] = Ebuffer[3*i+2];
+      Btgt[0] = Bbuffer[3*i];
+      Btgt[1] = Bbuffer[3*i+1];
+      Btgt[2] = Bbuffer[3*i+2];
+
+      if(doV) {
+        double* Vtgt = V.getCellRef(x,y,z);
+        Vtgt[0] = Vbuffer[3*i];
+        Vtgt[1] = Vbuffer[3*i+1];
+        Vtgt[2] = Vbuffer[3*i+2];
+      }
+   }
+
+   r.close();
+   return true;
+}
+
+/* Background loader for the input files: while particles are pushed through
+ * the interval between two files, the following file is already read and
+ * decoded on a separate thread. Together with the two fields being
+ * interpolated between, this gives a triple buffer of fields.
+ */
+template <class Reader>
+class FieldPrefetcher {
+   public:
+      FieldPrefetcher() : file_index(std::numeric_limits<int>::min()), success(false), doV(false) {}
+      ~FieldPrefetcher() {
+         wait();
+      }
+
+      /* Start loading file number index in the background. The current fields
+       * are only used as templates for the size of the buffers. */
+      void start(const std::string& filename_pattern, int index, const Field& E_template,
+            const Field& B_template, const Field& V_template, bool readV) {
+         wait();
+         if(E.data.size() != E_template.data.size()) {
+            E = E_template;
          }
-         name = E_field_name;
-         Ebuffer = readFsGridData(r,name,3u);
-         for (int i = 0; i < cellIds.size(); ++i) {
-            cellIds[i] = i+1;
+         if(B.data.size() != B_template.data.size()) {
+            B = B_template;
          }
-      } else {
-         Bbuffer = readFieldData(r,name,3u);
-         if (B_field_name == "vg_b_background_vol") {
-            name = "vg_b_perturbed_vol";
-            std::vector<double> perturbedBbuffer = readFieldData(r,name,3u);
-            for (int i = 0; i < Bbuffer.size(); ++i) {
-               Bbuffer[i] += perturbedBbuffer[i];
-            }
+         if(readV && V.data.size() != V_template.data.size()) {
+            V = V_template;
          }
-         name = E_field_name;
-         Ebuffer = readFieldData(r,name,3u);
-      }
-      std::vector<double> Vbuffer;
-      if(doV) {
-        name = ParticleParameters::V_field_name;
-        std::vector<double> rho_v_buffer = readFieldData(r,name,3u);
-        if(ParticleParameters::divide_rhov_by_rho) {
-          name = ParticleParameters::rho_field_name;
-          std::vector<double> rho_buffer = readFieldData(r,name,1u);
-          for(unsigned int i=0; i<rho_buffer.size(); i++) {
-            Vbuffer.push_back(rho_v_buffer[3*i] / rho_buffer[i]);
-            Vbuffer.push_back(rho_v_buffer[3*i+1] / rho_buffer[i]);
-            Vbuffer.push_back(rho_v_buffer[3*i+2] / rho_buffer[i]);
-          }
-        }
+         file_index = index;
+         doV = readV;
+         loader = std::thread([this, filename_pattern]() {
+            success = readTimestepFile<Reader>(filename_pattern, file_index, E, B, V, doV);
+         });
       }
 
-      /* Assign them, without sanity checking */
-      /* TODO: Is this actually a good idea? */
-      for(uint i=0; i< cellIds.size(); i++) {
-         uint64_t c = cellIds[i];
-         int64_t x = c % cells[0];
-         int64_t y = (c /cells[0]) % cells[1];
-         int64_t z = c /(cells[0]*cells[1]);
-
-         double* Etgt = E1.getCellRef(x,y,z);
-         double* Btgt = B1.getCellRef(x,y,z);
-         Etgt[0] = Ebuffer[3*i];
-         Etgt[1] = Ebuffer[3*i+1];
-         Etgt[2] = Ebuffer[3*i+2];
-         Btgt[0] = Bbuffer[3*i];
-         Btgt[1] = Bbuffer[3*i+1];
-         Btgt[2] = Bbuffer[3*i+2];
+      /* If file number index has been prefetched, swap its contents into the
+       * given fields. Return value: false if the caller has to read it itself. */
+      bool take(int index, Field& E_out, Field& B_out, Field& V_out) {
+         wait();
+         bool available = (index == file_index) && success;
+         file_index = std::numeric_limits<int>::min();
+         if(!available) {
+            return false;
+         }
 
+         std::swap(E_out.data, E.data);
+         std::swap(B_out.data, B.data);
+         E_out.time = E.time;
+         B_out.time = B.time;
          if(doV) {
-           double* Vtgt = V.getCellRef(x,y,z);
-           Vtgt[0] = Vbuffer[3*i];
-           Vtgt[1] = Vbuffer[3*i+1];
-           Vtgt[2] = Vbuffer[3*i+2];
+            std::swap(V_out.data, V.data);
          }
+         return true;
       }
 
-      r.close();
+      void wait() {
+         if(loader.joinable()) {
+            loader.join();
+         }
+      }
+
+   private:
+      std::thread loader;
+      int file_index; // File currently being loaded, if any
+      bool success;
+      bool doV;
+      Field E, B, V;
+};
+
+/* Read the next logical input file. Depending on sign of dt,
+ * this may be a numerically larger or smaller file.
+ * If a prefetcher is given, the file is taken from it when available, and
+ * the one after it is requested in turn.
+ * Return value: true if a new file was read, otherwise false.
+ */
+template <class Reader>
+bool readNextTimestep(const std::string& filename_pattern, double t, int step, Field& E0, Field& E1,
+      Field& B0, Field& B1, Field& V, bool doV, int& input_file_counter,
+      FieldPrefetcher<Reader>* prefetcher = nullptr) {
+
+   bool retval = false;
+
+   while(t < E0.time || t>= E1.time) {
+      input_file_counter += step;
+
+      E0=E1;
+      B0=B1;
+
+      if(prefetcher == nullptr || !prefetcher->take(input_file_counter, E1, B1, V)) {
+         if(!readTimestepFile<Reader>(filename_pattern, input_file_counter, E1, B1, V, doV)) {
+            char filename_buffer[256];
+            snprintf(filename_buffer,256,filename_pattern.c_str(),input_file_counter);
+            std::cerr << "Could not open input file " << filename_buffer << std::endl;
+            exit(1);
+         }
+      }
       retval = true;
    }
 
+   if(retval && prefetcher != nullptr) {
+      prefetcher->start(filename_pattern, input_file_counter + step, E1, B1, V, doV);
+   }
+
    return retval;
 }
 
 /* Non-template version, autodetecting the reader type */
 static bool readNextTimestep(const std::string& filename_pattern, double t, int step, Field& E0, Field& E1,
-      Field& B0, Field& B1, Field& V, bool doV, int& input_file_counter) {
-
-   char filename_buffer[256];
-   snprintf(filename_buffer,256,filename_pattern.c_str(),input_file_counter);
+      Field& B0, Field& B1, Field& V, bool doV, int& input_file_counter,
+      FieldPrefetcher<vlsvinterface::Reader>* prefetcher = nullptr) {
 
    return readNextTimestep<vlsvinterface::Reader>(filename_pattern, t,
-         step,E0,E1,B0,B1,V,doV,input_file_counter);
+         step,E0,E1,B0,B1,V,doV,input_file_counter,prefetcher);
 }
 
 /* Read E- and B-Fields as well as velocity field from a vlsv file */
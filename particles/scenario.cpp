@@ -39,8 +39,8 @@ ParticleContainer singleParticleScenario::initialParticles(Field& E, Field& B, F
 void singleParticleScenario::afterPush(int step, double time, ParticleContainer& particles, 
       Field& E, Field& B, Field& V) {
 
-   Vec3d& x = particles[0].x;
-   Vec3d& v = particles[0].v;
+   Vec3d x = particles.getX(0);
+   Vec3d v = particles.getV(0);
 
    std::cout << 0 << " " << time << "\t" <<  x[0] << " " << x[1] << " " << x[2] << "\t"
       << v[0] << " " << v[1] << " " << v[2] << std::endl;
@@ -93,34 +93,35 @@ void precipitationScenario::afterPush(int step, double time, ParticleContainer&
 
    for(unsigned int i=0; i<particles.size(); i++) {
 
-      if(isnan(vector_length(particles[i].x))) {
+      if(particles.isDisabled(i)) {
          // skip disabled particles
          continue;
       }
 
+      const Vec3d pos = particles.getX(i);
+      const Vec3d vel = particles.getV(i);
+
       // Check if the particle hit a boundary. If yes, mark it as disabled.
       // Original starting x of this particle
       double start_pos = ParticleParameters::precip_start_x +
          ((double)(i%ParticleParameters::num_particles))/ParticleParameters::num_particles *
           (ParticleParameters::precip_stop_x - ParticleParameters::precip_start_x);
       int start_timestep = i / ParticleParameters::num_particles;
-      if(vector_length(particles[i].x) <= ParticleParameters::precip_inner_boundary) {
+      if(vector_length(pos) <= ParticleParameters::precip_inner_boundary) {
 
          // Record latitude and energy
-         double latitude = atan2(particles[i].x[2],particles[i].x[0]);
-         printf("%u %i %lf %lf %lf\n",i, start_timestep, start_pos, latitude, .5*particles[i].m *
-               dot_product(particles[i].v,particles[i].v)/PhysicalConstantsSI::e);
+         double latitude = atan2(pos[2],pos[0]);
+         printf("%u %i %lf %lf %lf\n",i, start_timestep, start_pos, latitude, .5*particles.m[i] *
+               dot_product(vel,vel)/PhysicalConstantsSI::e);
 
          // Disable by setting position to NaN and velocity to 0
-         particles[i].x = Vec3d(std::numeric_limits<double>::quiet_NaN(),0.,0.);
-         particles[i].v = Vec3d(0,0,0);
-      } else if (particles[i].x[0] <= ParticleParameters::precip_start_x) {
+         particles.disable(i);
+      } else if (pos[0] <= ParticleParameters::precip_start_x) {
 
          // Record marker value for lost particle
          printf("%u %i %lf -5. -1.\n", i, start_timestep, start_pos);
          // Disable by setting position to NaN and velocity to 0
-         particles[i].x = Vec3d(std::numeric_limits<double>::quiet_NaN(),0.,0.);
-         particles[i].v = Vec3d(0,0,0);
+         particles.disable(i);
       }
    }
 }
@@ -184,8 +185,8 @@ void analysatorScenario::newTimestep(int input_file_counter, int step, double ti
       Field& E, Field& B, Field& V) {
 
    for(unsigned int i=0; i< particles.size(); i++) {
-      Vec3d& x = particles[i].x;
-      Vec3d& v = particles[i].v;
+      Vec3d x = particles.getX(i);
+      Vec3d v = particles.getV(i);
       std::cout << i << " " << time << "\t" <<  x[0] << " " << x[1] << " " << x[2] << "\t"
          << v[0] << " " << v[1] << " " << v[2] << std::endl;
    }
@@ -247,13 +248,15 @@ void shockReflectivityScenario::afterPush(int step, double time, ParticleContain
 
    for(unsigned int i=0; i<particles.size(); i++) {
 
-      if(isnan(vector_length(particles[i].x))) {
+      if(particles.isDisabled(i)) {
          // skip disabled particles
          continue;
       }
 
+      const Vec3d pos = particles.getX(i);
+
       //Get particle's y-coordinate
-      double y = particles[i].x[1];
+      double y = pos[1];
 
       // Get x for it's shock boundary (approx)
       double x = y / ParticleParameters::reflect_start_y;
@@ -269,21 +272,19 @@ void shockReflectivityScenario::afterPush(int step, double time, ParticleContain
       // Original starting x of this particle
       int start_timestep = i / 200 / ParticleParameters::num_particles;
       double start_time = ParticleParameters::start_time + start_timestep * ParticleParameters::input_dt;
-      if(particles[i].x[0] < boundary_left) {
+      if(pos[0] < boundary_left) {
          // Record it is transmitted.
          transmitted.addValue(Vec2d(y,start_time));
 
          // Disable by setting position to NaN and velocity to 0
-         particles[i].x = Vec3d(std::numeric_limits<double>::quiet_NaN(),0.,0.);
-         particles[i].v = Vec3d(0,0,0);
-      } else if (particles[i].x[0] > boundary_right) {
+         particles.disable(i);
+      } else if (pos[0] > boundary_right) {
 
          //Record it as reflected
          reflected.addValue(Vec2d(y,start_time));
 
          // Disable by setting position to NaN and velocity to 0
-         particles[i].x = Vec3d(std::numeric_limits<double>::quiet_NaN(),0.,0.);
-         particles[i].v = Vec3d(0.,0.,0.);
+         particles.disable(i);
       }
    }
 }
@@ -355,45 +356,46 @@ void ipShockScenario::afterPush(int step, double time, ParticleContainer& partic
   /* Perform transmission / reflection check for each particle */
    for(unsigned int i=0; i<particles.size(); i++) {
 
-      if(isnan(vector_length(particles[i].x))) {
+      if(particles.isDisabled(i)) {
          // skip disabled particles
          continue;
       }
 
+      const Vec3d pos = particles.getX(i);
+      const Vec3d vel = particles.getV(i);
+
       //Get particle's x-coordinate
-      double x = particles[i].x[0];
+      double x = pos[0];
 
       // Check if the particle hit a boundary. 
       // If yes, print it and mark it as disabled.
-      if(particles[i].x[0] < ParticleParameters::ipshock_transmit) {
+      if(pos[0] < ParticleParameters::ipshock_transmit) {
 	// Record it as transmitted.
 	//transmitted.addValue(Vec2d(y,start_time));
 	
 	// Write particle information to a file
 	fprintf(traFile,"%lf %lf %lf %lf %lf %lf %lf %lf %lf\n", time, 
-		particles[i].x[0], particles[i].x[1], particles[i].x[2],
-		particles[i].v[0], particles[i].v[1], particles[i].v[2],
-		.5 * particles[i].m * dot_product(particles[i].v, particles[i].v) / PhysicalConstantsSI::e,
-		dot_product(normalize_vector(particles[i].v), normalize_vector(B(particles[i].x))) );
+		pos[0], pos[1], pos[2],
+		vel[0], vel[1], vel[2],
+		.5 * particles.m[i] * dot_product(vel, vel) / PhysicalConstantsSI::e,
+		dot_product(normalize_vector(vel), normalize_vector(B(pos))) );
 
 	// Disable by setting position to NaN and velocity to 0
-	particles[i].x = Vec3d(std::numeric_limits<double>::quiet_NaN(),0.,0.);
-	particles[i].v = Vec3d(0,0,0);
-      } else if (particles[i].x[0] > ParticleParameters::ipshock_reflect) {
+	particles.disable(i);
+      } else if (pos[0] > ParticleParameters::ipshock_reflect) {
 	// Record it as reflected
 	//reflected.addValue(Vec2d(y,start_time));
 	
 	// Write particle information to a file
 	// Write particle information to a file
 	fprintf(refFile,"%lf %lf %lf %lf %lf %lf %lf %lf %lf\n", time, 
-		particles[i].x[0], particles[i].x[1], particles[i].x[2],
-		particles[i].v[0], particles[i].v[1], particles[i].v[2],
-		.5 * particles[i].m * dot_product(particles[i].v, particles[i].v) / PhysicalConstantsSI::e,
-		dot_product(normalize_vector(particles[i].v), normalize_vector(B(particles[i].x))) );
+		pos[0], pos[1], pos[2],
+		vel[0], vel[1], vel[2],
+		.5 * particles.m[i] * dot_product(vel, vel) / PhysicalConstantsSI::e,
+		dot_product(normalize_vector(vel), normalize_vector(B(pos))) );
 
 	// Disable by setting position to NaN and velocity to 0
-	particles[i].x = Vec3d(std::numeric_limits<double>::quiet_NaN(),0.,0.);
-	particles[i].v = Vec3d(0.,0.,0.);
+	particles.disable(i);
       }
    }
    fflush(traFile);
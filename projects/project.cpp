@@ -95,6 +95,7 @@ struct VelocityMeshParams {
 namespace projects {
    Project::Project() { 
       baseClassInitialized = false;
+      sparsePrescreen = false;
    }
    
    Project::~Project() { }
@@ -126,12 +127,16 @@ namespace projects {
       projects::verificationLarmor::addParameters();
       projects::Shocktest::addParameters();
       RP::add("Project_common.seed", "Seed for the RNG", 42);
+      RP::add("Project_common.sparse_prescreen", "If true, projects without their own block search only initialize "
+              "blocks whose block-averaged distribution is above a tenth of the sparse threshold, and their neighbours, "
+              "instead of the whole velocity mesh", false);
       
    }
 
    void Project::getParameters() {
       typedef Readparameters RP;
       RP::get("Project_common.seed", this->seed);
+      RP::get("Project_common.sparse_prescreen", this->sparsePrescreen);
 
 
       // Note that configuration files need to be re-parsed after this.
@@ -221,10 +226,52 @@ namespace projects {
       const uint8_t refLevel = 0;
 
       const vmesh::LocalID* vblocks_ini = cell->get_velocity_grid_length(popID,refLevel);
-      
+
+      // Predict the footprint of the distribution by evaluating it once per block, over the
+      // whole block, before any blocks are allocated. Blocks above a tenth of the sparse
+      // threshold are kept together with their neighbours as a safety margin.
+      vector<bool> hasContent;
+      if (sparsePrescreen) {
+         creal x  = cell->parameters[CellParams::XCRD];
+         creal y  = cell->parameters[CellParams::YCRD];
+         creal z  = cell->parameters[CellParams::ZCRD];
+         creal dx = cell->parameters[CellParams::DX];
+         creal dy = cell->parameters[CellParams::DY];
+         creal dz = cell->parameters[CellParams::DZ];
+         const Real* dvBlock = cell->get_velocity_grid_block_size(popID,refLevel);
+         const Real threshold = 0.1*getObjectWrapper().particleSpecies[popID].sparseMinValue;
+
+         vector<bool> aboveThreshold(vblocks_ini[0]*vblocks_ini[1]*vblocks_ini[2],false);
+         for (uint kv=0; kv<vblocks_ini[2]; ++kv)
+            for (uint jv=0; jv<vblocks_ini[1]; ++jv)
+               for (uint iv=0; iv<vblocks_ini[0]; ++iv) {
+                  vmesh::LocalID blockIndices[3] = {iv,jv,kv};
+                  const vmesh::GlobalID blockGID = cell->get_velocity_block(popID,blockIndices,refLevel);
+                  Real V_crds[3];
+                  cell->get_velocity_block_coordinates(popID,blockGID,V_crds);
+                  const Real average = calcPhaseSpaceDensity(x,y,z,dx,dy,dz,
+                                                             V_crds[0],V_crds[1],V_crds[2],
+                                                             dvBlock[0],dvBlock[1],dvBlock[2],popID);
+                  aboveThreshold[(kv*vblocks_ini[1]+jv)*vblocks_ini[0]+iv] = (average >= threshold);
+               }
+
+         hasContent.assign(aboveThreshold.size(),false);
+         for (int kv=0; kv<(int)vblocks_ini[2]; ++kv)
+            for (int jv=0; jv<(int)vblocks_ini[1]; ++jv)
+               for (int iv=0; iv<(int)vblocks_ini[0]; ++iv) {
+                  if (aboveThreshold[(kv*vblocks_ini[1]+jv)*vblocks_ini[0]+iv] == false) continue;
+                  for (int k=max(kv-1,0); k<=min(kv+1,(int)vblocks_ini[2]-1); ++k)
+                     for (int j=max(jv-1,0); j<=min(jv+1,(int)vblocks_ini[1]-1); ++j)
+                        for (int i=max(iv-1,0); i<=min(iv+1,(int)vblocks_ini[0]-1); ++i) {
+                           hasContent[(k*vblocks_ini[1]+j)*vblocks_ini[0]+i] = true;
+                        }
+               }
+      }
+
       for (uint kv=0; kv<vblocks_ini[2]; ++kv) 
          for (uint jv=0; jv<vblocks_ini[1]; ++jv)
             for (uint iv=0; iv<vblocks_ini[0]; ++iv) {
+               if (sparsePrescreen && hasContent[(kv*vblocks_ini[1]+jv)*vblocks_ini[0]+iv] == false) continue;
                vmesh::LocalID blockIndices[3];
                blockIndices[0] = iv;
                blockIndices[1] = jv;
@@ -95,6 +95,8 @@ namespace projects {
        * The base class version just returns all blocks, which amounts to looping through the whole velocity space.
        * This is very expensive and becomes prohibitive in cases where a large velocity space is needed with only
        * small portions actually containing something. Use with care.
+       * With Project_common.sparse_prescreen the distribution is first evaluated once per block, and only blocks
+       * whose block average is above a tenth of the sparse threshold, and their neighbours, are returned.
        * NOTE: This function is called inside parallel region so it must be declared as const.
        */
       virtual std::vector<vmesh::GlobalID> findBlocksToInitialize(spatial_cell::SpatialCell* cell,const uint popID) const;
@@ -175,6 +177,8 @@ namespace projects {
       
     private:
        uint seed;
+       bool sparsePrescreen;                          /**< If true, the base class findBlocksToInitialize only lists blocks
+                                                       * predicted to have content, see findBlocksToInitialize.*/
 
       bool baseClassInitialized;                      /**< If true, base class has been initialized.*/
    };
@@ -32,7 +32,7 @@ namespace projects {
     * WARNING This assumes that the velocity space is isotropic (same resolution in vx, vy, vz).
     */
    std::vector<vmesh::GlobalID> TriAxisSearch::findBlocksToInitialize(SpatialCell* cell,const uint popID) const {
-      set<vmesh::GlobalID> blocksToInitialize;
+      vector<vmesh::GlobalID> blocksToInitialize;
       bool search;
       unsigned int counter;
       
@@ -133,10 +133,24 @@ namespace projects {
          counter+=2;
          vRadiusSquared = max(vRadiusSquared, (Real)counter*(Real)counter*dvzBlock*dvzBlock);
 
-         // Block listing
-         for (uint kv=0; kv<vzblocks_ini; ++kv) 
-            for (uint jv=0; jv<vyblocks_ini; ++jv)
-               for (uint iv=0; iv<vxblocks_ini; ++iv) {
+         // Block listing. Only the blocks within the bounding box of the search sphere are
+         // tested, with one block of margin on each side.
+         const Real* vMeshMin = cell->get_velocity_grid_min_limits(popID);
+         const Real vRadius = sqrt(vRadiusSquared);
+         const Real V0[3] = {it->at(0),it->at(1),it->at(2)};
+         const Real dvBlock[3] = {dvxBlock,dvyBlock,dvzBlock};
+         const size_t vblocks_ini[3] = {vxblocks_ini,vyblocks_ini,vzblocks_ini};
+         size_t minIndices[3];
+         size_t maxIndices[3];
+         for (int d=0; d<3; ++d) {
+            const Real lower = floor((V0[d] - vRadius - vMeshMin[d]) / dvBlock[d]) - 1;
+            const Real upper = ceil((V0[d] + vRadius - vMeshMin[d]) / dvBlock[d]) + 1;
+            minIndices[d] = (size_t)max((Real)0.0,lower);
+            maxIndices[d] = (size_t)max((Real)0.0,min((Real)vblocks_ini[d],upper));
+         }
+         for (uint kv=minIndices[2]; kv<maxIndices[2]; ++kv) 
+            for (uint jv=minIndices[1]; jv<maxIndices[1]; ++jv)
+               for (uint iv=minIndices[0]; iv<maxIndices[0]; ++iv) {
                   vmesh::GlobalID blockIndices[3];
                   blockIndices[0] = iv;
                   blockIndices[1] = jv;
@@ -156,17 +170,16 @@ namespace projects {
                   
                   if (R2 < vRadiusSquared) {
                      cell->add_velocity_block(blockGID,popID);
-                     blocksToInitialize.insert(blockGID);
+                     blocksToInitialize.push_back(blockGID);
                   }
                }
       }
 
-      vector<vmesh::GlobalID> returnVector;
-      for (set<vmesh::GlobalID>::const_iterator it=blocksToInitialize.begin(); it!=blocksToInitialize.end(); ++it) {
-         returnVector.push_back(*it);
-      }
+      // Blocks of overlapping populations are listed more than once
+      sort(blocksToInitialize.begin(),blocksToInitialize.end());
+      blocksToInitialize.erase(unique(blocksToInitialize.begin(),blocksToInitialize.end()),blocksToInitialize.end());
 
-      return returnVector;
+      return blocksToInitialize;
    }
    
 } // namespace projects
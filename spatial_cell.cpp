@@ -39,9 +39,20 @@ namespace spatial_cell {
    bool SpatialCell::mpiTransferInAMRTranslation = false;
    int SpatialCell::mpiTransferXYZTranslation = 0;
 
+   #ifndef AMR
+   /*! Per-thread scratch for adjust_velocity_blocks: a flag for every block of the
+    * velocity grid, and the list of raised flags. Both are reused between calls.*/
+   static thread_local std::vector<uint8_t> blockHasNeighborContent;
+   static thread_local std::vector<vmesh::GlobalID> flaggedBlocks;
+   #endif
+
    SpatialCell::SpatialCell() {
       // Block list and cache always have room for all blocks
       this->sysBoundaryLayer=0; // Default value, layer not yet initialized
+      this->lbTransferBatch=0;
+      this->lbTransferSource=0;
+      this->block_max_values_popID=-1;
+      this->block_max_values_version=0;
       for (unsigned int i=0; i<WID3; ++i) null_block_data[i] = 0.0;
 
       // reset spatial cell parameters
@@ -81,6 +92,8 @@ namespace spatial_cell {
      velocity_block_with_no_content_list(other.velocity_block_with_no_content_list),
      initialized(other.initialized),
      mpiTransferEnabled(other.mpiTransferEnabled),
+     block_max_values_popID(-1),
+     block_max_values_version(0),
      populations(other.populations),
      parameters(other.parameters),
      derivativesBVOL(other.derivativesBVOL),
@@ -120,43 +133,55 @@ namespace spatial_cell {
       }
       #endif
       
-      //  This set contains all those cellids which have neighbors in any
-      //  of the 6-dimensions Actually, we would only need to add
-      //  local blocks with no content here, as blocks with content
-      //  do not need to be created and also will not be removed as
-      //  we only check for removal for blocks with no content
-      std::unordered_set<vmesh::GlobalID> neighbors_have_content;
+      // Flag all blocks that have content or have neighbors in any of
+      // the 6 dimensions with content. Actually, we would only need to
+      // flag local blocks with no content here, as blocks with content
+      // do not need to be created and also will not be removed as we
+      // only check for removal for blocks with no content. The flags are
+      // a dense per-thread array over the velocity grid of the population,
+      // flaggedBlocks lists the raised flags so that they can be reset
+      // without touching the whole array.
+      const vmesh::GlobalID maxBlocks = populations[popID].vmesh.getMaxVelocityBlocks();
+      if (blockHasNeighborContent.size() < maxBlocks) {
+         blockHasNeighborContent.resize(maxBlocks,0);
+      }
+      flaggedBlocks.clear();
+      auto flagBlock = [&](const vmesh::GlobalID blockGID) {
+         if (blockGID == invalid_global_id()) return;
+         if (blockHasNeighborContent[blockGID] == 0) {
+            blockHasNeighborContent[blockGID] = 1;
+            flaggedBlocks.push_back(blockGID);
+         }
+      };
 
-      //add neighbor content info for velocity space neighbors to map. We loop over blocks
-      //with content and raise the neighbors_have_content for
-      //itself, and for all its neighbors
+      //add neighbor content info for velocity space neighbors. We loop over blocks
+      //with content and raise the flag for itself, and for all its neighbors
+      const int addWidthV = getObjectWrapper().particleSpecies[popID].sparseBlockAddWidthV;
       for (vmesh::LocalID block_index=0; block_index<velocity_block_with_content_list.size(); ++block_index) {
          vmesh::GlobalID block = velocity_block_with_content_list[block_index];
 
          const uint8_t refLevel=0;
          const velocity_block_indices_t indices = SpatialCell::get_velocity_block_indices(popID,block);
-         neighbors_have_content.insert(block); //also add the cell itself
+         flagBlock(block); //also add the cell itself
 
-         int addWidthV = getObjectWrapper().particleSpecies[popID].sparseBlockAddWidthV;
          for (int offset_vx=-addWidthV;offset_vx<=addWidthV;offset_vx++) {
             for (int offset_vy=-addWidthV;offset_vy<=addWidthV;offset_vy++) {
                for (int offset_vz=-addWidthV;offset_vz<=addWidthV;offset_vz++) {
                   const vmesh::GlobalID neighbor_block 
                      = get_velocity_block(popID,{{indices[0]+offset_vx,indices[1]+offset_vy,indices[2]+offset_vz}},refLevel);
-                  neighbors_have_content.insert(neighbor_block); //add all potential ngbrs of this block with content
+                  flagBlock(neighbor_block); //add all potential ngbrs of this block with content
                }
             }
          }
       }
 
-      //add neighbor content info for spatial space neighbors to map. We loop over
+      //add neighbor content info for spatial space neighbors. We loop over
       //neighbor cell lists with existing blocks, and raise the
       //flag for the local block with same block id
       for (std::vector<SpatialCell*>::const_iterator neighbor=spatial_neighbors.begin();
            neighbor != spatial_neighbors.end(); ++neighbor) {
          for (vmesh::LocalID block_index=0; block_index<(*neighbor)->velocity_block_with_content_list.size(); ++block_index) {
-            vmesh::GlobalID block = (*neighbor)->velocity_block_with_content_list[block_index];
-            neighbors_have_content.insert(block);
+            flagBlock((*neighbor)->velocity_block_with_content_list[block_index]);
          }
       }
 
@@ -180,11 +205,7 @@ namespace spatial_cell {
             }
             #endif
             
-            bool removeBlock = false;
-            std::unordered_set<vmesh::GlobalID>::iterator it = neighbors_have_content.find(blockGID);
-            if (it == neighbors_have_content.end()) removeBlock = true;
-
-            if (removeBlock == true) {
+            if (blockHasNeighborContent[blockGID] == 0) {
                //No content, and also no neighbor have content -> remove
                //and increment rho loss counters
                const Real* block_parameters = get_block_parameters(popID)+blockLID*BlockParams::N_VELOCITY_BLOCK_PARAMS;
@@ -201,9 +222,11 @@ namespace spatial_cell {
          }
       }
 
-      // ADD all blocks with neighbors in spatial or velocity space (if it exists then the block is unchanged)
-      for (std::unordered_set<vmesh::GlobalID>::iterator it=neighbors_have_content.begin(); it != neighbors_have_content.end(); ++it) {
-         this->add_velocity_block(*it,popID);
+      // ADD all blocks with neighbors in spatial or velocity space (if it exists then the block is unchanged),
+      // and reset the flags for the next call
+      for (size_t b=0; b<flaggedBlocks.size(); ++b) {
+         this->add_velocity_block(flaggedBlocks[b],popID);
+         blockHasNeighborContent[flaggedBlocks[b]] = 0;
       }
    }
 
@@ -742,6 +765,12 @@ namespace spatial_cell {
             block_lengths.push_back(sizeof(uint));
          }
          
+         // send the rank of the process migrating the cell
+         if ((SpatialCell::mpi_transfer_type & Transfer::CELL_LB_TRANSFER_SOURCE)!=0){
+            displacements.push_back((uint8_t*) &(this->lbTransferSource) - (uint8_t*) this);
+            block_lengths.push_back(sizeof(int));
+         }
+
          if ((SpatialCell::mpi_transfer_type & Transfer::VEL_BLOCK_PARAMETERS) !=0) {
             displacements.push_back((uint8_t*) get_block_parameters(activePopID) - (uint8_t*) this);
             block_lengths.push_back(sizeof(Real) * size(activePopID) * BlockParams::N_VELOCITY_BLOCK_PARAMS);
@@ -1413,6 +1442,26 @@ namespace spatial_cell {
       
       velocity_block_with_content_list.clear();
       velocity_block_with_no_content_list.clear();
+
+      // Use the maximum values recorded by the last solver pass if no blocks
+      // have been added or removed since. They are only valid until the next
+      // update of the lists.
+      const bool useRecordedValues = block_max_values_popID == (int)popID
+         && block_max_values_version != 0
+         && block_max_values_version == populations[popID].vmesh.getBlockSetVersion()
+         && block_max_value_list.size() == populations[popID].vmesh.size();
+      block_max_values_popID = -1;
+      if (useRecordedValues) {
+         const Real velocity_block_min_value = getVelocityBlockMinValue(popID);
+         for (size_t i=0; i<block_max_value_list.size(); ++i) {
+            if (block_max_values[i] >= velocity_block_min_value) {
+               velocity_block_with_content_list.push_back(block_max_value_list[i]);
+            } else {
+               velocity_block_with_no_content_list.push_back(block_max_value_list[i]);
+            }
+         }
+         return;
+      }
       
       for (vmesh::LocalID block_index=0; block_index<populations[popID].vmesh.size(); ++block_index) {
          const vmesh::GlobalID globalID = populations[popID].vmesh.getGlobalID(block_index);
@@ -117,6 +117,7 @@ namespace spatial_cell {
       const uint64_t POP_METADATA             = (1ull<<26);
       const uint64_t RANDOMGEN                = (1ull<<27);
       const uint64_t CELL_GRADPE_TERM         = (1ull<<28);
+      const uint64_t CELL_LB_TRANSFER_SOURCE  = (1ull<<29);
       //all data
       const uint64_t ALL_DATA =
       CELL_PARAMETERS
@@ -143,6 +144,18 @@ namespace spatial_cell {
                                                                                * Note: these are the (i,j,k) indices of the block.
                                                                                * Valid values are ([0,vx_length[,[0,vy_length[,[0,vz_length[).*/
 
+   /** Blocks of a velocity mesh sorted into columns along one dimension, as used by the
+    * semi-Lagrangian acceleration. Only depends on the set of blocks, so it is reused
+    * between acceleration subcycles as long as blockSetVersion matches the mesh.*/
+   struct BlockColumnDecomposition {
+      uint64_t blockSetVersion = 0;                  /**< Block set version of the mesh this was computed for, 0 if never.*/
+      std::vector<vmesh::GlobalID> blocks;           /**< Block global IDs sorted along the dimension.*/
+      std::vector<uint> columnBlockOffsets;          /**< Offset of the first block of each column in blocks.*/
+      std::vector<uint> columnNumBlocks;             /**< Number of blocks in each column.*/
+      std::vector<uint> setColumnOffsets;            /**< Offset of the first column of each column set.*/
+      std::vector<uint> setNumColumns;               /**< Number of columns in each column set.*/
+   };
+
    /** Wrapper for variables needed for each particle species.
     *  Change order if you know what you are doing.
     * All Real fields should be consecutive, as they are communicated as a block.
@@ -169,6 +182,8 @@ namespace spatial_cell {
                                                                       * in this spatial cell. Cells are identified by their unique 
                                                                       * global IDs.*/
       vmesh::VelocityBlockContainer<vmesh::LocalID> blockContainer;  /**< Velocity block data.*/
+      BlockColumnDecomposition accColumns[3];                        /**< Cached column decomposition of vmesh for
+                                                                      * acceleration along each dimension.*/
    };
 
    class SpatialCell {
@@ -274,6 +289,9 @@ namespace spatial_cell {
                                   const uint popID,
                                   bool doDeleteEmptyBlocks=true);
       void update_velocity_block_content_lists(const uint popID);
+      void clear_block_max_values(const uint popID);
+      void record_block_max_value(const vmesh::GlobalID& blockGID,const Realf maxValue);
+      void finish_block_max_values();
       bool checkMesh(const uint popID);
       void clear(const uint popID);
       void coarsen_block(const vmesh::GlobalID& parent,const std::vector<vmesh::GlobalID>& children,const uint popID);
@@ -342,6 +360,9 @@ namespace spatial_cell {
       uint sysBoundaryLayer;                                                  /**< Layers counted from closest systemBoundary. If 0 then it has not 
                                                                                * been computed. First sysboundary layer is layer 1.*/
       int sysBoundaryLayerNew;
+      uint lbTransferBatch;                                                   /**< Batch in which this cell is migrated when the load is balanced.
+                                                                               * Set by the receiving process and communicated to the sender.*/
+      int lbTransferSource;                                                   /**< Process sending this cell when the load is balanced.*/
       std::vector<vmesh::GlobalID> velocity_block_with_content_list;          /**< List of existing cells with content, only up-to-date after
                                                                                * call to update_has_content().*/
       vmesh::LocalID velocity_block_with_content_list_size;                   /**< Size of vector. Needed for MPI communication of size before actual list transfer.*/
@@ -365,6 +386,13 @@ namespace spatial_cell {
       bool initialized;
       bool mpiTransferEnabled;
 
+      std::vector<vmesh::GlobalID> block_max_value_list;                        /**< Blocks whose maximum value was recorded by the last solver pass.*/
+      std::vector<Realf> block_max_values;                                      /**< Maximum value of the blocks in block_max_value_list.*/
+      int block_max_values_popID;                                               /**< Population of the recorded maximum values, -1 if there are none.
+                                                                                 * Consumed by update_velocity_block_content_lists.*/
+      uint64_t block_max_values_version;                                        /**< Block set version (VelocityMesh::getBlockSetVersion) the recorded
+                                                                                 * values belong to, 0 while they are still being recorded.*/
+
       // Random number generator state variables, used for running reproducible 
       // simulations that do not depend on the number of threads of MPI processes used.
       //char rngStateBuffer[256];                                                 /**< Random number generator state buffer.*/
@@ -1111,6 +1139,36 @@ namespace spatial_cell {
       return populations[popID].vmesh.getLocalID(blockGID);
    }
 
+   /** Start recording the maximum values of the blocks of the given population.
+    * Any previously recorded values are discarded.
+    * @param popID ID of the particle species.
+    * @see record_block_max_value */
+   inline void SpatialCell::clear_block_max_values(const uint popID) {
+      block_max_value_list.clear();
+      block_max_values.clear();
+      block_max_values_popID = popID;
+      block_max_values_version = 0;
+   }
+
+   /** Record the maximum value of a velocity block. Solvers call this once for
+    * every block of the population after its final values have been written, so
+    * that update_velocity_block_content_lists does not have to scan the block data.
+    * @param blockGID Global ID of the block.
+    * @param maxValue Maximum value of the distribution function in the block.*/
+   inline void SpatialCell::record_block_max_value(const vmesh::GlobalID& blockGID,const Realf maxValue) {
+      block_max_value_list.push_back(blockGID);
+      block_max_values.push_back(maxValue);
+   }
+
+   /** Finish recording block maximum values. The recorded values are tied to the
+    * current block set of the population, any later addition or removal of blocks
+    * invalidates them.
+    * @see clear_block_max_values */
+   inline void SpatialCell::finish_block_max_values() {
+      if (block_max_values_popID < 0) return;
+      block_max_values_version = populations[block_max_values_popID].vmesh.getBlockSetVersion();
+   }
+
    inline void SpatialCell::get_velocity_block_size(const uint popID,const vmesh::GlobalID block,Real blockSize[3]) {
       populations[popID].vmesh.getBlockSize(block,blockSize);
    }
@@ -758,8 +758,12 @@ void SysBoundary::applySysBoundaryVlasovConditions(
 
 #pragma omp parallel for
       for (uint i = 0; i < localCells.size(); i++) {
+         const double t1 = MPI_Wtime();
          cuint sysBoundaryType = mpiGrid[localCells[i]]->sysBoundaryFlag;
          this->getSysBoundary(sysBoundaryType)->vlasovBoundaryCondition(mpiGrid, localCells[i], popID, calculate_V_moments);
+         if (Parameters::prepareForRebalance == true) {
+            mpiGrid[localCells[i]]->parameters[CellParams::LBWEIGHTTIME] += MPI_Wtime() - t1;
+         }
       }
       if (calculate_V_moments) {
          calculateMoments_V(mpiGrid, localCells, true);
@@ -781,8 +785,12 @@ void SysBoundary::applySysBoundaryVlasovConditions(
                           boundaryCells);
 #pragma omp parallel for
       for (uint i = 0; i < boundaryCells.size(); i++) {
+         const double t1 = MPI_Wtime();
          cuint sysBoundaryType = mpiGrid[boundaryCells[i]]->sysBoundaryFlag;
          this->getSysBoundary(sysBoundaryType)->vlasovBoundaryCondition(mpiGrid, boundaryCells[i], popID, calculate_V_moments);
+         if (Parameters::prepareForRebalance == true) {
+            mpiGrid[boundaryCells[i]]->parameters[CellParams::LBWEIGHTTIME] += MPI_Wtime() - t1;
+         }
       }
       if (calculate_V_moments) {
          calculateMoments_V(mpiGrid, boundaryCells, true);
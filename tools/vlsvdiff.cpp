@@ -32,6 +32,8 @@
  
  * "$ vlsvdiff --diff --meshname=<Meshname> <file1> <file2> <Variable> <component>": Gives single-file statistics and distances between the two files given, for the variable and component given
  * 
+ * "$ vlsvdiff --flat <file1> <file2> <Variable> <component>": Same as above, but reads the files in chunks into flat CellID-sorted arrays instead of maps. This is faster and uses less memory per cell, but memory use still grows with the number of cells
+ * 
  * "$ vlsvdiff <folder1> <folder2> <Variable> <component>": Gives single-file statistics and distances between pairs of files grid*.vlsv taken in alphanumeric order in the two folders given, for the variable and component given
  * 
  * "$ vlsvdiff <file1> <folder2> <Variable> <component>" or "$ vlsvdiff <folder1> <file2> <Variable> <component>": Gives single-file statistics and distances between a file, and files grid*.vlsv taken in alphanumeric order in the given folder, for the variable and component given
@@ -1473,6 +1475,302 @@ bool compareAvgs( const string fileName1,
    return true;
 }
 
+//! Number of cells read from a file at once in flat array mode
+static const uint64_t readChunkCells = 1048576;
+
+/*! Extract one component of a single variable entry as a Real
+ * \param ptr Pointer to the start of the entry
+ * \param dataType Type of the vector elements
+ * \param dataSize Size of one vector element in bytes
+ * \param component Component to extract
+ */
+static Real extractComponent(const char* ptr, const datatype::type& dataType, const uint64_t& dataSize, const uint component) {
+   switch (dataType) {
+      case datatype::type::FLOAT:
+         if(dataSize == sizeof(float)) return (Real)(reinterpret_cast<const float*>(ptr)[component]);
+         if(dataSize == sizeof(double)) return (Real)(reinterpret_cast<const double*>(ptr)[component]);
+         break;
+      case datatype::type::UINT:
+         return (Real)(reinterpret_cast<const uint*>(ptr)[component]);
+      case datatype::type::INT:
+         return (Real)(reinterpret_cast<const int*>(ptr)[component]);
+      case datatype::type::UNKNOWN:
+         cerr << "ERROR, BAD DATATYPE AT " << __FILE__ << " " << __LINE__ << endl;
+         break;
+   }
+   return NAN;
+}
+
+/*! Flat array counterpart of convertSILO for SpatialGrid data. The variable is read in chunks of
+ * readChunkCells cells, and only the requested component is kept. The result is returned in flat
+ * arrays sorted by CellID. Memory use is still O(cells): the cell IDs, the component and the file order
+ * of all cells are held, only the full variable vectors are not.
+ * \param fileName String containing the name of the file to be processed
+ * \param meshName Name of the mesh the variable is on
+ * \param varToExtract Pointer to the char array containing the name of the variable to extract
+ * \param compToExtract Unsigned int designating the component to extract (0 for scalars)
+ * \param cellIds Return argument, the sorted CellIDs
+ * \param values Return argument, the extracted component for each entry of cellIds
+ * \param fileOrder Return argument, the position of each entry of cellIds in the file
+ * \sa convertSILO
+ */
+bool readSortedComponent(const string& fileName,
+                         const string& meshName,
+                         const char * varToExtract,
+                         const uint compToExtract,
+                         vector<uint64_t>& cellIds,
+                         vector<Real>& values,
+                         vector<uint64_t>& fileOrder) {
+   vlsvinterface::Reader vlsvReader;
+   if (vlsvReader.open(fileName) == false) {
+      cerr << "Failed to open '" << fileName << "'" << endl;
+      cerr << "VLSV error " << vlsvReader.getErrorString() << endl;
+      return false;
+   }
+
+   vector<uint64_t> fileCellIds;
+   if (vlsvReader.getCellIds(fileCellIds, meshName) == false) {
+      cerr << "Failed to read cell ids at "  << __FILE__ << " " << __LINE__ << endl;
+      return false;
+   }
+
+   datatype::type dataType;
+   uint64_t arraySize, vectorSize, dataSize;
+   list<pair<string, string> > variableAttributes;
+   variableAttributes.push_back( make_pair("mesh", meshName) );
+   variableAttributes.push_back( make_pair("name", string(varToExtract)) );
+   if (vlsvReader.getArrayInfo("VARIABLE", variableAttributes, arraySize, vectorSize, dataType, dataSize) == false) {
+      cerr << "ERROR, failed to get array info for '" << varToExtract << "' at " << __FILE__ << " " << __LINE__ << endl;
+      return false;
+   }
+   if (fileCellIds.size() != arraySize) {
+      cerr << "ERROR array size mismatch: " << fileCellIds.size() << " " << arraySize << endl;
+      return false;
+   }
+   if (compToExtract + 1 > vectorSize) {
+      cerr << "ERROR invalid component, this variable has size " << vectorSize << endl;
+      return false;
+   }
+
+   const uint64_t entrySize = vectorSize * dataSize;
+   vector<char> buffer(min(arraySize, readChunkCells) * entrySize);
+   vector<Real> fileValues(arraySize);
+   for (uint64_t start=0; start<arraySize; start+=readChunkCells) {
+      const uint64_t amount = min(readChunkCells, arraySize - start);
+      if (vlsvReader.readArray("VARIABLE", variableAttributes, start, amount, buffer.data()) == false) {
+         cerr << "ERROR, failed to read variable '" << varToExtract << "' at " << __FILE__ << " " << __LINE__ << endl;
+         return false;
+      }
+      for (uint64_t i=0; i<amount; ++i) {
+         fileValues[start+i] = extractComponent(&buffer[i*entrySize], dataType, dataSize, compToExtract);
+      }
+   }
+   vlsvReader.close();
+
+   fileOrder.resize(arraySize);
+   for (uint64_t i=0; i<arraySize; ++i) fileOrder[i] = i;
+   sort(fileOrder.begin(), fileOrder.end(),
+        [&fileCellIds](const uint64_t a, const uint64_t b) { return fileCellIds[a] < fileCellIds[b]; });
+
+   // Permute one array at a time and release the file-ordered copy right away
+   cellIds.resize(arraySize);
+   for (uint64_t i=0; i<arraySize; ++i) cellIds[i] = fileCellIds[fileOrder[i]];
+   vector<uint64_t>().swap(fileCellIds);
+   values.resize(arraySize);
+   for (uint64_t i=0; i<arraySize; ++i) values[i] = fileValues[fileOrder[i]];
+   vector<Real>().swap(fileValues);
+   return true;
+}
+
+/*! Flat-array version of singleStatistics, giving the same results.
+ * \sa singleStatistics
+ */
+bool singleStatistics(const vector<Real>& data,
+                      Real * size,
+                      Real * mini,
+                      Real * maxi,
+                      Real * avg,
+                      Real * stdev
+)
+{
+   const int64_t n = data.size();
+   Real dataMin = numeric_limits<Real>::max();
+   Real dataMax = numeric_limits<Real>::min();
+   Real sum = 0.0;
+   #pragma omp parallel for reduction(min:dataMin) reduction(max:dataMax) reduction(+:sum)
+   for (int64_t i=0; i<n; ++i) {
+      dataMin = min(dataMin, data[i]);
+      dataMax = max(dataMax, data[i]);
+      sum += data[i];
+   }
+   *size = n;
+   *mini = dataMin;
+   *maxi = dataMax;
+   *avg = sum / *size;
+
+   const Real average = *avg;
+   Real squares = 0.0;
+   #pragma omp parallel for reduction(+:squares)
+   for (int64_t i=0; i<n; ++i) {
+      squares += pow(data[i] - average, 2.0);
+   }
+   *stdev = sqrt(squares);
+   *stdev /= (*size - 1);
+   return 0;
+}
+
+/*! Flat array comparison of two files, enabled by --flat. Reports the same statistics and distances
+ * as the map-based path in process2Files, but works on CellID-sorted flat arrays read in chunks, reads
+ * both files concurrently and computes all distances in one threaded sweep.
+ * \param fileName1 String argument giving the location of the first (reference) file
+ * \param fileName2 String argument giving the location of the second file
+ * \param varToExtract Pointer to the char array containing the name of the variable to extract
+ * \param compToExtract Unsigned int designating the component to extract (0 for scalars)
+ * \param verboseOutput Boolean parameter telling whether the output will be verbose or compact
+ * \sa process2Files pDistance singleStatistics
+ */
+bool process2FilesFlat(const string fileName1,
+                            const string fileName2,
+                            const char * varToExtract,
+                            const uint compToExtract,
+                            const bool verboseOutput
+                           ) {
+   vector<uint64_t> cellIds1, cellIds2, fileOrder1, fileOrder2;
+   vector<Real> data1, data2;
+   bool success1 = true, success2 = true;
+   // Looked up here, the attributes map must not be touched from the parallel sections
+   const string meshName = attributes["--meshname"];
+
+   #pragma omp parallel sections
+   {
+      #pragma omp section
+      success1 = readSortedComponent(fileName1, meshName, varToExtract, compToExtract, cellIds1, data1, fileOrder1);
+      #pragma omp section
+      success2 = readSortedComponent(fileName2, meshName, varToExtract, compToExtract, cellIds2, data2, fileOrder2);
+   }
+   if (success1 == false) {
+      cerr << "ERROR Data import error with " << fileName1 << endl;
+      return false;
+   }
+   if (success2 == false) {
+      cerr << "ERROR Data import error with " << fileName2 << endl;
+      return false;
+   }
+   vector<uint64_t>().swap(fileOrder2);
+
+   // Basic consistency check
+   if (data1.size() != data2.size()) {
+      cerr << "ERROR Datasets have different size." << endl;
+      return false;
+   }
+
+   Real absolute, relative, mini, maxi, size, avg, stdev;
+   Real avg1, avg2;
+   singleStatistics(data1, &size, &mini, &maxi, &avg1, &stdev);
+   outputStats(&size, &mini, &maxi, &avg1, &stdev, verboseOutput, false);
+   singleStatistics(data2, &size, &mini, &maxi, &avg2, &stdev);
+   outputStats(&size, &mini, &maxi, &avg2, &stdev, verboseOutput, false);
+
+   // Match the cells of the second file to the reference file, -1 if the cell is missing
+   const int64_t n = data1.size();
+   vector<int64_t> match(n, -1);
+   for (int64_t i=0, j=0; i<n; ++i) {
+      while (j < n && cellIds2[j] < cellIds1[i]) ++j;
+      if (j < n && cellIds2[j] == cellIds1[i]) match[i] = j;
+   }
+   vector<uint64_t>().swap(cellIds1);
+   vector<uint64_t>().swap(cellIds2);
+
+   // Shift applied to the second file when comparing average-shifted data, see shiftAverage
+   const Real shift = avg1 - avg2;
+
+   // Absolute distances for p = 0, 1, 2, without and with average shift, and reference lengths
+   Real abs0 = 0.0, abs0Shifted = 0.0, length0 = 0.0;
+   Real abs1 = 0.0, abs1Shifted = 0.0, length1 = 0.0;
+   Real abs2 = 0.0, abs2Shifted = 0.0, length2 = 0.0;
+   #pragma omp parallel for reduction(max:abs0,abs0Shifted,length0) reduction(+:abs1,abs1Shifted,length1,abs2,abs2Shifted,length2)
+   for (int64_t i=0; i<n; ++i) {
+      if (match[i] < 0) continue;
+      const Real value = abs(data1[i] - data2[match[i]]);
+      const Real shifted = abs(data1[i] - (data2[match[i]] + shift));
+      const Real reference = abs(data1[i]);
+      abs0 = max(abs0, value);
+      abs0Shifted = max(abs0Shifted, shifted);
+      length0 = max(length0, reference);
+      abs1 += value;
+      abs1Shifted += shifted;
+      length1 += reference;
+      abs2 += pow(value, 2.0);
+      abs2Shifted += pow(shifted, 2.0);
+      length2 += pow(reference, 2.0);
+   }
+   abs2 = pow(abs2, 0.5);
+   abs2Shifted = pow(abs2Shifted, 0.5);
+   length2 = pow(length2, 0.5);
+
+   // Open VLSV file where the diffence in the chosen variable is written
+   const string varName = varToExtract;
+   vlsv::Writer outputFile;
+   const bool writeDiff = attributes.find("--diff") != attributes.end();
+   if (writeDiff) {
+      const string prefix = fileName1.substr(0,fileName1.find_last_of('.'));
+      const string suffix = fileName1.substr(fileName1.find_last_of('.'),fileName1.size());
+      string outputFileName = prefix + ".diff." + varToExtract + suffix;
+      if (outputFileName[0] == '.' && outputFileName[1] == '/') {
+         outputFileName = outputFileName.substr(2,string::npos);
+      }
+      for (size_t s=0; s<outputFileName.size(); ++s)
+        if (outputFileName[s] == '/') outputFileName[s] = '_';
+
+      if (outputFile.open(outputFileName,MPI_COMM_SELF,0) == false) {
+         cerr << "ERROR failed to open output file '" << outputFileName << "' in " << __FILE__ << ":" << __LINE__ << endl;
+         return false;
+      }
+      if (cloneMesh(fileName1,outputFile,attributes["--meshname"],map<uint, Real>()) == false) {
+         std::cerr<<"Failed"<<std::endl;
+         return false;
+      }
+   }
+
+   const Real ps[3] = {0, 1, 2};
+   const Real absolutes[3][2] = {{abs0, abs0Shifted}, {abs1, abs1Shifted}, {abs2, abs2Shifted}};
+   const Real lengths[3] = {length0, length1, length2};
+   const string diffNames[3][2] = {{"d0_", "d0_sft_"}, {"d1_", "d1_sft_"}, {"d2_", "d2_sft_"}};
+   vector<Real> diffArray;
+   for (int ip=0; ip<3; ++ip) {
+      for (int shifted=0; shifted<2; ++shifted) {
+         absolute = absolutes[ip][shifted];
+         if (lengths[ip] != 0.0) relative = absolute / lengths[ip];
+         else {
+            cout << "WARNING (pDistance) : length of reference is 0.0, cannot divide to give relative distance." << endl;
+            relative = -1;
+         }
+
+         // Write out the difference in the order of the reference file, one variable at a time
+         if (writeDiff) {
+            const Real fileShift = shifted ? shift : 0.0;
+            diffArray.resize(n);
+            #pragma omp parallel for
+            for (int64_t i=0; i<n; ++i) {
+               diffArray[fileOrder1[i]] = (match[i] < 0) ? 0.0 : abs(data1[i] - (data2[match[i]] + fileShift));
+            }
+            map<string,string> diffAttributes;
+            diffAttributes["mesh"] = attributes["--meshname"];
+            diffAttributes["name"] = diffNames[ip][shifted] + varName;
+            if (outputFile.writeArray("VARIABLE",diffAttributes,diffArray.size(),1,&(diffArray[0])) == false) {
+               cerr << "ERROR failed to write variable '" << diffAttributes["name"] << "' to output file in " << __FILE__ << ":" << __LINE__ << endl;
+            }
+         }
+         outputDistance(ps[ip], &absolute, &relative, shifted, verboseOutput, false);
+      }
+   }
+
+   if (writeDiff) {
+      outputFile.close();
+   }
+   return true;
+}
+
 /*! Read in the contents of the variable component in both files passed in strings fileName1 and fileName2, and compute statistics and distances as wished
  * \param fileName1 String argument giving the location of the first file to process
  * \param fileName2 String argument giving the location of the second file to process
@@ -1502,6 +1800,10 @@ bool process2Files(const string fileName1,
       cellIds2.push_back(compToExtract2);
       // Compare files:
       if( compareAvgs<vlsvinterface::Reader, vlsvinterface::Reader>(fileName1, fileName2, verboseOutput, cellIds1, cellIds2) == false ) { return false; }
+   } else if (attributes.find("--flat") != attributes.end() && gridName == gridType::SpatialGrid) {
+      if (process2FilesFlat(fileName1, fileName2, varToExtract, compToExtract, verboseOutput) == false) {
+         return 1;
+      }
    } else {
       unordered_map<size_t,size_t> cellOrder;
    
@@ -1696,11 +1998,13 @@ int main(int argn,char* args[]) {
    defAttribs.insert(make_pair("--help",""));
    defAttribs.insert(make_pair("--no-distrib",""));
    defAttribs.insert(make_pair("--diff",""));
+   defAttribs.insert(make_pair("--flat",""));
 
    descriptions["--meshname"] = "Name of the spatial mesh that is used in diff.";
    descriptions["--filemask"] = "File mask used in directory comparison mode. For example, if you want to compare files starting with 'fullf', set '--filemask=fullf'.";
    descriptions["--help"]     = "Print this help message.";
    descriptions["--diff"]     = "If set, difference file(s) are written.";
+   descriptions["--flat"]     = "If set, SpatialGrid variables are compared using flat CellID-sorted arrays instead of maps, with the files read in chunks. Faster and smaller per cell, but not memory-bounded: memory use is still proportional to the number of cells.";
    descriptions["--no-distrib"] = "If set, velocity block data are not compared even if the given variable corresponds to velocity block data.";
 
 
@@ -1799,6 +2103,9 @@ int main(int argn,char* args[]) {
       std::cerr<<"Wrong grid type"<<std::endl;
       abort();
    }
+   if (attributes.find("--flat") != attributes.end() && gridName != gridType::SpatialGrid) {
+      cerr << "WARNING --flat only supports SpatialGrid data, comparing " << attributes["--meshname"] << " without it." << endl;
+   }
 
 
 
@@ -23,12 +23,14 @@
 #ifndef VELOCITY_MESH_OLD_H
 #define VELOCITY_MESH_OLD_H
 
+#include <atomic>
 #include <iostream>
 #include <algorithm>
 #include <sstream>
 #include <stdint.h>
 #include <vector>
 #include <unordered_map>
+#include <map>
 #include <set>
 #include <cmath>
 
@@ -64,6 +66,8 @@ namespace vmesh {
       GID getGlobalID(const uint8_t& refLevel,LID indices[3]) const;
       GID getGlobalID(const uint32_t& refLevel,const LID& i,const LID& j,const LID& k) const;
       GID getGlobalIndexOffset(const uint8_t& refLevel=0);
+      bool getBlockIndexBounds(LID minIndices[3],LID maxIndices[3]) const;
+      uint64_t getBlockSetVersion() const;
       std::vector<GID>& getGrid();
       const LID* getGridLength(const uint8_t& refLevel) const;
 //      void     getNeighbors(const GlobalID& globalID,std::vector<GlobalID>& neighborIDs);
@@ -110,21 +114,112 @@ namespace vmesh {
       std::vector<GID> localToGlobalMap;
       OpenBucketHashtable<GID,LID> globalToLocalMap; //
       //std::unordered_map<GID,LID> globalToLocalMap;
+
+      // Number of blocks at each block index along each axis, and the smallest and
+      // largest occupied indices. Kept up to date as blocks are added and removed, but
+      // only for velocity meshes, i.e. meshes given their meshID with initialize(meshID)
+      // or setMesh(). Other users of the class, such as MeshDataContainer, never set it.
+      bool trackBlockIndices;
+      std::vector<LID> blockIndexCounts[3];
+      LID blockIndexMin[3];
+      LID blockIndexMax[3];
+
+      // Identifies the current set of blocks, zero means that the set has changed and a
+      // new version is handed out on the next call to getBlockSetVersion().
+      static std::atomic<uint64_t> blockSetVersionCounter;
+      mutable uint64_t blockSetVersion;
+
+      void addBlockIndices(const GID& globalID);
+      void removeBlockIndices(const GID& globalID);
+      void resetBlockIndexBounds();
    };
 
    // ***** INITIALIZERS FOR STATIC MEMBER VARIABLES ***** //
    template<typename GID,typename LID> std::vector<vmesh::MeshParameters> VelocityMesh<GID,LID>::meshParameters;
+   template<typename GID,typename LID> std::atomic<uint64_t> VelocityMesh<GID,LID>::blockSetVersionCounter(0);
    
    // ***** DEFINITIONS OF TEMPLATE MEMBER FUNCTIONS ***** //
 
    template<typename GID,typename LID> inline
    VelocityMesh<GID,LID>::VelocityMesh() { 
       meshID = std::numeric_limits<size_t>::max();
+      trackBlockIndices = false;
+      blockSetVersion = 0;
+      for (int d=0; d<3; ++d) {
+         blockIndexMin[d] = invalidBlockIndex();
+         blockIndexMax[d] = invalidBlockIndex();
+      }
    }
    
    template<typename GID,typename LID> inline
    VelocityMesh<GID,LID>::~VelocityMesh() { }
 
+   /** Add a block to the per-axis block index counts and extend the index bounds.
+    * Blocks outside of the mesh are not counted.*/
+   template<typename GID,typename LID> inline
+   void VelocityMesh<GID,LID>::addBlockIndices(const GID& globalID) {
+      blockSetVersion = 0;
+      if (trackBlockIndices == false || meshID >= meshParameters.size()) return;
+      const LID* gridLength = meshParameters[meshID].gridLength;
+      for (int d=0; d<3; ++d) {
+         if (blockIndexCounts[d].size() != gridLength[d]) blockIndexCounts[d].assign(gridLength[d],0);
+      }
+      const LID indices[3] = {(LID)(globalID % gridLength[0]),
+                              (LID)((globalID / gridLength[0]) % gridLength[1]),
+                              (LID)(globalID / (gridLength[0] * gridLength[1]))};
+      if (globalID / gridLength[0] / gridLength[1] >= gridLength[2]) return;
+      for (int d=0; d<3; ++d) {
+         ++blockIndexCounts[d][indices[d]];
+         if (blockIndexMin[d] == invalidBlockIndex() || indices[d] < blockIndexMin[d]) blockIndexMin[d] = indices[d];
+         if (blockIndexMax[d] == invalidBlockIndex() || indices[d] > blockIndexMax[d]) blockIndexMax[d] = indices[d];
+      }
+   }
+
+   /** Remove a block from the per-axis block index counts. If the block was the last one at
+    * an index bound, the bound is moved inwards to the next occupied index.*/
+   template<typename GID,typename LID> inline
+   void VelocityMesh<GID,LID>::removeBlockIndices(const GID& globalID) {
+      blockSetVersion = 0;
+      if (trackBlockIndices == false || meshID >= meshParameters.size()) return;
+      const LID* gridLength = meshParameters[meshID].gridLength;
+      const LID indices[3] = {(LID)(globalID % gridLength[0]),
+                              (LID)((globalID / gridLength[0]) % gridLength[1]),
+                              (LID)(globalID / (gridLength[0] * gridLength[1]))};
+      if (globalID / gridLength[0] / gridLength[1] >= gridLength[2]) return;
+      for (int d=0; d<3; ++d) {
+         if (blockIndexCounts[d].size() != gridLength[d] || blockIndexCounts[d][indices[d]] == 0) return;
+      }
+      for (int d=0; d<3; ++d) {
+         --blockIndexCounts[d][indices[d]];
+         if (blockIndexCounts[d][indices[d]] > 0) continue;
+         if (blockIndexMin[d] == blockIndexMax[d]) {
+            // Last block of the mesh
+            blockIndexMin[d] = invalidBlockIndex();
+            blockIndexMax[d] = invalidBlockIndex();
+            continue;
+         }
+         if (indices[d] == blockIndexMin[d]) {
+            while (blockIndexCounts[d][blockIndexMin[d]] == 0) ++blockIndexMin[d];
+         }
+         if (indices[d] == blockIndexMax[d]) {
+            while (blockIndexCounts[d][blockIndexMax[d]] == 0) --blockIndexMax[d];
+         }
+      }
+   }
+
+   /** Recompute the per-axis block index counts and bounds from the blocks in localToGlobalMap.*/
+   template<typename GID,typename LID> inline
+   void VelocityMesh<GID,LID>::resetBlockIndexBounds() {
+      blockSetVersion = 0;
+      for (int d=0; d<3; ++d) {
+         std::fill(blockIndexCounts[d].begin(),blockIndexCounts[d].end(),0);
+         blockIndexMin[d] = invalidBlockIndex();
+         blockIndexMax[d] = invalidBlockIndex();
+      }
+      if (trackBlockIndices == false) return;
+      for (size_t b=0; b<localToGlobalMap.size(); ++b) addBlockIndices(localToGlobalMap[b]);
+   }
+
    template<typename GID,typename LID> inline
    size_t VelocityMesh<GID,LID>::capacityInBytes() const {
       return localToGlobalMap.capacity()*sizeof(GID)
@@ -160,6 +255,7 @@ namespace vmesh {
    void VelocityMesh<GID,LID>::clear() {
       std::vector<GID>().swap(localToGlobalMap);
       globalToLocalMap.clear();
+      resetBlockIndexBounds();
    }
    
    template<typename GID,typename LID> inline
@@ -357,9 +453,35 @@ namespace vmesh {
    
    template<typename GID,typename LID> inline
    std::vector<GID>& VelocityMesh<GID,LID>::getGrid() {
+      // The caller may overwrite the block list
+      blockSetVersion = 0;
       return localToGlobalMap;
    }
 
+   /** Get a number identifying the current set of blocks. The number changes whenever
+    * blocks are added or removed, and is never zero. Reordering blocks with copy() does not
+    * change it, so it can be used to cache data that depends on the block set only.
+    * @return Version of the block set.*/
+   template<typename GID,typename LID> inline
+   uint64_t VelocityMesh<GID,LID>::getBlockSetVersion() const {
+      if (blockSetVersion == 0) blockSetVersion = ++blockSetVersionCounter;
+      return blockSetVersion;
+   }
+
+   /** Get the smallest and largest block indices along each axis over all existing blocks.
+    * The bounds are maintained incrementally, so this is O(1). Only available for velocity meshes.
+    * @param minIndices Smallest block i,j,k indices.
+    * @param maxIndices Largest block i,j,k indices.
+    * @return If false, the mesh has no blocks (or does not track them) and the indices are invalidBlockIndex().*/
+   template<typename GID,typename LID> inline
+   bool VelocityMesh<GID,LID>::getBlockIndexBounds(LID minIndices[3],LID maxIndices[3]) const {
+      for (int d=0; d<3; ++d) {
+         minIndices[d] = blockIndexMin[d];
+         maxIndices[d] = blockIndexMax[d];
+      }
+      return blockIndexMin[0] != invalidBlockIndex();
+   }
+
    template<typename GID,typename LID> inline
    const LID* VelocityMesh<GID,LID>::getGridLength(const uint8_t& refLevel) const {
       return meshParameters[meshID].gridLength;
@@ -520,6 +642,8 @@ namespace vmesh {
    template<typename GID,typename LID> inline
    bool VelocityMesh<GID,LID>::initialize(const size_t& meshID) {
       this->meshID = meshID;
+      trackBlockIndices = true;
+      resetBlockIndexBounds();
       return true;
    }
    
@@ -587,6 +711,7 @@ namespace vmesh {
 
       globalToLocalMap.erase(last);
       localToGlobalMap.pop_back();
+      removeBlockIndices(lastGID);
    }
 
    template<typename GID,typename LID> inline
@@ -599,6 +724,7 @@ namespace vmesh {
 
       if (position.second == true) {
          localToGlobalMap.push_back(globalID);
+         addBlockIndices(globalID);
       }
 
       return position.second;
@@ -617,6 +743,7 @@ namespace vmesh {
          globalToLocalMap.insert(std::make_pair(blocks[b],localToGlobalMap.size()+b));
       }
       localToGlobalMap.insert(localToGlobalMap.end(),blocks.begin(),blocks.end());
+      for (size_t b=0; b<blocks.size(); ++b) addBlockIndices(blocks[b]);
 
       return true;
    }
@@ -632,6 +759,7 @@ namespace vmesh {
       for (size_t i=0; i<localToGlobalMap.size(); ++i) {
          globalToLocalMap.insert(std::make_pair(localToGlobalMap[i],i));
       }
+      resetBlockIndexBounds();
    }
 
    template<typename GID,typename LID> inline
@@ -641,6 +769,7 @@ namespace vmesh {
          globalToLocalMap.insert(std::make_pair(globalIDs[i],i));
       }
       localToGlobalMap = globalIDs;
+      resetBlockIndexBounds();
       return true;
    }
 
@@ -648,12 +777,17 @@ namespace vmesh {
    bool VelocityMesh<GID,LID>::setMesh(const size_t& meshID) {
       if (meshID >= meshParameters.size()) return false;
       this->meshID = meshID;
+      trackBlockIndices = true;
+      resetBlockIndexBounds();
       return true;
    }
    
+   /** Resize the list of blocks, e.g. before receiving it over MPI. The block index
+    * bounds are not valid until setGrid() has been called.*/
    template<typename GID,typename LID> inline
    void VelocityMesh<GID,LID>::setNewSize(const LID& newSize) {
       localToGlobalMap.resize(newSize);
+      blockSetVersion = 0;
    }
 
    template<typename GID,typename LID> inline
@@ -671,6 +805,13 @@ namespace vmesh {
    void VelocityMesh<GID,LID>::swap(VelocityMesh& vm) {
       globalToLocalMap.swap(vm.globalToLocalMap);
       localToGlobalMap.swap(vm.localToGlobalMap);
+      std::swap(trackBlockIndices,vm.trackBlockIndices);
+      for (int d=0; d<3; ++d) {
+         blockIndexCounts[d].swap(vm.blockIndexCounts[d]);
+         std::swap(blockIndexMin[d],vm.blockIndexMin[d]);
+         std::swap(blockIndexMax[d],vm.blockIndexMax[d]);
+      }
+      std::swap(blockSetVersion,vm.blockSetVersion);
    }
    
 } // namespace vmesh
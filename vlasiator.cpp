@@ -113,69 +113,97 @@ bool computeNewTimeStep(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpi
    dtMaxLocal[1]=numeric_limits<Real>::max();
    dtMaxLocal[2]=numeric_limits<Real>::max();
 
-   for (vector<CellID>::const_iterator cell_id=cells.begin(); cell_id!=cells.end(); ++cell_id) {
-      SpatialCell* cell = mpiGrid[*cell_id];
+   // Local minima are reduced over threads, the per-block corner velocities of each
+   // population are reduced with a simd loop and written to the cell once.
+   phiprof::start("compute-timestep-vlasov");
+   Real dtMaxLocalR = dtMaxLocal[0];
+   Real dtMaxLocalV = dtMaxLocal[1];
+   const uint nPopulations = getObjectWrapper().particleSpecies.size();
+   #pragma omp parallel for schedule(dynamic,1) reduction(min:dtMaxLocalR,dtMaxLocalV)
+   for (size_t c=0; c<cells.size(); ++c) {
+      SpatialCell* cell = mpiGrid[cells[c]];
       const Real dx = cell->parameters[CellParams::DX];
       const Real dy = cell->parameters[CellParams::DY];
       const Real dz = cell->parameters[CellParams::DZ];
 
-      cell->parameters[CellParams::MAXRDT] = numeric_limits<Real>::max();
+      Real cellMaxRDt = numeric_limits<Real>::max();
 
-      for (uint popID=0; popID<getObjectWrapper().particleSpecies.size(); ++popID) {
-         cell->set_max_r_dt(popID,numeric_limits<Real>::max());
+      for (uint popID=0; popID<nPopulations; ++popID) {
+         const Real EPS = numeric_limits<Real>::min()*1000;
+         Real popMaxRDt = numeric_limits<Real>::max();
+         #ifndef AMR
+         // The largest |v| along each axis is found at the outer corner cells of the blocks
+         // with the smallest or largest block index, which the velocity mesh keeps track of.
+         const vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh = cell->get_velocity_mesh(popID);
+         vmesh::LocalID minIndices[3];
+         vmesh::LocalID maxIndices[3];
+         if (vmesh.getBlockIndexBounds(minIndices,maxIndices)) {
+            Real minBlockParams[BlockParams::N_VELOCITY_BLOCK_PARAMS];
+            Real maxBlockParams[BlockParams::N_VELOCITY_BLOCK_PARAMS];
+            vmesh.getBlockInfo(vmesh.getGlobalID(0,minIndices[0],minIndices[1],minIndices[2]),minBlockParams);
+            vmesh.getBlockInfo(vmesh.getGlobalID(0,maxIndices[0],maxIndices[1],maxIndices[2]),maxBlockParams);
+            const Real cellSizes[3] = {dx,dy,dz};
+            for (int d=0; d<3; ++d) {
+               const Real Vmin = minBlockParams[BlockParams::VXCRD+d] + HALF*minBlockParams[BlockParams::DVX+d] + EPS;
+               const Real Vmax = maxBlockParams[BlockParams::VXCRD+d] + (WID-1+HALF)*maxBlockParams[BlockParams::DVX+d] + EPS;
+               popMaxRDt = min(popMaxRDt,min(cellSizes[d]/fabs(Vmin),cellSizes[d]/fabs(Vmax)));
+            }
+         }
+         #else
          vmesh::VelocityBlockContainer<vmesh::LocalID>& blockContainer = cell->get_velocity_blocks(popID);
          const Real* blockParams = blockContainer.getParameters();
-         const Real EPS = numeric_limits<Real>::min()*1000;
-         for (vmesh::LocalID blockLID=0; blockLID<blockContainer.size(); ++blockLID) {
+         const vmesh::LocalID nBlocks = blockContainer.size();
+         #pragma omp simd reduction(min:popMaxRDt)
+         for (vmesh::LocalID blockLID=0; blockLID<nBlocks; ++blockLID) {
+            const Real* params = blockParams + blockLID*BlockParams::N_VELOCITY_BLOCK_PARAMS;
             for (unsigned int i=0; i<WID;i+=WID-1) {
-                const Real Vx
-                  = blockParams[blockLID*BlockParams::N_VELOCITY_BLOCK_PARAMS+BlockParams::VXCRD]
-                  + (i+HALF)*blockParams[blockLID*BlockParams::N_VELOCITY_BLOCK_PARAMS+BlockParams::DVX]
-                  + EPS;
-                const Real Vy
-                  = blockParams[blockLID*BlockParams::N_VELOCITY_BLOCK_PARAMS+BlockParams::VYCRD]
-                  + (i+HALF)*blockParams[blockLID*BlockParams::N_VELOCITY_BLOCK_PARAMS+BlockParams::DVY]
-                  + EPS;
-                const Real Vz
-                  = blockParams[blockLID*BlockParams::N_VELOCITY_BLOCK_PARAMS+BlockParams::VZCRD]
-                  + (i+HALF)*blockParams[blockLID*BlockParams::N_VELOCITY_BLOCK_PARAMS+BlockParams::DVZ]
-                  + EPS;
-
-                const Real dt_max_cell = min(dx/fabs(Vx),min(dy/fabs(Vy),dz/fabs(Vz)));
-                cell->parameters[CellParams::MAXRDT] = min(dt_max_cell,cell->parameters[CellParams::MAXRDT]);
-                cell->set_max_r_dt(popID,min(dt_max_cell,cell->get_max_r_dt(popID)));
-             }
+               const Real Vx = params[BlockParams::VXCRD] + (i+HALF)*params[BlockParams::DVX] + EPS;
+               const Real Vy = params[BlockParams::VYCRD] + (i+HALF)*params[BlockParams::DVY] + EPS;
+               const Real Vz = params[BlockParams::VZCRD] + (i+HALF)*params[BlockParams::DVZ] + EPS;
+
+               const Real dt_max_cell = min(dx/fabs(Vx),min(dy/fabs(Vy),dz/fabs(Vz)));
+               popMaxRDt = min(dt_max_cell,popMaxRDt);
+            }
          }
+         #endif
+         cell->set_max_r_dt(popID,popMaxRDt);
+         cellMaxRDt = min(popMaxRDt,cellMaxRDt);
       }
-
+      cell->parameters[CellParams::MAXRDT] = cellMaxRDt;
 
       if ( cell->sysBoundaryFlag == sysboundarytype::NOT_SYSBOUNDARY ||
            (cell->sysBoundaryLayer == 1 && cell->sysBoundaryFlag != sysboundarytype::NOT_SYSBOUNDARY )) {
          //spatial fluxes computed also for boundary cells
-         dtMaxLocal[0]=min(dtMaxLocal[0], cell->parameters[CellParams::MAXRDT]);
+         dtMaxLocalR=min(dtMaxLocalR, cell->parameters[CellParams::MAXRDT]);
       }
 
       if (cell->sysBoundaryFlag == sysboundarytype::NOT_SYSBOUNDARY && cell->parameters[CellParams::MAXVDT] != 0) {
          //Acceleration only done on non-boundary cells
-         dtMaxLocal[1]=min(dtMaxLocal[1], cell->parameters[CellParams::MAXVDT]);
+         dtMaxLocalV=min(dtMaxLocalV, cell->parameters[CellParams::MAXVDT]);
       }
    }
+   dtMaxLocal[0] = dtMaxLocalR;
+   dtMaxLocal[1] = dtMaxLocalV;
+   phiprof::stop("compute-timestep-vlasov",cells.size(),"Spatial Cells");
 
    //compute max dt for fieldsolver
+   phiprof::start("compute-timestep-fieldsolver");
    int* gridDims(technicalGrid.getLocalSize());
+   Real dtMaxLocalFs = dtMaxLocal[2];
+   #pragma omp parallel for collapse(2) reduction(min:dtMaxLocalFs)
    for (int k=0; k<gridDims[2]; k++) {
       for (int j=0; j<gridDims[1]; j++) {
          for (int i=0; i<gridDims[0]; i++) {
             fsgrids::technical cell = technicalGrid.get(i,j,k,0);
             if ( cell.sysBoundaryFlag == sysboundarytype::NOT_SYSBOUNDARY ||
                 (cell.sysBoundaryLayer == 1 && cell.sysBoundaryFlag != sysboundarytype::NOT_SYSBOUNDARY )) {
-               dtMaxLocal[2]=min(dtMaxLocal[2], cell.maxFsDt);
+               dtMaxLocalFs=min(dtMaxLocalFs, cell.maxFsDt);
             }
          }
       }
    }
-
-
+   dtMaxLocal[2] = dtMaxLocalFs;
+   phiprof::stop("compute-timestep-fieldsolver");
 
    MPI_Allreduce(&(dtMaxLocal[0]), &(dtMaxGlobal[0]), 3, MPI_Type<Real>(), MPI_MIN, MPI_COMM_WORLD);
 
@@ -275,9 +303,15 @@ int main(int argn,char* args[]) {
    bool dtIsChanged;
 
 // Init MPI:
+   // Asynchronous bulk file writing (io.write_async) needs MPI_THREAD_MULTIPLE, which is only
+   // requested in builds with -DASYNC_IO. Otherwise it falls back to synchronous writes.
    int required=MPI_THREAD_FUNNELED;
    int provided;
-   MPI_Init_thread(&argn,&args,required,&provided);
+#ifdef ASYNC_IO
+   MPI_Init_thread(&argn,&args,MPI_THREAD_MULTIPLE,&provided);
+#else
+   MPI_Init_thread(&argn,&args,MPI_THREAD_FUNNELED,&provided);
+#endif
    if (required > provided){
       MPI_Comm_rank(MPI_COMM_WORLD,&myRank);
       if(myRank==MASTER_RANK)
@@ -384,6 +418,19 @@ int main(int argn,char* args[]) {
          logFile << "and 0";
       #endif
       logFile << " OpenMP threads per process" << endl << writeVerbose;
+      logFile << "(MAIN) Vlasov kernels use vectors of " << VECL << " x " << VPREC << "-byte values, compiled for ";
+      #if defined(__AVX512F__)
+         logFile << "AVX-512";
+      #elif defined(__AVX2__)
+         logFile << "AVX2";
+      #elif defined(__AVX__)
+         logFile << "AVX";
+      #elif defined(__SSE2__)
+         logFile << "SSE2";
+      #else
+         logFile << "the default instruction set";
+      #endif
+      logFile << endl << writeVerbose;
    }
    phiprof::stop("open logFile & diagnostic");
 
@@ -881,6 +928,7 @@ int main(int argn,char* args[]) {
          #pragma omp parallel for
          for (size_t c=0; c<cells.size(); ++c) {
             mpiGrid[cells[c]]->get_cell_parameters()[CellParams::LBWEIGHTCOUNTER] = 0;
+            mpiGrid[cells[c]]->get_cell_parameters()[CellParams::LBWEIGHTTIME] = 0;
          }
       }
 
@@ -925,8 +973,7 @@ int main(int argn,char* args[]) {
          phiprof::start("fsgrid-coupling-in");
          // Copy moments over into the fsgrid.
          //setupTechnicalFsGrid(mpiGrid, cells, technicalGrid);
-         feedMomentsIntoFsGrid(mpiGrid, cells, momentsGrid, technicalGrid, false);
-         feedMomentsIntoFsGrid(mpiGrid, cells, momentsDt2Grid, technicalGrid, true);
+         feedMomentsIntoFsGrid(mpiGrid, cells, momentsGrid, momentsDt2Grid, technicalGrid);
          phiprof::stop("fsgrid-coupling-in");
 
          propagateFields(
@@ -1015,6 +1062,8 @@ int main(int argn,char* args[]) {
 
    phiprof::stop("Simulation");
    phiprof::start("Finalization");
+   waitForAsyncWrites();
+   if (P::diagnosticInterval != 0) finalizeDiagnostic();
    if (P::propagateField ) {
       finalizeFieldPropagator();
    }
@@ -1061,6 +1110,7 @@ int main(int argn,char* args[]) {
    BgBGrid.finalize();
    volGrid.finalize();
    technicalGrid.finalize();
+   invalidateFsGridCoupling();
 
    MPI_Finalize();
    return 0;
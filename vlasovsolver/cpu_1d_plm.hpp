@@ -50,10 +50,10 @@ static ARCH_HOSTDEV inline void compute_plm_coeff(const Vec * const values, uint
 }
 
 /**** 
-      Define functions for Realf instead of Vec 
+      Define functions for Realv instead of Vec 
 ***/
 
-static ARCH_DEV inline void compute_plm_coeff(const Vec* const values, uint k, Realf a[2], const Realv threshold, const int index)
+static ARCH_DEV inline void compute_plm_coeff(const Vec* const values, uint k, Realv a[2], const Realv threshold, const int index)
 {
   // scale values closer to 1 for more accurate slope limiter calculation
   const Realv scale = 1./threshold;
@@ -61,7 +61,7 @@ static ARCH_DEV inline void compute_plm_coeff(const Vec* const values, uint k, R
   //Vec v_2 = values[k] * scale;
   //Vec v_3 = values[k + 1] * scale;
   //Vec d_cv = slope_limiter(v_1, v_2, v_3) * threshold;
-  const Realf d_cv = slope_limiter( values[k-1][index]*scale, values[k][index]*scale, values[k+1][index]*scale)*threshold;
+  const Realv d_cv = slope_limiter( values[k-1][index]*scale, values[k][index]*scale, values[k+1][index]*scale)*threshold;
   a[0] = values[k][index] - d_cv * 0.5;
   a[1] = d_cv * 0.5;
 }
@@ -57,18 +57,18 @@ static ARCH_HOSTDEV inline void compute_ppm_coeff(const Vec * const values, face
 }
 
 /**** 
-      Define functions for Realf instead of Vec 
+      Define functions for Realv instead of Vec 
 ***/
 
-static ARCH_DEV inline void compute_ppm_coeff(const Vec* const values, face_estimate_order order, uint k, Realf a[3], const Realv threshold, const int index)
+static ARCH_DEV inline void compute_ppm_coeff(const Vec* const values, face_estimate_order order, uint k, Realv a[3], const Realv threshold, const int index)
 {
-  Realf fv_l; //left face value
-  Realf fv_r; //right face value
+  Realv fv_l; //left face value
+  Realv fv_r; //right face value
   compute_filtered_face_values(values, k, order, fv_l, fv_r, threshold, index);
   //Coella et al, check for monotonicity
-  const Realf one_sixth(1.0/6.0);
-  Realf m_face = fv_l;
-  Realf p_face = fv_r;
+  const Realv one_sixth(1.0/6.0);
+  Realv m_face = fv_l;
+  Realv p_face = fv_r;
   m_face = ((p_face - m_face) * (values[k][index] - 0.5 * (m_face + p_face)) >
                   (p_face - m_face) * (p_face - m_face) * one_sixth) ?
                   3 * values[k][index] - 2 * p_face : m_face;
@@ -72,17 +72,17 @@ ARCH_HOSTDEV inline void compute_ppm_coeff_nonuniform(const Vec * const dv, cons
 
 
 /**** 
-      Define functions for Realf instead of Vec 
+      Define functions for Realv instead of Vec 
 ***/
 
-ARCH_DEV inline void compute_ppm_coeff_nonuniform(const Vec * const dv, const Vec * const values, face_estimate_order order, uint k, Realf a[3], const Realv threshold, const int index){
-   Realf fv_l; /*left face value*/
-   Realf fv_r; /*right face value*/
+ARCH_DEV inline void compute_ppm_coeff_nonuniform(const Vec * const dv, const Vec * const values, face_estimate_order order, uint k, Realv a[3], const Realv threshold, const int index){
+   Realv fv_l; /*left face value*/
+   Realv fv_r; /*right face value*/
    compute_filtered_face_values_nonuniform_conserving(dv, values, k, order, fv_l, fv_r, threshold, index); 
    
    //Coella et al, check for monotonicity   
-   Realf m_face = fv_l;
-   Realf p_face = fv_r;
+   Realv m_face = fv_l;
+   Realv p_face = fv_r;
 
    //std::cout << "value = " << values[k][0] << ", m_face = " << m_face[0] << ", p_face = " << p_face[0] << "\n";
    //std::cout << values[k][0] - m_face[0] << ", " << values[k][0] - p_face[0] << "\n";
@@ -178,47 +178,47 @@ static ARCH_HOSTDEV inline void compute_pqm_coeff(Vec *values, face_estimate_ord
 
 
 /**** 
-      Define functions for Realf instead of Vec 
+      Define functions for Realv instead of Vec 
 ***/
 
 /*make sure quartic polynomial is monotonic*/
-static ARCH_DEV inline void filter_pqm_monotonicity(Vec *values, uint k, Realf &fv_l, Realf &fv_r, Realf &fd_l, Realf &fd_r, const int index) {
+static ARCH_DEV inline void filter_pqm_monotonicity(Vec *values, uint k, Realv &fv_l, Realv &fv_r, Realv &fd_l, Realv &fd_r, const int index) {
    /*fixed values give to roots clearly outside [0,1], or nonexisting ones*/
    
    /*second derivative coefficients, eq 23 in white et al.*/
-   Realf b0 =   60.0 * values[k][index] - 24.0 * fv_r - 36.0 * fv_l + 3.0 * (fd_r - 3.0 * fd_l);
-   Realf b1 = -360.0 * values[k][index] + 36.0 * fd_l - 24.0 * fd_r + 168.0 * fv_r + 192.0 * fv_l;
-   Realf b2 =  360.0 * values[k][index] + 30.0 * (fd_r - fd_l) - 180.0 * (fv_l + fv_r);
+   Realv b0 =   60.0 * values[k][index] - 24.0 * fv_r - 36.0 * fv_l + 3.0 * (fd_r - 3.0 * fd_l);
+   Realv b1 = -360.0 * values[k][index] + 36.0 * fd_l - 24.0 * fd_r + 168.0 * fv_r + 192.0 * fv_l;
+   Realv b2 =  360.0 * values[k][index] + 30.0 * (fd_r - fd_l) - 180.0 * (fv_l + fv_r);
    /*let's compute sqrt value to be used for computing roots. If we
     take sqrt of negaitve numbers, then we instead set a value that
     will make the root to be +-100 which is well outside range
     of[0,1]. We do not catch FP exceptions, so sqrt(negative) are okish (add
     a max(val_to_sqrt,0) if not*/
-   const Realf val_to_sqrt = b1 * b1 - 4 * b0 * b2;
-   const Realf sqrt_val = (val_to_sqrt < 0.0) ?
+   const Realv val_to_sqrt = b1 * b1 - 4 * b0 * b2;
+   const Realv sqrt_val = (val_to_sqrt < 0.0) ?
                                b1 + 200.0 * b2 :
                                sqrt(val_to_sqrt);
    //compute roots. Division is safe with vectorclass (=inf)
-   const Realf root1 = (b2 != 0) ? (-b1 + sqrt_val) / (2 * b2) : 0;
-   const Realf root2 = (b2 != 0) ? (-b1 - sqrt_val) / (2 * b2) : 0;
+   const Realv root1 = (b2 != 0) ? (-b1 + sqrt_val) / (2 * b2) : 0;
+   const Realv root2 = (b2 != 0) ? (-b1 - sqrt_val) / (2 * b2) : 0;
 
    /*PLM slope, MC limiter*/
-   Realf plm_slope_l = 2.0 * (values[k][index] - values[k - 1][index]);
-   Realf plm_slope_r = 2.0 * (values[k + 1][index] - values[k][index]);
-   Realf slope_sign = plm_slope_l + plm_slope_r; //it also has some magnitude, but we will only use its sign.
+   Realv plm_slope_l = 2.0 * (values[k][index] - values[k - 1][index]);
+   Realv plm_slope_r = 2.0 * (values[k + 1][index] - values[k][index]);
+   Realv slope_sign = plm_slope_l + plm_slope_r; //it also has some magnitude, but we will only use its sign.
    /*first derivative coefficients*/
-   const Realf c0 = fd_l;
-   const Realf c1 = b0;
-   const Realf c2 = b1 / 2.0;
-   const Realf c3 = b2 / 3.0;
+   const Realv c0 = fd_l;
+   const Realv c1 = b0;
+   const Realv c2 = b1 / 2.0;
+   const Realv c3 = b2 / 3.0;
    //compute both slopes at inflexion points, at least one of these
    //is with [0..1]. If the root is not in this range, we
    //simplify later if statements by setting it to the plm slope
    //sign
-   Realf root1_slope = (root1 >= 0.0 && root1 <= 1.0) ?
+   Realv root1_slope = (root1 >= 0.0 && root1 <= 1.0) ?
                              c0  + root1 * ( c1 + root1 * (c2 + root1 * c3 ) ) :
                              slope_sign;
-   Realf root2_slope = (root2 >= 0.0 && root2 <= 1.0) ?
+   Realv root2_slope = (root2 >= 0.0 && root2 <= 1.0) ?
                             c0  + root2 * ( c1 + root2 * (c2 + root2 * c3 ) ) :
                             slope_sign;
    bool fixInflexion = root1_slope * slope_sign < 0.0 || root2_slope * slope_sign < 0.0;
@@ -270,19 +270,19 @@ static ARCH_DEV inline void filter_pqm_monotonicity(Vec *values, uint k, Realf &
             fda_l =  20.0 * ( - valuesa + fva_r);
          }
       }
-      fv_l = (Realf)fva_l;
-      fd_l = (Realf)fda_l;
-      fv_r = (Realf)fva_r;
-      fd_r = (Realf)fda_r;
+      fv_l = (Realv)fva_l;
+      fd_l = (Realv)fda_l;
+      fv_r = (Realv)fva_r;
+      fd_r = (Realv)fda_r;
    }
 }
 
-static ARCH_DEV inline void compute_pqm_coeff(Vec *values, face_estimate_order order, uint k, Realf a[5], const Realv threshold, const int index)
+static ARCH_DEV inline void compute_pqm_coeff(Vec *values, face_estimate_order order, uint k, Realv a[5], const Realv threshold, const int index)
 {
-   Realf fv_l; /*left face value*/
-   Realf fv_r; /*right face value*/
-   Realf fd_l; /*left face derivative*/
-   Realf fd_r; /*right face derivative*/
+   Realv fv_l; /*left face value*/
+   Realv fv_r; /*right face value*/
+   Realv fd_l; /*left face derivative*/
+   Realv fd_r; /*right face derivative*/
 
    compute_filtered_face_values_derivatives(values, k, order, fv_l, fv_r, fd_l, fd_r, threshold, index);
    filter_pqm_monotonicity(values, k, fv_l, fv_r, fd_l, fd_r, index);
@@ -553,7 +553,7 @@ cog.outl("#endif")
          uint offset = 0;
          for (uint k=0; k<WID; ++k) {
             for(uint planeVector = 0; planeVector < VEC_PER_PLANE; planeVector++){
-               values[i_pcolumnv_b(planeVector, k, block_k, n_blocks)].load(data + offset);
+               load_realf(values[i_pcolumnv_b(planeVector, k, block_k, n_blocks)], data + offset);
                offset += VECL;
             }
          }
@@ -108,16 +108,25 @@ void inline swapBlockIndices(velocity_block_indices_t &blockIndices, const uint
    is the lagrangian departure grid (so th grid at timestep +dt,
    tracked backwards by -dt)
 
-   TODO: parallelize with openMP over block-columns. If one also
-   pre-creates new blocks in a separate loop first (serial operation),
-   then the openmp parallization would scale well (better than over
-   spatial cells), and would not need synchronization.
+   New target blocks are pre-created in a separate serial pass, after
+   which the block column sets can be mapped independently. If
+   splitColumnSets is true, they are mapped as OpenMP tasks; this is
+   meant for heavy cells, and needs to be called from within a parallel
+   region for the tasks to be shared among threads.
+
+   If recordBlockMaxValues is true, the maximum value of every target
+   block is recorded in the spatial cell right after the block has been
+   written, so that the content lists can be built without a separate
+   pass over the block data. Only the last mapping of an acceleration
+   step should record them.
    
 */
 bool map_1d(SpatialCell* spatial_cell,
             const uint popID,     
             Realv intersection, Realv intersection_di, Realv intersection_dj,Realv intersection_dk,
-            const uint dimension) {
+            const uint dimension,
+            const bool recordBlockMaxValues,
+            const bool splitColumnSets) {
    no_subnormals(); // Needed by Agner's vectorclass
 
    Realv dv,v_min;
@@ -129,6 +138,10 @@ bool map_1d(SpatialCell* spatial_cell,
    vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh    = spatial_cell->get_velocity_mesh(popID);
    vmesh::VelocityBlockContainer<vmesh::LocalID>& blockContainer = spatial_cell->get_velocity_blocks(popID);
 
+   if (recordBlockMaxValues) {
+      spatial_cell->clear_block_max_values(popID);
+   }
+
    //nothing to do if no blocks
    if(vmesh.size() == 0 )
       return true;
@@ -194,51 +207,34 @@ bool map_1d(SpatialCell* spatial_cell,
    
    const Realv i_dv=1.0/dv;
 
-   // sort blocks according to dimension, and divide them into columns
-   vmesh::LocalID* blocks = new vmesh::LocalID[vmesh.size()];
-   std::vector<uint> columnBlockOffsets;
-   std::vector<uint> columnNumBlocks;
-   std::vector<uint> setColumnOffsets;
-   std::vector<uint> setNumColumns;
+   // sort blocks according to dimension, and divide them into columns. The
+   // decomposition is cached in the population and only recomputed if the
+   // block set has changed since the last acceleration along this dimension.
+   BlockColumnDecomposition& columns = spatial_cell->get_population(popID).accColumns[dimension];
+   sortBlocklistByDimension(vmesh, dimension, columns);
+   vmesh::GlobalID* blocks = columns.blocks.data();
+   const std::vector<uint>& columnBlockOffsets = columns.columnBlockOffsets;
+   const std::vector<uint>& columnNumBlocks = columns.columnNumBlocks;
+   const std::vector<uint>& setColumnOffsets = columns.setColumnOffsets;
+   const std::vector<uint>& setNumColumns = columns.setNumColumns;
    std::vector<int> columnMinBlockK;
    std::vector<int> columnMaxBlockK;
-   
-   sortBlocklistByDimension(vmesh, dimension, blocks,
-                            columnBlockOffsets, columnNumBlocks,
-                            setColumnOffsets, setNumColumns);
-   
-   // loop over block column sets  (all columns along the dimension with the other dimensions being equal )
-      
-/*   
-     values array used to store column data The max size is the worst
-     case scenario with every second block having content, creating up
-     to ( MAX_BLOCKS_PER_DIM / 2 + 1) columns with each needing three
-     blocks (two for padding)
-*/
-   Vec values[(3 * ( MAX_BLOCKS_PER_DIM / 2 + 1)) * WID3 / VECL];
-   /*pointers to target block datas*/
-   Realf *blockIndexToBlockData[MAX_BLOCKS_PER_DIM];
-   bool isTargetBlock[MAX_BLOCKS_PER_DIM];
-   bool isSourceBlock[MAX_BLOCKS_PER_DIM];
-
+   std::vector<vmesh::GlobalID> blocksToRemove;
+
+   // The mapping is done in three passes. First, the target blocks of all
+   // block column sets (all columns along the dimension with the other
+   // dimensions being equal) are computed and missing ones are created.
+   // The velocity mesh is not modified after that until all sets have been
+   // mapped, so that the sets can be mapped independently of each other.
+   // Finally, source blocks that are not target blocks are removed.
    for( uint setIndex=0; setIndex< setColumnOffsets.size(); ++setIndex) {
       uint8_t refLevel = 0;
-      //init 
+      bool isTargetBlock[MAX_BLOCKS_PER_DIM];
+      bool isSourceBlock[MAX_BLOCKS_PER_DIM];
       for (uint blockK = 0; blockK < MAX_BLOCKS_PER_DIM; blockK++){
-         blockIndexToBlockData[blockK] =  NULL;
          isTargetBlock[blockK] = false;
          isSourceBlock[blockK] = false;
       }
-      
-      //Load data into values array (this also zeroes the original data)
-      uint valuesColumnOffset = 0; //offset to values array for data in a column in this set
-      for(uint columnIndex = setColumnOffsets[setIndex]; columnIndex < setColumnOffsets[setIndex] + setNumColumns[setIndex] ; columnIndex ++){
-         const vmesh::LocalID n_cblocks = columnNumBlocks[columnIndex];
-         vmesh::GlobalID* cblocks = blocks + columnBlockOffsets[columnIndex]; //column blocks
-         loadColumnBlockData(vmesh, blockContainer, cblocks, n_cblocks, dimension, values + valuesColumnOffset);
-         valuesColumnOffset += (n_cblocks + 2) * (WID3/VECL); // there are WID3/VECL elements of type Vec per block
-      }
-
 
       /*need x,y coordinate of this column set of blocks, take it from first
         block in first column*/
@@ -350,8 +346,8 @@ bool map_1d(SpatialCell* spatial_cell,
          columnMaxBlockK.push_back(lastBlockIndexK);
       }
 
-      //now add target blocks that do not yet exist and remove source blocks
-      //that are not target blocks
+      //now add target blocks that do not yet exist, and record source blocks
+      //that are not target blocks for removal once all sets are mapped
       for (uint blockK = 0; blockK < MAX_BLOCKS_PER_DIM; blockK++){
          if(isTargetBlock[blockK] && !isSourceBlock[blockK] )  {
             const int targetBlock =
@@ -367,13 +363,54 @@ bool map_1d(SpatialCell* spatial_cell,
                setFirstBlockIndices[1] * block_indices_to_id[1] +
                blockK                  * block_indices_to_id[2];
 
-            spatial_cell->remove_velocity_block(targetBlock, popID);
+            blocksToRemove.push_back(targetBlock);
          }
       }
 
-     /*now store pointer to blocks, cannot do it at the same time as adding
-      them since they might move due to re-allocations or migrated when
-      removing blocks*/
+   }
+
+   // Map one set of block columns. Only touches the blocks of that set.
+   auto mapColumnSet = [&](const uint setIndex, std::vector<std::pair<vmesh::GlobalID,Realf> >& blockMaxValues) {
+      no_subnormals(); // Tasks may run on threads that have not set this yet
+      uint8_t refLevel = 0;
+/*   
+     values array used to store column data The max size is the worst
+     case scenario with every second block having content, creating up
+     to ( MAX_BLOCKS_PER_DIM / 2 + 1) columns with each needing three
+     blocks (two for padding)
+*/
+      Vec values[(3 * ( MAX_BLOCKS_PER_DIM / 2 + 1)) * WID3 / VECL];
+      /*pointers to target block datas*/
+      Realf *blockIndexToBlockData[MAX_BLOCKS_PER_DIM];
+      bool isTargetBlock[MAX_BLOCKS_PER_DIM];
+
+      //init 
+      for (uint blockK = 0; blockK < MAX_BLOCKS_PER_DIM; blockK++){
+         blockIndexToBlockData[blockK] =  NULL;
+         isTargetBlock[blockK] = false;
+      }
+      
+      //Load data into values array (this also zeroes the original data),
+      //and recover the target blocks recorded for each column
+      uint valuesColumnOffset = 0; //offset to values array for data in a column in this set
+      for(uint columnIndex = setColumnOffsets[setIndex]; columnIndex < setColumnOffsets[setIndex] + setNumColumns[setIndex] ; columnIndex ++){
+         const vmesh::LocalID n_cblocks = columnNumBlocks[columnIndex];
+         vmesh::GlobalID* cblocks = blocks + columnBlockOffsets[columnIndex]; //column blocks
+         loadColumnBlockData(vmesh, blockContainer, cblocks, n_cblocks, dimension, values + valuesColumnOffset);
+         valuesColumnOffset += (n_cblocks + 2) * (WID3/VECL); // there are WID3/VECL elements of type Vec per block
+         for (int blockK = columnMinBlockK[columnIndex]; blockK <= columnMaxBlockK[columnIndex]; blockK++){
+            isTargetBlock[blockK] = true;
+         }
+      }
+
+      velocity_block_indices_t setFirstBlockIndices;
+      vmesh.getIndices(blocks[columnBlockOffsets[setColumnOffsets[setIndex]]],
+                       refLevel, 
+                       setFirstBlockIndices[0], setFirstBlockIndices[1], setFirstBlockIndices[2]);
+      swapBlockIndices(setFirstBlockIndices, dimension);
+
+      /*now store pointer to blocks, all target blocks exist by now and
+        the mesh is not modified until all sets have been mapped*/
       for (int blockK = 0; blockK < MAX_BLOCKS_PER_DIM; blockK++){
          if(isTargetBlock[blockK])  {
             const int targetBlock =
@@ -386,258 +423,310 @@ bool map_1d(SpatialCell* spatial_cell,
          }
       }
       
+         // loop over columns in set and do the mapping
+         valuesColumnOffset = 0; //offset to values array for data in a column in this set
+         for(uint columnIndex = setColumnOffsets[setIndex]; columnIndex < setColumnOffsets[setIndex] + setNumColumns[setIndex] ; columnIndex ++){
+            const vmesh::LocalID n_cblocks = columnNumBlocks[columnIndex];
+            vmesh::GlobalID* cblocks = blocks + columnBlockOffsets[columnIndex]; //column blocks
       
-      
-      // loop over columns in set and do the mapping
-      valuesColumnOffset = 0; //offset to values array for data in a column in this set
-      for(uint columnIndex = setColumnOffsets[setIndex]; columnIndex < setColumnOffsets[setIndex] + setNumColumns[setIndex] ; columnIndex ++){
-         const vmesh::LocalID n_cblocks = columnNumBlocks[columnIndex];
-         vmesh::GlobalID* cblocks = blocks + columnBlockOffsets[columnIndex]; //column blocks
-      
-         // compute the common indices for this block column set
-         //First block in column
-         velocity_block_indices_t block_indices_begin;
-         uint8_t refLevel;
-         vmesh.getIndices(cblocks[0],refLevel,block_indices_begin[0],block_indices_begin[1],block_indices_begin[2]);
+            // compute the common indices for this block column set
+            //First block in column
+            velocity_block_indices_t block_indices_begin;
+            uint8_t refLevel;
+            vmesh.getIndices(cblocks[0],refLevel,block_indices_begin[0],block_indices_begin[1],block_indices_begin[2]);
          
-         // Switch block indices according to dimensions, the algorithm has
-         // been written for integrating along z.
-         swapBlockIndices(block_indices_begin, dimension);
+            // Switch block indices according to dimensions, the algorithm has
+            // been written for integrating along z.
+            swapBlockIndices(block_indices_begin, dimension);
 
-         /*  i,j,k are now relative to the order in which we copied data to the values array. 
-             After this point in the k,j,i loops there should be no branches based on dimensions
+            /*  i,j,k are now relative to the order in which we copied data to the values array. 
+                After this point in the k,j,i loops there should be no branches based on dimensions
           
-             Note that the i dimension is vectorized, and thus there are no loops over i
-         */
-         for (int j = 0; j < WID; j += VECL/WID){ 
-            // create vectors with the i and j indices in the vector position on the plane.
-            #if VECL == 4 && WID == 4
-            const Veci i_indices = Veci({0, 1, 2, 3});
-            const Veci j_indices = Veci({j, j, j, j});
-            #elif VECL == 4 && WID == 8
-            cerr << __FILE__ << ":" << __LINE__ << ": VECL == 4 && WID == 8 cannot work!" << endl;
-            abort();
-            #elif VECL == 8 && WID == 4
-            const Veci i_indices = Veci({0, 1, 2, 3,
-                     0, 1, 2, 3});
-            const Veci j_indices = Veci({j, j, j, j,
-                     j + 1, j + 1, j + 1, j + 1});
-            #elif VECL == 8 && WID == 8
-            const Veci i_indices = Veci({0, 1, 2, 3, 4, 5, 6, 7});
-            const Veci j_indices = Veci({j, j, j, j, j, j, j, j});
-            #elif VECL == 16 && WID == 4
-            const Veci i_indices = Veci({0, 1, 2, 3,
-                     0, 1, 2, 3,
-                     0, 1, 2, 3,
-                     0, 1, 2, 3});
-            const Veci j_indices = Veci({j, j, j, j,
-                     j + 1, j + 1, j + 1, j + 1,
-                     j + 2, j + 2, j + 2, j + 2,
-                     j + 3, j + 3, j + 3, j + 3});
-            #elif VECL == 16 && WID == 8
-            const Veci i_indices = Veci({0, 1, 2, 3, 4, 5, 6, 7,
-                     0, 1, 2, 3, 4, 5, 6, 7});
-            const Veci j_indices = Veci({j,   j,   j,   j,   j,   j,   j,   j,
-                     j+1, j+1, j+1, j+1, j+1, j+1, j+1, j+1});
-            #elif VECL == 16 && WID == 16
-            const Veci i_indices = Veci({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15});
-            const Veci j_indices = Veci({j, j, j, j, j, j, j, j, j, j,  j,  j,  j,  j,  j, j});
-            #elif VECL == 32 && WID == 4
-            cerr << __FILE__ << ":" << __LINE__ << ": VECL == 32 && WID == 4 cannot work, too long vector for one plane!" << endl;
-            abort();
-            #elif VECL == 32 && WID == 8
-            const Veci i_indices = Veci({0, 1, 2, 3, 4, 5, 6, 7,
-                     0, 1, 2, 3, 4, 5, 6, 7,
-                     0, 1, 2, 3, 4, 5, 6, 7,
-                     0, 1, 2, 3, 4, 5, 6, 7});
-            const Veci j_indices = Veci({j,   j,   j,   j,   j,   j,   j,   j,
-                     j+1, j+1, j+1, j+1, j+1, j+1, j+1, j+1,
-                     j+2, j+2, j+2, j+2, j+2, j+2, j+2, j+2,
-                     j+3, j+3, j+3, j+3, j+3, j+3, j+3, j+3});
-            #elif VECL == 64 && WID == 4
-            cerr << __FILE__ << ":" << __LINE__ << ": VECL == 64 && WID == 4 cannot work, too long vector for one plane!" << endl;
-            abort();
-            #elif VECL == 64 && WID == 8
-            const Veci i_indices = Veci({0, 1, 2, 3, 4, 5, 6, 7,
-                     0, 1, 2, 3, 4, 5, 6, 7,
-                     0, 1, 2, 3, 4, 5, 6, 7,
-                     0, 1, 2, 3, 4, 5, 6, 7,
-                     0, 1, 2, 3, 4, 5, 6, 7,
-                     0, 1, 2, 3, 4, 5, 6, 7,
-                     0, 1, 2, 3, 4, 5, 6, 7,
-                     0, 1, 2, 3, 4, 5, 6, 7});
-            const Veci j_indices = Veci({j,   j,   j,   j,   j,   j,   j,   j,
-                     j+1, j+1, j+1, j+1, j+1, j+1, j+1, j+1,
-                     j+2, j+2, j+2, j+2, j+2, j+2, j+2, j+2,
-                     j+3, j+3, j+3, j+3, j+3, j+3, j+3, j+3,
-                     j+4, j+4, j+4, j+4, j+4, j+4, j+4, j+4,
-                     j+5, j+5, j+5, j+5, j+5, j+5, j+5, j+5,
-                     j+6, j+6, j+6, j+6, j+6, j+6, j+6, j+6,
-                     j+7, j+7, j+7, j+7, j+7, j+7, j+7, j+7});
-            #else
-            cerr << __FILE__ << ":" << __LINE__ << ": Missing implementation for VECL=" << VECL << " and WID=" << WID << "!" << endl;
-            abort();
-            #endif
-
-            const Veci  target_cell_index_common =
-               i_indices * cell_indices_to_id[0] +
-               j_indices * cell_indices_to_id[1];
+                Note that the i dimension is vectorized, and thus there are no loops over i
+            */
+            for (int j = 0; j < WID; j += VECL/WID){ 
+               // create vectors with the i and j indices in the vector position on the plane.
+               #if VECL == 4 && WID == 4
+               const Veci i_indices = Veci({0, 1, 2, 3});
+               const Veci j_indices = Veci({j, j, j, j});
+               #elif VECL == 4 && WID == 8
+               cerr << __FILE__ << ":" << __LINE__ << ": VECL == 4 && WID == 8 cannot work!" << endl;
+               abort();
+               #elif VECL == 8 && WID == 4
+               const Veci i_indices = Veci({0, 1, 2, 3,
+                        0, 1, 2, 3});
+               const Veci j_indices = Veci({j, j, j, j,
+                        j + 1, j + 1, j + 1, j + 1});
+               #elif VECL == 8 && WID == 8
+               const Veci i_indices = Veci({0, 1, 2, 3, 4, 5, 6, 7});
+               const Veci j_indices = Veci({j, j, j, j, j, j, j, j});
+               #elif VECL == 16 && WID == 4
+               const Veci i_indices = Veci({0, 1, 2, 3,
+                        0, 1, 2, 3,
+                        0, 1, 2, 3,
+                        0, 1, 2, 3});
+               const Veci j_indices = Veci({j, j, j, j,
+                        j + 1, j + 1, j + 1, j + 1,
+                        j + 2, j + 2, j + 2, j + 2,
+                        j + 3, j + 3, j + 3, j + 3});
+               #elif VECL == 16 && WID == 8
+               const Veci i_indices = Veci({0, 1, 2, 3, 4, 5, 6, 7,
+                        0, 1, 2, 3, 4, 5, 6, 7});
+               const Veci j_indices = Veci({j,   j,   j,   j,   j,   j,   j,   j,
+                        j+1, j+1, j+1, j+1, j+1, j+1, j+1, j+1});
+               #elif VECL == 16 && WID == 16
+               const Veci i_indices = Veci({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15});
+               const Veci j_indices = Veci({j, j, j, j, j, j, j, j, j, j,  j,  j,  j,  j,  j, j});
+               #elif VECL == 32 && WID == 4
+               cerr << __FILE__ << ":" << __LINE__ << ": VECL == 32 && WID == 4 cannot work, too long vector for one plane!" << endl;
+               abort();
+               #elif VECL == 32 && WID == 8
+               const Veci i_indices = Veci({0, 1, 2, 3, 4, 5, 6, 7,
+                        0, 1, 2, 3, 4, 5, 6, 7,
+                        0, 1, 2, 3, 4, 5, 6, 7,
+                        0, 1, 2, 3, 4, 5, 6, 7});
+               const Veci j_indices = Veci({j,   j,   j,   j,   j,   j,   j,   j,
+                        j+1, j+1, j+1, j+1, j+1, j+1, j+1, j+1,
+                        j+2, j+2, j+2, j+2, j+2, j+2, j+2, j+2,
+                        j+3, j+3, j+3, j+3, j+3, j+3, j+3, j+3});
+               #elif VECL == 64 && WID == 4
+               cerr << __FILE__ << ":" << __LINE__ << ": VECL == 64 && WID == 4 cannot work, too long vector for one plane!" << endl;
+               abort();
+               #elif VECL == 64 && WID == 8
+               const Veci i_indices = Veci({0, 1, 2, 3, 4, 5, 6, 7,
+                        0, 1, 2, 3, 4, 5, 6, 7,
+                        0, 1, 2, 3, 4, 5, 6, 7,
+                        0, 1, 2, 3, 4, 5, 6, 7,
+                        0, 1, 2, 3, 4, 5, 6, 7,
+                        0, 1, 2, 3, 4, 5, 6, 7,
+                        0, 1, 2, 3, 4, 5, 6, 7,
+                        0, 1, 2, 3, 4, 5, 6, 7});
+               const Veci j_indices = Veci({j,   j,   j,   j,   j,   j,   j,   j,
+                        j+1, j+1, j+1, j+1, j+1, j+1, j+1, j+1,
+                        j+2, j+2, j+2, j+2, j+2, j+2, j+2, j+2,
+                        j+3, j+3, j+3, j+3, j+3, j+3, j+3, j+3,
+                        j+4, j+4, j+4, j+4, j+4, j+4, j+4, j+4,
+                        j+5, j+5, j+5, j+5, j+5, j+5, j+5, j+5,
+                        j+6, j+6, j+6, j+6, j+6, j+6, j+6, j+6,
+                        j+7, j+7, j+7, j+7, j+7, j+7, j+7, j+7});
+               #else
+               cerr << __FILE__ << ":" << __LINE__ << ": Missing implementation for VECL=" << VECL << " and WID=" << WID << "!" << endl;
+               abort();
+               #endif
+
+               const Veci  target_cell_index_common =
+                  i_indices * cell_indices_to_id[0] +
+                  j_indices * cell_indices_to_id[1];
        
-            const int target_block_index_common =
-               block_indices_begin[0] * block_indices_to_id[0] +
-               block_indices_begin[1] * block_indices_to_id[1];
+               const int target_block_index_common =
+                  block_indices_begin[0] * block_indices_to_id[0] +
+                  block_indices_begin[1] * block_indices_to_id[1];
        
-            /* 
-               intersection_min is the intersection z coordinate (z after
-               swaps that is) of the lowest possible z plane for each i,j
-               index (i in vector)
-            */
+               /* 
+                  intersection_min is the intersection z coordinate (z after
+                  swaps that is) of the lowest possible z plane for each i,j
+                  index (i in vector)
+               */
        
-            const Vec intersection_min =
-               intersection +
-               (block_indices_begin[0] * WID + to_realv(i_indices)) * intersection_di + 
-               (block_indices_begin[1] * WID + to_realv(j_indices)) * intersection_dj;
+               const Vec intersection_min =
+                  intersection +
+                  (block_indices_begin[0] * WID + to_realv(i_indices)) * intersection_di + 
+                  (block_indices_begin[1] * WID + to_realv(j_indices)) * intersection_dj;
             
-            /*compute some initial values, that are used to set up the
-             * shifting of values as we go through all blocks in
-             * order. See comments where they are shifted for
-             * explanations of their meaning*/
-            Vec v_r((WID * block_indices_begin[2]) * dv + v_min);
-            Vec lagrangian_v_r((v_r-intersection_min)/intersection_dk);
-#if VECTORCLASS_H >= 20000
-            Veci lagrangian_gk_r=truncatei(lagrangian_v_r);
-#else
-            Veci lagrangian_gk_r=truncate_to_int(lagrangian_v_r);
-#endif
-
-            /*compute location of min and max, this does not change for one
-             * column (or even for this set of intersections, and can be used
-             * to quickly compute max and min later on*/
-            //TODO, these can be computed much earlier, since they are
-            //identiacal for each set of intersections
-            int minGkIndex=0, maxGkIndex=0; // 0 for compiler
-            {
-               Realv maxV = std::numeric_limits<Realv>::min();
-               Realv minV = std::numeric_limits<Realv>::max();
-               for(int i = 0; i < VECL; i++) {
-                  if ( lagrangian_v_r[i] > maxV) {
-                     maxV = lagrangian_v_r[i];
-                     maxGkIndex = i;
-                  }
-                  if ( lagrangian_v_r[i] < minV) {
-                     minV = lagrangian_v_r[i];
-                     minGkIndex = i;
+               /*compute some initial values, that are used to set up the
+                * shifting of values as we go through all blocks in
+                * order. See comments where they are shifted for
+                * explanations of their meaning*/
+               Vec v_r((WID * block_indices_begin[2]) * dv + v_min);
+               Vec lagrangian_v_r((v_r-intersection_min)/intersection_dk);
+   #if VECTORCLASS_H >= 20000
+               Veci lagrangian_gk_r=truncatei(lagrangian_v_r);
+   #else
+               Veci lagrangian_gk_r=truncate_to_int(lagrangian_v_r);
+   #endif
+
+               /*compute location of min and max, this does not change for one
+                * column (or even for this set of intersections, and can be used
+                * to quickly compute max and min later on*/
+               //TODO, these can be computed much earlier, since they are
+               //identiacal for each set of intersections
+               int minGkIndex=0, maxGkIndex=0; // 0 for compiler
+               {
+                  Realv maxV = std::numeric_limits<Realv>::min();
+                  Realv minV = std::numeric_limits<Realv>::max();
+                  for(int i = 0; i < VECL; i++) {
+                     if ( lagrangian_v_r[i] > maxV) {
+                        maxV = lagrangian_v_r[i];
+                        maxGkIndex = i;
+                     }
+                     if ( lagrangian_v_r[i] < minV) {
+                        minV = lagrangian_v_r[i];
+                        minGkIndex = i;
+                     }
                   }
                }
-            }
             
             
-            // loop through all blocks in column and compute the mapping as integrals.
-            for (uint k=0; k < WID * n_cblocks; ++k ){
-               // Compute reconstructions 
-               // values + i_pcolumnv(n_cblocks, -1, j, 0) is the starting point of the column data for fixed j
-               // k + WID is the index where we have stored k index, WID amount of padding.
-               #ifdef ACC_SEMILAG_PLM
-               Vec a[2];
-               compute_plm_coeff(values + valuesColumnOffset + i_pcolumnv(j, 0, -1, n_cblocks), k + WID , a, spatial_cell->getVelocityBlockMinValue(popID));
-               #endif
-               #ifdef ACC_SEMILAG_PPM
-               Vec a[3];
-               compute_ppm_coeff(values + valuesColumnOffset + i_pcolumnv(j, 0, -1, n_cblocks), h4, k + WID, a, spatial_cell->getVelocityBlockMinValue(popID));
-               #endif
-               #ifdef ACC_SEMILAG_PQM
-               Vec a[5];
-               compute_pqm_coeff(values + valuesColumnOffset + i_pcolumnv(j, 0, -1, n_cblocks), h8, k + WID, a, spatial_cell->getVelocityBlockMinValue(popID));
-               #endif
-               
-               // set the initial value for the integrand at the boundary at v = 0 
-               // (in reduced cell units), this will be shifted to target_density_1, see below.
-               Vec target_density_r(0.0);
-               // v_l, v_r are the left and right velocity coordinates of source cell. Left is the old right.
-               Vec v_l = v_r; 
-               v_r += dv;
-               
-               // left(l) and right(r) k values (global index) in the target
-               // Lagrangian grid, the intersecting cells. Again old right is new left.
-               const Veci lagrangian_gk_l = lagrangian_gk_r;
-#if VECTORCLASS_H >= 20000
-               lagrangian_gk_r = truncatei((v_r-intersection_min)/intersection_dk);
-#else
-               lagrangian_gk_r = truncate_to_int((v_r-intersection_min)/intersection_dk);
-#endif
-               
-               //limits in lagrangian k for target column. Also take into
-               //account limits of target column
-               int minGk = std::max(int(lagrangian_gk_l[minGkIndex]), int(columnMinBlockK[columnIndex] * WID));
-               int maxGk = std::min(int(lagrangian_gk_r[maxGkIndex]), int((columnMaxBlockK[columnIndex] + 1) * WID - 1));
-               
-               for(int gk = minGk; gk <= maxGk; gk++){ 
-                  const int blockK = gk/WID;
-                  const int gk_mod_WID = (gk - blockK * WID);
-                  //the block of the Lagrangian cell to which we map
-                  const int target_block(target_block_index_common + blockK * block_indices_to_id[2]);
-                  
-                  //cell indices in the target block  (TODO: to be replaced by
-                  //compile time generated scatter write operation)
-                  const Veci target_cell(target_cell_index_common + gk_mod_WID * cell_indices_to_id[2]);
-               
-                  //the velocity between which we will integrate to put mass
-                  //in the targe cell. If both v_r and v_l are in same cell
-                  //then v_1,v_2 should be between v_l and v_r.
-                  //v_1 and v_2 normalized to be between 0 and 1 in the cell.
-                  //For vector elements where gk is already larger than needed (lagrangian_gk_r), v_2=v_1=v_r and thus the value is zero.
-                  const Vec v_norm_r = (  min(  max( (gk + 1) * intersection_dk + intersection_min, v_l), v_r) - v_l) * i_dv;
-                  /*shift, old right is new left*/
-                  const Vec target_density_l = target_density_r;
-
-                  // compute right integrand
+               // loop through all blocks in column and compute the mapping as integrals.
+               for (uint k=0; k < WID * n_cblocks; ++k ){
+                  // Compute reconstructions 
+                  // values + i_pcolumnv(n_cblocks, -1, j, 0) is the starting point of the column data for fixed j
+                  // k + WID is the index where we have stored k index, WID amount of padding.
                   #ifdef ACC_SEMILAG_PLM
-                  target_density_r =
-                     v_norm_r * ( a[0] + v_norm_r * a[1] );
+                  Vec a[2];
+                  compute_plm_coeff(values + valuesColumnOffset + i_pcolumnv(j, 0, -1, n_cblocks), k + WID , a, spatial_cell->getVelocityBlockMinValue(popID));
                   #endif
                   #ifdef ACC_SEMILAG_PPM
-                  target_density_r =
-                     v_norm_r * ( a[0] + v_norm_r * ( a[1] + v_norm_r * a[2] ) );
-
+                  Vec a[3];
+                  compute_ppm_coeff(values + valuesColumnOffset + i_pcolumnv(j, 0, -1, n_cblocks), h4, k + WID, a, spatial_cell->getVelocityBlockMinValue(popID));
                   #endif
                   #ifdef ACC_SEMILAG_PQM
-                  target_density_r =
-                     v_norm_r * ( a[0] + v_norm_r * ( a[1] + v_norm_r * ( a[2] + v_norm_r * ( a[3] + v_norm_r * a[4] ) ) ) );
+                  Vec a[5];
+                  compute_pqm_coeff(values + valuesColumnOffset + i_pcolumnv(j, 0, -1, n_cblocks), h8, k + WID, a, spatial_cell->getVelocityBlockMinValue(popID));
                   #endif
+               
+                  // set the initial value for the integrand at the boundary at v = 0 
+                  // (in reduced cell units), this will be shifted to target_density_1, see below.
+                  Vec target_density_r(0.0);
+                  // v_l, v_r are the left and right velocity coordinates of source cell. Left is the old right.
+                  Vec v_l = v_r; 
+                  v_r += dv;
+               
+                  // left(l) and right(r) k values (global index) in the target
+                  // Lagrangian grid, the intersecting cells. Again old right is new left.
+                  const Veci lagrangian_gk_l = lagrangian_gk_r;
+   #if VECTORCLASS_H >= 20000
+                  lagrangian_gk_r = truncatei((v_r-intersection_min)/intersection_dk);
+   #else
+                  lagrangian_gk_r = truncate_to_int((v_r-intersection_min)/intersection_dk);
+   #endif
+               
+                  //limits in lagrangian k for target column. Also take into
+                  //account limits of target column
+                  int minGk = std::max(int(lagrangian_gk_l[minGkIndex]), int(columnMinBlockK[columnIndex] * WID));
+                  int maxGk = std::min(int(lagrangian_gk_r[maxGkIndex]), int((columnMaxBlockK[columnIndex] + 1) * WID - 1));
+               
+                  for(int gk = minGk; gk <= maxGk; gk++){ 
+                     const int blockK = gk/WID;
+                     const int gk_mod_WID = (gk - blockK * WID);
+                     //the block of the Lagrangian cell to which we map
+                     const int target_block(target_block_index_common + blockK * block_indices_to_id[2]);
                   
-                  //store values, one element at a time. All blocks
-                  //have been created by now.
-                  //TODO replace by vector version & scatter & gather operation
+                     //cell indices in the target block  (TODO: to be replaced by
+                     //compile time generated scatter write operation)
+                     const Veci target_cell(target_cell_index_common + gk_mod_WID * cell_indices_to_id[2]);
+               
+                     //the velocity between which we will integrate to put mass
+                     //in the targe cell. If both v_r and v_l are in same cell
+                     //then v_1,v_2 should be between v_l and v_r.
+                     //v_1 and v_2 normalized to be between 0 and 1 in the cell.
+                     //For vector elements where gk is already larger than needed (lagrangian_gk_r), v_2=v_1=v_r and thus the value is zero.
+                     const Vec v_norm_r = (  min(  max( (gk + 1) * intersection_dk + intersection_min, v_l), v_r) - v_l) * i_dv;
+                     /*shift, old right is new left*/
+                     const Vec target_density_l = target_density_r;
+
+                     // compute right integrand
+                     #ifdef ACC_SEMILAG_PLM
+                     target_density_r =
+                        v_norm_r * ( a[0] + v_norm_r * a[1] );
+                     #endif
+                     #ifdef ACC_SEMILAG_PPM
+                     target_density_r =
+                        v_norm_r * ( a[0] + v_norm_r * ( a[1] + v_norm_r * a[2] ) );
+
+                     #endif
+                     #ifdef ACC_SEMILAG_PQM
+                     target_density_r =
+                        v_norm_r * ( a[0] + v_norm_r * ( a[1] + v_norm_r * ( a[2] + v_norm_r * ( a[3] + v_norm_r * a[4] ) ) ) );
+                     #endif
                   
+                     //store values, one element at a time. All blocks
+                     //have been created by now.
+                     //TODO replace by vector version & scatter & gather operation
                   
-                  if(dimension == 2) {
-                     Realf* targetDataPointer = blockIndexToBlockData[blockK] + j * cell_indices_to_id[1] + gk_mod_WID * cell_indices_to_id[2];
-                     Vec targetData;
-                     targetData.load_a(targetDataPointer);
-                     targetData += target_density_r - target_density_l;                  
-                     targetData.store_a(targetDataPointer);
-                  }
-                  else{
-                     // total value of integrand
-                     const Vec target_density = target_density_r - target_density_l;                  
-#pragma ivdep
-#pragma GCC ivdep                     
-                     for (int target_i=0; target_i < VECL; ++target_i) {
-                        // do the conversion from Realv to Realf here, faster than doing it in accumulation
-                        const Realf tval = target_density[target_i];
-                        const uint tcell = target_cell[target_i];
-                        blockIndexToBlockData[blockK][tcell] += tval;
-                     }  // for-loop over vector elements
-                  }
                   
-               } // for loop over target k-indices of current source block
-            } // for-loop over source blocks
-         } //for loop over j index
-         valuesColumnOffset += (n_cblocks + 2) * (WID3/VECL) ;// there are WID3/VECL elements of type Vec per block    
-      } //for loop over columns
-      
+                     if(dimension == 2) {
+                        Realf* targetDataPointer = blockIndexToBlockData[blockK] + j * cell_indices_to_id[1] + gk_mod_WID * cell_indices_to_id[2];
+                        Vec targetData;
+                        load_realf_a(targetData, targetDataPointer);
+                        targetData += target_density_r - target_density_l;                  
+                        store_realf_a(targetData, targetDataPointer);
+                     }
+                     else{
+                        // total value of integrand
+                        const Vec target_density = target_density_r - target_density_l;                  
+   #pragma ivdep
+   #pragma GCC ivdep                     
+                        for (int target_i=0; target_i < VECL; ++target_i) {
+#ifdef HPF
+                           // with 16-bit storage accumulate in full precision, so that the value is rounded only once
+                           const Realv tval = target_density[target_i];
+#else
+                           // do the conversion from Realv to Realf here, faster than doing it in accumulation
+                           const Realf tval = target_density[target_i];
+#endif
+                           const uint tcell = target_cell[target_i];
+                           blockIndexToBlockData[blockK][tcell] += tval;
+                        }  // for-loop over vector elements
+                     }
+                  
+                  } // for loop over target k-indices of current source block
+               } // for-loop over source blocks
+            } //for loop over j index
+            valuesColumnOffset += (n_cblocks + 2) * (WID3/VECL) ;// there are WID3/VECL elements of type Vec per block    
+         } //for loop over columns
+
+      // All columns of the set have been mapped, the target blocks of the
+      // set are final and still in cache.
+      if (recordBlockMaxValues) {
+         for (int blockK = 0; blockK < MAX_BLOCKS_PER_DIM; blockK++){
+            if(isTargetBlock[blockK])  {
+               const int targetBlock =
+                  setFirstBlockIndices[0] * block_indices_to_id[0] +
+                  setFirstBlockIndices[1] * block_indices_to_id[1] +
+                  blockK                  * block_indices_to_id[2];
+               const Realf* data = blockIndexToBlockData[blockK];
+               Realf maxValue = data[0];
+               for (uint i = 1; i < WID3; ++i) {
+                  maxValue = std::max(maxValue, data[i]);
+               }
+               blockMaxValues.push_back(std::make_pair(targetBlock, maxValue));
+            }
+         }
+      }
+   };
+
+   if (splitColumnSets) {
+      // Sets are mapped as tasks, picked up by idle threads of the enclosing
+      // parallel region. The maxima are collected per set so that they are
+      // recorded in the same order as in the serial case.
+      std::vector<std::vector<std::pair<vmesh::GlobalID,Realf> > > setBlockMaxValues(setColumnOffsets.size());
+      #pragma omp taskloop grainsize(4) default(shared)
+      for (uint setIndex=0; setIndex < setColumnOffsets.size(); ++setIndex) {
+         mapColumnSet(setIndex, setBlockMaxValues[setIndex]);
+      }
+      for (uint setIndex=0; setIndex < setColumnOffsets.size(); ++setIndex) {
+         for (const auto& blockMaxValue : setBlockMaxValues[setIndex]) {
+            spatial_cell->record_block_max_value(blockMaxValue.first, blockMaxValue.second);
+         }
+      }
+   } else {
+      std::vector<std::pair<vmesh::GlobalID,Realf> > blockMaxValues;
+      for (uint setIndex=0; setIndex < setColumnOffsets.size(); ++setIndex) {
+         mapColumnSet(setIndex, blockMaxValues);
+         for (const auto& blockMaxValue : blockMaxValues) {
+            spatial_cell->record_block_max_value(blockMaxValue.first, blockMaxValue.second);
+         }
+         blockMaxValues.clear();
+      }
+   }
+
+   for (const vmesh::GlobalID blockGID : blocksToRemove) {
+      spatial_cell->remove_velocity_block(blockGID, popID);
    }
-   delete [] blocks;
+   if (recordBlockMaxValues) {
+      spatial_cell->finish_block_max_values();
+   }
+
    return true;
 }
-
@@ -29,5 +29,7 @@ using namespace spatial_cell;
 
 bool map_1d(SpatialCell* spatial_cell, const uint popID,
             Realv intersection, Realv intersection_di, Realv intersection_dj,Realv intersection_dk,
-            const uint dimension);
+            const uint dimension,
+            const bool recordBlockMaxValues = false,
+            const bool splitColumnSets = false);
 #endif
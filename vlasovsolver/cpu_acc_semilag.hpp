@@ -35,7 +35,8 @@ void cpu_accelerate_cell(
         spatial_cell::SpatialCell* spatial_cell,
         const uint popID,
         const uint map_order,
-        const Real& dt);
+        const Real& dt,
+        const bool splitColumnSets = false);
 
 #endif
 
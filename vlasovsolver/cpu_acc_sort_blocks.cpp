@@ -31,110 +31,111 @@
 using namespace std;
 using namespace spatial_cell;
 
-// Comparator function for sorting vector of pairs
-inline bool paircomparator( const std::pair<uint, uint> & l, const std::pair<uint, uint> & r ) {
-   return l.first < r.first;
-}
-
 /*
-   This function returns a sorted list of blocks in a cell.
-
-   The sorted list is sorted according to the location, along the given dimension.
-   
+   Sort the blocks by their global ID mapped to the coordinate system where
+   the given dimension is the fastest-running index. The mapped IDs are
+   unique and bounded by the grid size, so an LSD radix sort with 8-bit
+   digits orders them in linear time. The scratch arrays are kept per thread
+   so that they are only allocated once.
 */
-#warning "unfinished documentation"
-void sortBlocklistByDimension( //const spatial_cell::SpatialCell* spatial_cell,
-                               const vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh,
-                               const uint dimension,
-                               uint* blocks,
-                               std::vector<uint> & columnBlockOffsets,
-                               std::vector<uint> & columnNumBlocks,
-                               std::vector<uint> & setColumnOffsets,
-                               std::vector<uint> & setNumColumns) {
-   //const uint nBlocks = spatial_cell->get_number_of_velocity_blocks(); // Number of blocks
+static void radixSortMappedBlocks(const vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh,
+                                  const uint dimension,
+                                  std::vector<vmesh::GlobalID>& keys,
+                                  std::vector<vmesh::GlobalID>& blocks) {
+   static thread_local std::vector<vmesh::GlobalID> keyScratch;
+   static thread_local std::vector<vmesh::GlobalID> blockScratch;
+   
    const vmesh::LocalID nBlocks = vmesh.size();
+   const vmesh::LocalID* gridLength = vmesh.getGridLength(0);
+   const vmesh::GlobalID nx = gridLength[0];
+   const vmesh::GlobalID ny = gridLength[1];
+   const vmesh::GlobalID nz = gridLength[2];
 
-   // Velocity mesh refinement level, has no effect here
-   // but is needed in some vmesh::VelocityMesh function calls.
-   const uint8_t REFLEVEL = 0;
-   
-   // Copy block data to vector
-   std::vector<std::pair<vmesh::GlobalID,vmesh::GlobalID> > block_pairs;
-   block_pairs.resize( nBlocks );
-   for (vmesh::LocalID i = 0; i < nBlocks; ++i ) {
-      //const vmesh::GlobalID block = spatial_cell->get_velocity_block_global_id(i);
+   keys.resize(nBlocks);
+   blocks.resize(nBlocks);
+   vmesh::GlobalID maxKey = 0;
+   for (vmesh::LocalID i = 0; i < nBlocks; ++i) {
       const vmesh::GlobalID block = vmesh.getGlobalID(i);
-      switch( dimension ) {
-       case 0: {
-          const vmesh::GlobalID blockId_mapped = block; // Mapping the block id to different coordinate system if dimension is not zero:
-          block_pairs[i] = std::make_pair( blockId_mapped, block );
-       }
-         break;
-       case 1: {
-          // Do operation: 
-          //   block = x + y*x_max + z*y_max*x_max 
-          //=> block' = block - (x + y*x_max) + y + x*y_max = x + y*x_max + z*y_max*x_max - (x + y*x_max) + y + x*y_max
-          //          = y + x*y_max + z*y_max*x_max
-          //const uint x_indice = block%SpatialCell::get_velocity_grid_length()[0];
-          //const uint y_indice = (block/SpatialCell::get_velocity_grid_length()[0])%SpatialCell::SpatialCell::get_velocity_grid_length()[1];
-          const vmesh::LocalID x_index = block % vmesh.getGridLength(REFLEVEL)[0];
-          const vmesh::LocalID y_index = (block / vmesh.getGridLength(REFLEVEL)[0]) % vmesh.getGridLength(REFLEVEL)[1];
-
-          // Mapping the block id to different coordinate system if dimension is not zero:
-          //const uint blockId_mapped 
-          //        = block - (x_indice + y_indice*SpatialCell::get_velocity_grid_length()[0]) 
-          //        + y_indice 
-          //        + x_indice * SpatialCell::SpatialCell::get_velocity_grid_length()[1];
-          const vmesh::GlobalID blockId_mapped 
-                  = block - (x_index + y_index*vmesh.getGridLength(REFLEVEL)[0])
-                  + y_index 
-                  + x_index * vmesh.getGridLength(REFLEVEL)[1];
-          block_pairs[i] = std::make_pair( blockId_mapped, block );
-       }
-         break;
-       case 2: {
-          // Do operation: 
-          //   block = x + y*x_max + z*y_max*x_max 
-          //=> block' = z + y*z_max + x*z_max*y_max
-          //const uint x_indice = block%SpatialCell::get_velocity_grid_length()[0];
-          //const uint y_indice = (block/SpatialCell::get_velocity_grid_length()[0])%SpatialCell::SpatialCell::get_velocity_grid_length()[1];
-          //const uint z_indice =  (block/(SpatialCell::get_velocity_grid_length()[0]*SpatialCell::SpatialCell::get_velocity_grid_length()[1]));
-          const vmesh::LocalID x_index = block % vmesh.getGridLength(REFLEVEL)[0];
-          const vmesh::LocalID y_index = (block / vmesh.getGridLength(REFLEVEL)[0]) % vmesh.getGridLength(REFLEVEL)[1];
-          const vmesh::LocalID z_index = (block / (vmesh.getGridLength(REFLEVEL)[0]*vmesh.getGridLength(REFLEVEL)[1]));
+      vmesh::GlobalID key = block;
+      if (dimension > 0) {
+         // block = x + y*nx + z*nx*ny
+         const vmesh::GlobalID xy = block / nx;
+         const vmesh::GlobalID x = block - xy*nx;
+         const vmesh::GlobalID z = xy / ny;
+         const vmesh::GlobalID y = xy - z*ny;
+         if (dimension == 1) key = y + x*ny + z*nx*ny; // y + x*y_max + z*y_max*x_max
+         else                key = z + y*nz + x*ny*nz; // z + y*z_max + x*z_max*y_max
+      }
+      keys[i] = key;
+      blocks[i] = block;
+      maxKey = std::max(maxKey,key);
+   }
 
-          // Mapping the block id to different coordinate system if dimension is not zero:
-          //const uint blockId_mapped 
-          //  = z_indice 
-          //  + y_indice * SpatialCell::SpatialCell::get_velocity_grid_length()[2] 
-          //  + x_indice*SpatialCell::SpatialCell::get_velocity_grid_length()[1]*SpatialCell::SpatialCell::get_velocity_grid_length()[2];
-          const vmesh::GlobalID blockId_mapped 
-            = z_index 
-            + y_index*vmesh.getGridLength(REFLEVEL)[2]
-            + x_index*vmesh.getGridLength(REFLEVEL)[1]*vmesh.getGridLength(REFLEVEL)[2];
-          block_pairs[i] = std::make_pair( blockId_mapped, block );
-       }
-         break;
+   keyScratch.resize(nBlocks);
+   blockScratch.resize(nBlocks);
+   for (uint shift = 0; shift < 8*sizeof(vmesh::GlobalID) && (maxKey >> shift) > 0; shift += 8) {
+      vmesh::LocalID counts[256] = {0};
+      for (vmesh::LocalID i = 0; i < nBlocks; ++i) ++counts[(keys[i] >> shift) & 0xFF];
+      vmesh::LocalID offset = 0;
+      for (uint digit = 0; digit < 256; ++digit) {
+         const vmesh::LocalID count = counts[digit];
+         counts[digit] = offset;
+         offset += count;
+      }
+      for (vmesh::LocalID i = 0; i < nBlocks; ++i) {
+         const vmesh::LocalID target = counts[(keys[i] >> shift) & 0xFF]++;
+         keyScratch[target] = keys[i];
+         blockScratch[target] = blocks[i];
       }
+      keys.swap(keyScratch);
+      blocks.swap(blockScratch);
    }
-   // Sort the list:
-   std::sort( block_pairs.begin(), block_pairs.end(), paircomparator );
+}
+
+/*
+   This function returns a sorted list of blocks in a cell.
 
-   // Put in the sorted blocks, and also compute column offsets and lengths:
+   The sorted list is sorted according to the location, along the given
+   dimension, and divided into columns (consecutive blocks along the
+   dimension) and column sets (all columns with the same indices in the
+   other two dimensions). The result only depends on the set of blocks, so
+   it is not recomputed if the block set version of the mesh matches the one
+   stored in columns.
+*/
+void sortBlocklistByDimension(const vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh,
+                              const uint dimension,
+                              BlockColumnDecomposition& columns) {
+   const uint64_t blockSetVersion = vmesh.getBlockSetVersion();
+   if (columns.blockSetVersion == blockSetVersion) return;
+   
+   static thread_local std::vector<vmesh::GlobalID> mappedBlocks;
+   radixSortMappedBlocks(vmesh, dimension, mappedBlocks, columns.blocks);
+
+   const vmesh::LocalID nBlocks = vmesh.size();
+   const vmesh::GlobalID dimLength = vmesh.getGridLength(0)[dimension];
+   std::vector<uint>& columnBlockOffsets = columns.columnBlockOffsets;
+   std::vector<uint>& columnNumBlocks = columns.columnNumBlocks;
+   std::vector<uint>& setColumnOffsets = columns.setColumnOffsets;
+   std::vector<uint>& setNumColumns = columns.setNumColumns;
+   columnBlockOffsets.clear();
+   columnNumBlocks.clear();
+   setColumnOffsets.clear();
+   setNumColumns.clear();
+   columns.blockSetVersion = blockSetVersion;
+   if (nBlocks == 0) return;
+
+   // Compute column offsets and lengths:
    columnBlockOffsets.push_back(0); //first offset
    setColumnOffsets.push_back(0); //first offset   
-   uint prev_column_id, prev_dimension_id;
+   vmesh::GlobalID prev_column_id = 0, prev_dimension_id = 0;
 
    for (vmesh::LocalID i=0; i<nBlocks; ++i) {
-       // identifies a particular column
-       vmesh::LocalID column_id = block_pairs[i].first / vmesh.getGridLength(REFLEVEL)[dimension];     
-       
-       // identifies a particular block in a column (along the dimension)
-       vmesh::LocalID dimension_id = block_pairs[i].first % vmesh.getGridLength(REFLEVEL)[dimension];
+      // identifies a particular column
+      const vmesh::GlobalID column_id = mappedBlocks[i] / dimLength;
+      
+      // identifies a particular block in a column (along the dimension)
+      const vmesh::GlobalID dimension_id = mappedBlocks[i] - column_id*dimLength;
       
-       //sorted list
-       blocks[i] = block_pairs[i].second;
-
       if ( i > 0 &&  ( column_id != prev_column_id || dimension_id != (prev_dimension_id + 1) )){
          //encountered new column! For i=0, we already entered the correct offset (0).
          //We also identify it as a new column if there is a break in the column (e.g., gap between two populations)
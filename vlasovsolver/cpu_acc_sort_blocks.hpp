@@ -29,13 +29,8 @@
 #include "../common.h"
 #include "../spatial_cell.hpp"
 
-void sortBlocklistByDimension( //const spatial_cell::SpatialCell* spatial_cell, 
-                               const vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh,
-                               const uint dimension,
-                               uint* blocks,
-                               std::vector<uint> & columnBlockOffsets,
-                               std::vector<uint> & columnNumBlocks,
-                               std::vector<uint> & setColumnOffsets,
-                               std::vector<uint> & setNumColumns);
+void sortBlocklistByDimension(const vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh,
+                              const uint dimension,
+                              spatial_cell::BlockColumnDecomposition& columns);
 
 #endif
@@ -533,13 +533,13 @@ ARCH_HOSTDEV inline void compute_filtered_face_values_nonuniform_conserving(cons
 
 
 /**** 
-      Define functions for Realf instead of Vec 
+      Define functions for Realv instead of Vec 
 ***/
 
 
 
 
-ARCH_DEV inline void compute_h8_left_face_value(const Vec * const values, uint k, Realf &fv_l, const int index)
+ARCH_DEV inline void compute_h8_left_face_value(const Vec * const values, uint k, Realv &fv_l, const int index)
 {
    fv_l = 1.0/840.0 * (
               - 3.0 * values[k - 4][index]
@@ -551,7 +551,7 @@ ARCH_DEV inline void compute_h8_left_face_value(const Vec * const values, uint k
               + 29.0 * values[k + 2][index]
               - 3.0 * values[k + 3][index]);
 }
-ARCH_DEV inline void compute_h7_left_face_derivative(const Vec * const values, uint k, Realf &fd_l, const int index){
+ARCH_DEV inline void compute_h7_left_face_derivative(const Vec * const values, uint k, Realv &fd_l, const int index){
     fd_l = 1.0/5040.0 * (
        + 9.0 * values[k - 4][index]
        - 119.0 * values[k - 3][index]
@@ -562,7 +562,7 @@ ARCH_DEV inline void compute_h7_left_face_derivative(const Vec * const values, u
        + 119.0 * values[k + 2][index]
        - 9.0 * values[k + 3][index]);
 }
-ARCH_DEV inline void compute_h6_left_face_value(const Vec * const values, uint k, Realf &fv_l, const int index)
+ARCH_DEV inline void compute_h6_left_face_value(const Vec * const values, uint k, Realv &fv_l, const int index)
 {
   //compute left value
    fv_l = 1.0/60.0 * (values[k - 3][index]
@@ -572,13 +572,13 @@ ARCH_DEV inline void compute_h6_left_face_value(const Vec * const values, uint k
             - 8.0 * values[k + 1][index]
             + values[k + 2][index]);
 }
-ARCH_DEV inline void compute_h5_left_face_derivative(const Vec * const values, uint k, Realf &fd_l, const int index)
+ARCH_DEV inline void compute_h5_left_face_derivative(const Vec * const values, uint k, Realv &fd_l, const int index)
 {
   fd_l = 1.0/180.0 * (245 * (values[k][index] - values[k - 1][index])
                      - 25 * (values[k + 1][index] - values[k - 2][index])
                      + 2 * (values[k + 2][index] - values[k - 3][index]));
 }
-ARCH_DEV inline void compute_h5_face_values(const Vec * const values, uint k, Realf &fv_l, Realf &fv_r, const int index)
+ARCH_DEV inline void compute_h5_face_values(const Vec * const values, uint k, Realv &fv_l, Realv &fv_r, const int index)
 {
   //compute left values
   fv_l = 1.0/60.0 * (- 3.0 * values[k - 2][index]
@@ -592,11 +592,11 @@ ARCH_DEV inline void compute_h5_face_values(const Vec * const values, uint k, Re
                      + 27.0 * values[k + 1][index]
                      - 3.0 * values[k + 2][index]);
 }
-ARCH_DEV inline void compute_h4_left_face_derivative(const Vec * const values, uint k, Realf &fd_l, const int index)
+ARCH_DEV inline void compute_h4_left_face_derivative(const Vec * const values, uint k, Realv &fd_l, const int index)
 {
   fd_l = 1.0/12.0 * (15.0 * (values[k][index] - values[k - 1][index]) - (values[k + 1][index] - values[k - 2][index]));
 }
-ARCH_DEV inline void compute_h4_left_face_value(const Vec * const values, uint k, Realf &fv_l, const int index)
+ARCH_DEV inline void compute_h4_left_face_value(const Vec * const values, uint k, Realv &fv_l, const int index)
 {
   //compute left value
   fv_l = 1.0/12.0 * ( - 1.0 * values[k - 2][index]
@@ -605,7 +605,7 @@ ARCH_DEV inline void compute_h4_left_face_value(const Vec * const values, uint k
                       - 1.0 * values[k + 1][index]);
 }
 
-ARCH_DEV inline void compute_h4_left_face_value_nonuniform(const Vec * const h, const Vec * const u, uint k, Realf &fv_l, const int index) {
+ARCH_DEV inline void compute_h4_left_face_value_nonuniform(const Vec * const h, const Vec * const u, uint k, Realv &fv_l, const int index) {
 
    fv_l = (
            1.0 / ( h[k - 2][index] + h[k - 1][index] + h[k][index] + h[k + 1][index] )
@@ -622,13 +622,13 @@ ARCH_DEV inline void compute_h4_left_face_value_nonuniform(const Vec * const h,
 
 
 
-ARCH_DEV inline void compute_h3_left_face_derivative(const Vec * const values, uint k, Realf &fv_l, const int index)
+ARCH_DEV inline void compute_h3_left_face_derivative(const Vec * const values, uint k, Realv &fv_l, const int index)
 {
   /*compute left value*/
   fv_l = 1.0/12.0 * (15 * (values[k][index] - values[k - 1][index]) - (values[k + 1][index] - values[k - 2][index]));
 }
 
-ARCH_DEV inline void compute_filtered_face_values_derivatives(const Vec * const values, uint k, face_estimate_order order, Realf &fv_l, Realf &fv_r, Realf &fd_l, Realf &fd_r, const Realv threshold, const int index)
+ARCH_DEV inline void compute_filtered_face_values_derivatives(const Vec * const values, uint k, face_estimate_order order, Realv &fv_l, Realv &fv_r, Realv &fd_l, Realv &fd_r, const Realv threshold, const int index)
 {
    switch(order)
    {
@@ -657,7 +657,7 @@ ARCH_DEV inline void compute_filtered_face_values_derivatives(const Vec * const
           compute_h7_left_face_derivative(values, k + 1, fd_r, index);
           break;
    }
-   Realf slope_abs,slope_sign;
+   Realv slope_abs,slope_sign;
    // scale values closer to 1 for more accurate slope limiter calculation
    const Realv scale = 1./threshold;
    slope_limiter(values[k - 1][index]*scale, values[k][index]*scale, values[k + 1][index]*scale, slope_abs, slope_sign);
@@ -694,7 +694,7 @@ ARCH_DEV inline void compute_filtered_face_values_derivatives(const Vec * const
   2) Makes face values bounded
   3) Makes sure face slopes are consistent with PLM slope
 */
-ARCH_DEV inline void compute_filtered_face_values(const Vec * const values, uint k, face_estimate_order order, Realf &fv_l, Realf &fv_r, const Realv threshold, const int index)
+ARCH_DEV inline void compute_filtered_face_values(const Vec * const values, uint k, face_estimate_order order, Realv &fv_l, Realv &fv_r, const Realv threshold, const int index)
 {
   switch(order)
   {
@@ -715,7 +715,7 @@ ARCH_DEV inline void compute_filtered_face_values(const Vec * const values, uint
           compute_h8_left_face_value(values, k + 1, fv_r, index);
          break;
   }
-  Realf slope_abs, slope_sign;
+  Realv slope_abs, slope_sign;
   // scale values closer to 1 for more accurate slope limiter calculation
   const Realv scale = 1./threshold;
   slope_limiter(values[k -1][index]*scale, values[k][index]*scale, values[k + 1][index]*scale, slope_abs, slope_sign);
@@ -744,7 +744,7 @@ ARCH_DEV inline void compute_filtered_face_values(const Vec * const values, uint
   }
 }
 
-ARCH_DEV inline void compute_filtered_face_values_nonuniform(const Vec * const dv, const Vec * const values,uint k, face_estimate_order order, Realf &fv_l, Realf &fv_r, const Realv threshold, const int index){
+ARCH_DEV inline void compute_filtered_face_values_nonuniform(const Vec * const dv, const Vec * const values,uint k, face_estimate_order order, Realv &fv_l, Realv &fv_r, const Realv threshold, const int index){
   switch(order){
   case h4:
      compute_h4_left_face_value_nonuniform(dv, values, k, fv_l, index);
@@ -765,7 +765,7 @@ ARCH_DEV inline void compute_filtered_face_values_nonuniform(const Vec * const d
      printf("Order %d has not been implemented (yet)\n",order);
      break;
   }
-   Realf slope_abs,slope_sign;
+   Realv slope_abs,slope_sign;
    if (threshold>0) {
       // scale values closer to 1 for more accurate slope limiter calculation
       const Realv scale = 1./threshold;
@@ -794,14 +794,14 @@ ARCH_DEV inline void compute_filtered_face_values_nonuniform(const Vec * const d
    }
 }
 
-ARCH_DEV inline Realf get_D2aLim(const Vec * h, const Vec * values, uint k, const Realv C, Realf & fv, const int index) {
+ARCH_DEV inline Realv get_D2aLim(const Vec * h, const Vec * values, uint k, const Realv C, Realv & fv, const int index) {
 
   // Colella & Sekora, eq. 18
-  Realf invh2 = 1.0 / (h[k][index] * h[k][index]);
-  Realf d2a =  invh2 * 3.0 * (values[k    ][index] - 2.0 * fv                   + values[k + 1][index]);
-  Realf d2aL = invh2       * (values[k - 1][index] - 2.0 * values[k    ][index] + values[k + 1][index]);
-  Realf d2aR = invh2       * (values[k    ][index] - 2.0 * values[k + 1][index] + values[k + 2][index]);
-  Realf d2aLim;
+  Realv invh2 = 1.0 / (h[k][index] * h[k][index]);
+  Realv d2a =  invh2 * 3.0 * (values[k    ][index] - 2.0 * fv                   + values[k + 1][index]);
+  Realv d2aL = invh2       * (values[k - 1][index] - 2.0 * values[k    ][index] + values[k + 1][index]);
+  Realv d2aR = invh2       * (values[k    ][index] - 2.0 * values[k + 1][index] + values[k + 2][index]);
+  Realv d2aLim;
   if ( (d2a * d2aL >= 0) && (d2a * d2aR >= 0) && (d2a != 0) ) {
     d2aLim = d2a / abs(d2a) * min(abs(d2a),min(C*abs(d2aL),C*abs(d2aR)));
   } else {
@@ -812,25 +812,25 @@ ARCH_DEV inline Realf get_D2aLim(const Vec * h, const Vec * values, uint k, cons
 
 }
 
-ARCH_DEV inline void constrain_face_values(const Vec * h,const Vec * values,uint k,Realf & fv_l, Realf & fv_r, const int index) {
+ARCH_DEV inline void constrain_face_values(const Vec * h,const Vec * values,uint k,Realv & fv_l, Realv & fv_r, const int index) {
 
   const Realv C = 1.25;
-  Realf invh2 = 1.0 / (h[k][index] * h[k][index]);
+  Realv invh2 = 1.0 / (h[k][index] * h[k][index]);
 
   // Colella & Sekora, eq 19
-  Realf p_face = 0.5 * (values[k][index] + values[k + 1][index])
+  Realv p_face = 0.5 * (values[k][index] + values[k + 1][index])
      - h[k][index] * h[k][index] / 3.0 * get_D2aLim(h,values,k  ,C,fv_r, index);
-  Realf m_face = 0.5 * (values[k-1][index] + values[k][index])
+  Realv m_face = 0.5 * (values[k-1][index] + values[k][index])
      - h[k-1][index] * h[k-1][index] / 3.0 * get_D2aLim(h,values,k-1,C,fv_l, index);
 
   // Colella & Sekora, eq 21
-  Realf d2a = -2.0 * invh2 * 6.0 * (values[k][index] - 3.0 * (m_face + p_face)); // a6,j from eq. 7
-  Realf d2aC = invh2 * (values[k - 1][index] - 2.0 * values[k    ][index] + values[k + 1][index]);
+  Realv d2a = -2.0 * invh2 * 6.0 * (values[k][index] - 3.0 * (m_face + p_face)); // a6,j from eq. 7
+  Realv d2aC = invh2 * (values[k - 1][index] - 2.0 * values[k    ][index] + values[k + 1][index]);
   // Note: Corrected the index of 2nd term in d2aL to k - 1.
   //       In the paper it is k but that is almost certainly an error.
-  Realf d2aL = invh2 * (values[k - 2][index] - 2.0 * values[k - 1][index] + values[k    ][index]);
-  Realf d2aR = invh2 * (values[k    ][index] - 2.0 * values[k + 1][index] + values[k + 2][index]);
-  Realf d2aLim;
+  Realv d2aL = invh2 * (values[k - 2][index] - 2.0 * values[k - 1][index] + values[k    ][index]);
+  Realv d2aR = invh2 * (values[k    ][index] - 2.0 * values[k + 1][index] + values[k + 2][index]);
+  Realv d2aLim;
 
   // Colella & Sekora, eq 22
   if ( (d2a * d2aL >= 0) && (d2a * d2aR >= 0) &&
@@ -850,7 +850,7 @@ ARCH_DEV inline void constrain_face_values(const Vec * h,const Vec * values,uint
   fv_r = values[k][index] + (p_face - values[k][index]) * d2aLim / d2a;
   fv_l = values[k][index] + (m_face - values[k][index]) * d2aLim / d2a;
 
-  //std::pair<Realf,Realf> faceInterpolants;
+  //std::pair<Realv,Realv> faceInterpolants;
   //faceInterpolants = std::make_pair(m_face_interpolant,p_face_interpolant);
 
   // if(horizontal_and(values[k] > 1.0))
@@ -859,7 +859,7 @@ ARCH_DEV inline void constrain_face_values(const Vec * h,const Vec * values,uint
   //return faceInterpolants;
 }
 
-ARCH_DEV inline void compute_filtered_face_values_nonuniform_conserving(const Vec * const dv, const Vec * const values,uint k, face_estimate_order order, Realf &fv_l, Realf &fv_r, const Realv threshold, const int index){
+ARCH_DEV inline void compute_filtered_face_values_nonuniform_conserving(const Vec * const dv, const Vec * const values,uint k, face_estimate_order order, Realv &fv_l, Realv &fv_r, const Realv threshold, const int index){
    switch(order){
       case h4:
          compute_h4_left_face_value_nonuniform(dv, values, k, fv_l, index);
@@ -881,7 +881,7 @@ ARCH_DEV inline void compute_filtered_face_values_nonuniform_conserving(const Ve
          break;
    }
 
-   Realf slope_abs,slope_sign;
+   Realv slope_abs,slope_sign;
    if (threshold>0) {
       // scale values closer to 1 for more accurate slope limiter calculation
       const Realv scale = 1./threshold;
@@ -30,6 +30,121 @@ using namespace std;
 
 
 
+/** Number of velocity moment sums per population computed by blockVelocityMoments.*/
+static const uint N_MOMENT_SUMS = 7;
+
+/** Per-thread buffer for the moment sums of all populations of a cell, reused between cells.*/
+static thread_local std::vector<Real> momentSums;
+
+/** Calculate zeroth, first, and (possibly) second bulk velocity moments of a
+ * spatial cell into one set of cell parameters and population moments. The
+ * block data of each population is read once: zeroth, first and second moment
+ * sums are accumulated in the same pass, relative to a shift velocity, and the
+ * moments are assembled from the sums afterwards. The block data is wrapped in
+ * arch::buf views on the stack, so no heap allocations are made per cell.
+ * @param cell Spatial cell.
+ * @param shift Velocity the sums are accumulated relative to. Should be close
+ * to the _R bulk velocity of the cell, which the second moments are relative to.
+ * @param computeSecond If true, second velocity moments are calculated.
+ * @param RHOM Index of the first of the cell parameters RHOM, VX, VY, VZ, RHOQ.
+ * @param P_11 Index of the first of the cell parameters P_11, P_22, P_33.
+ * @param popRHO Population density member.
+ * @param popV Population bulk velocity member.
+ * @param popP Population pressure diagonal member.*/
+static void calculateFusedCellMoments(spatial_cell::SpatialCell* cell,
+                                      const Real (&shift)[3],
+                                      const bool computeSecond,
+                                      const uint RHOM,
+                                      const uint P_11,
+                                      Real Population::* popRHO,
+                                      Real (Population::* popV)[3],
+                                      Real (Population::* popP)[3]) {
+   const uint nPops = getObjectWrapper().particleSpecies.size();
+   momentSums.assign(nPops*N_MOMENT_SUMS, 0.0);
+
+   for (uint popID=0; popID<nPops; ++popID) {
+      vmesh::VelocityBlockContainer<vmesh::LocalID>& blockContainer = cell->get_velocity_blocks(popID);
+      if (blockContainer.size() == 0) continue;
+
+      arch::buf<Realf> data((Realf*)blockContainer.getData(), (uint)(blockContainer.size()*WID3*sizeof(Realf)));
+      arch::buf<Real> blockParams((Real*)blockContainer.getParameters(), (uint)(blockContainer.size()*BlockParams::N_VELOCITY_BLOCK_PARAMS*sizeof(Real)));
+
+      #ifdef DEBUG_MOMENTS
+      if (data.getPtr() == NULL || blockParams.getPtr() == NULL) {
+         stringstream ss;
+         ss << "ERROR in moment calculation in " << __FILE__ << ":" << __LINE__ << endl;
+         ss << "\t &data = " << data.getPtr() << "\t &blockParams = " << blockParams.getPtr() << endl;
+         ss << "\t size = " << blockContainer.size() << endl;
+         cerr << ss.str();
+         exit(1);
+      }
+      #endif
+
+      // Temporary array where the moment sums for this species are accumulated
+      Real array[N_MOMENT_SUMS] = {0};
+      blockVelocityMoments(data,
+                           blockParams,
+                           shift[0],
+                           shift[1],
+                           shift[2],
+                           array,
+                           (uint)blockContainer.size());
+      for (uint i=0; i<N_MOMENT_SUMS; ++i) momentSums[popID*N_MOMENT_SUMS+i] = array[i];
+   }
+
+   Real* parameters = cell->get_cell_parameters();
+   const uint VX = RHOM+1;
+   const uint RHOQ = RHOM+4;
+
+   Real massFlux[3] = {0.0, 0.0, 0.0};
+   parameters[RHOM] = 0.0;
+   parameters[RHOQ] = 0.0;
+   for (uint popID=0; popID<nPops; ++popID) {
+      if (cell->get_velocity_blocks(popID).size() == 0) continue;
+      const Real* array = &momentSums[popID*N_MOMENT_SUMS];
+      const Real mass = getObjectWrapper().particleSpecies[popID].mass;
+      const Real charge = getObjectWrapper().particleSpecies[popID].charge;
+
+      // Store species' contribution to bulk velocity moments
+      Population& pop = cell->get_population(popID);
+      pop.*popRHO = array[0];
+      for (uint d=0; d<3; ++d) {
+         const Real flux = array[1+d] + shift[d]*array[0];
+         (pop.*popV)[d] = divideIfNonZero(flux, array[0]);
+         massFlux[d] += flux*mass;
+      }
+      parameters[RHOM] += array[0]*mass;
+      parameters[RHOQ] += array[0]*charge;
+   }
+   for (uint d=0; d<3; ++d) {
+      parameters[VX+d] = divideIfNonZero(massFlux[d], parameters[RHOM]);
+   }
+
+   parameters[P_11  ] = 0.0;
+   parameters[P_11+1] = 0.0;
+   parameters[P_11+2] = 0.0;
+
+   // Compute second moments only if requested
+   if (computeSecond == false) return;
+
+   // Second moments about V0 from the sums about the shift s:
+   // sum f(v-V0)^2 = sum f(v-s)^2 - 2(V0-s) sum f(v-s) + (V0-s)^2 sum f
+   const Real* V0 = &parameters[CellParams::VX_R];
+   for (uint popID=0; popID<nPops; ++popID) {
+      if (cell->get_velocity_blocks(popID).size() == 0) continue;
+      const Real* array = &momentSums[popID*N_MOMENT_SUMS];
+      const Real mass = getObjectWrapper().particleSpecies[popID].mass;
+
+      // Store species' contribution to 2nd bulk velocity moments
+      Population& pop = cell->get_population(popID);
+      for (uint d=0; d<3; ++d) {
+         const Real delta = V0[d] - shift[d];
+         (pop.*popP)[d] = mass*(array[4+d] - 2.0*delta*array[1+d] + delta*delta*array[0]);
+         parameters[P_11+d] += (pop.*popP)[d];
+      }
+   }
+}
+
 /** Calculate zeroth, first, and (possibly) second bulk velocity moments for the 
  * given spatial cell. The calculated moments include contributions from 
  * all existing particle populations. This function is AMR safe.
@@ -42,117 +157,16 @@ void calculateCellMoments(spatial_cell::SpatialCell* cell,
 
     // if doNotSkip == true then the first clause is false and we will never return,
     // i.e. always compute, otherwise we skip DO_NOT_COMPUTE cells
-    bool skipMoments = false;
     if (!doNotSkip && cell->sysBoundaryFlag == sysboundarytype::DO_NOT_COMPUTE) {
-        skipMoments = true;
-    }
-
-    // Clear old moments to zero value
-    if (skipMoments == false) {
-        cell->parameters[CellParams::RHOM  ] = 0.0;
-        cell->parameters[CellParams::VX] = 0.0;
-        cell->parameters[CellParams::VY] = 0.0;
-        cell->parameters[CellParams::VZ] = 0.0;
-        cell->parameters[CellParams::RHOQ  ] = 0.0;
-        cell->parameters[CellParams::P_11] = 0.0;
-        cell->parameters[CellParams::P_22] = 0.0;
-        cell->parameters[CellParams::P_33] = 0.0;
+        return;
     }
 
-    // Create vectors for device buffers
-    std::vector<arch::buf<Realf>*> v_data;
-    v_data.reserve(getObjectWrapper().particleSpecies.size()); 
-    std::vector<arch::buf<Real>*> v_blockParams;
-    v_blockParams.reserve(getObjectWrapper().particleSpecies.size());
-
-    // Loop over all particle species
-    if (skipMoments == false) {
-       for (uint popID=0; popID<getObjectWrapper().particleSpecies.size(); ++popID) {
-          vmesh::VelocityBlockContainer<vmesh::LocalID>& blockContainer = cell->get_velocity_blocks(popID);
-          if (blockContainer.size() == 0) continue;
-          
-          const Real mass = getObjectWrapper().particleSpecies[popID].mass;
-          const Real charge = getObjectWrapper().particleSpecies[popID].charge;
-
-          // Create temporary buffers for the GPU data and push back to vector
-          v_data[popID] = new arch::buf<Realf>((Realf*)blockContainer.getData(), (uint)(blockContainer.size()*WID3*sizeof(Realf))); 
-          
-          v_blockParams[popID] = new arch::buf<Real>((Real*)blockContainer.getParameters(), (uint)(blockContainer.size()*BlockParams::N_VELOCITY_BLOCK_PARAMS*sizeof(Real))); 
- 
-          // Get pointers for easy access in the loop
-          arch::buf<Realf> data = *v_data[popID]; 
-          arch::buf<Real> blockParams = *v_blockParams[popID]; 
-          
-          // Temporary array for storing moments
-          Real array[4] = {0};
-
-          // Calculate species' contribution to first velocity moments
-          blockVelocityFirstMoments(data,
-                                    blockParams,
-                                    array,
-                                    (uint)blockContainer.size());
-          
-          Population &pop = cell->get_population(popID);
-          pop.RHO = array[0];
-          pop.V[0] = divideIfNonZero(array[1], array[0]);
-          pop.V[1] = divideIfNonZero(array[2], array[0]);
-          pop.V[2] = divideIfNonZero(array[3], array[0]);
-          
-          // Store species' contribution to bulk velocity moments
-          cell->parameters[CellParams::RHOM  ] += array[0]*mass;
-          cell->parameters[CellParams::VX] += array[1]*mass;
-          cell->parameters[CellParams::VY] += array[2]*mass;
-          cell->parameters[CellParams::VZ] += array[3]*mass;
-          cell->parameters[CellParams::RHOQ  ] += array[0]*charge;
-       } // for-loop over particle species
-       
-       cell->parameters[CellParams::VX] = divideIfNonZero(cell->parameters[CellParams::VX], cell->parameters[CellParams::RHOM]);
-       cell->parameters[CellParams::VY] = divideIfNonZero(cell->parameters[CellParams::VY], cell->parameters[CellParams::RHOM]);
-       cell->parameters[CellParams::VZ] = divideIfNonZero(cell->parameters[CellParams::VZ], cell->parameters[CellParams::RHOM]);
-    }
-
-    // Compute second moments only if requested
-    if (computeSecond == false) return;
-            
-    // Loop over all particle species
-    for (uint popID=0; popID<getObjectWrapper().particleSpecies.size(); ++popID) {
-       vmesh::VelocityBlockContainer<vmesh::LocalID>& blockContainer = cell->get_velocity_blocks(popID);
-       if (blockContainer.size() == 0) continue;
-       
-       const Real mass = getObjectWrapper().particleSpecies[popID].mass;
-
-       // Get pointers for easy access in the loop
-       arch::buf<Realf> data = *v_data[popID]; 
-       arch::buf<Real> blockParams = *v_blockParams[popID]; 
-       
-       // Temporary array for storing moments
-       Real array[3] = {0};
-       
-       // Calculate species' contribution to second velocity moments
-       blockVelocitySecondMoments(data,
-                                  blockParams,
-                                  cell->parameters[CellParams::VX_R],
-                                  cell->parameters[CellParams::VY_R],
-                                  cell->parameters[CellParams::VZ_R],
-                                  array,
-                                  (uint)blockContainer.size());
-       
-       // Store species' contribution to bulk velocity moments
-       Population &pop = cell->get_population(popID);
-       pop.P[0] = mass*array[0];
-       pop.P[1] = mass*array[1];
-       pop.P[2] = mass*array[2];
-       
-       cell->parameters[CellParams::P_11] += pop.P[0];
-       cell->parameters[CellParams::P_22] += pop.P[1];
-       cell->parameters[CellParams::P_33] += pop.P[2];
-    } // for-loop over particle species
-
-    // Delete temporary device buffers
-    for(auto buf_data : v_data)
-      delete buf_data;
-    for(auto buf_blockParams : v_blockParams)
-      delete buf_blockParams;
+    // Second moments are relative to the _R bulk velocity, so the sums are too
+    const Real shift[3] = {cell->parameters[CellParams::VX_R],
+                           cell->parameters[CellParams::VY_R],
+                           cell->parameters[CellParams::VZ_R]};
+    calculateFusedCellMoments(cell, shift, computeSecond, CellParams::RHOM, CellParams::P_11,
+                              &Population::RHO, &Population::V, &Population::P);
 }
 
 /** Calculate zeroth, first, and (possibly) second bulk velocity moments for the 
@@ -166,156 +180,27 @@ void calculateMoments_R(
         dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
         const std::vector<CellID>& cells,
         const bool& computeSecond) {
- 
-    phiprof::start("compute-moments-n");
-
-    // Create vectors for device buffers
-    std::vector<arch::buf<Realf>*> v_data;
-    v_data.reserve(getObjectWrapper().particleSpecies.size() * cells.size()); 
-    std::vector<arch::buf<Real>*> v_blockParams;
-    v_blockParams.reserve(getObjectWrapper().particleSpecies.size() * cells.size());
-
-    for (uint popID=0; popID<getObjectWrapper().particleSpecies.size(); ++popID) {
-       #pragma omp parallel for
-       for (size_t c=0; c<cells.size(); ++c) {
-          SpatialCell* cell = mpiGrid[cells[c]];
-          
-          if (cell->sysBoundaryFlag == sysboundarytype::DO_NOT_COMPUTE) {
-             continue;
-          }
-          
-          // Clear old moments to zero value
-          if (popID == 0) {
-             cell->parameters[CellParams::RHOM_R  ] = 0.0;
-             cell->parameters[CellParams::VX_R] = 0.0;
-             cell->parameters[CellParams::VY_R] = 0.0;
-             cell->parameters[CellParams::VZ_R] = 0.0;
-             cell->parameters[CellParams::RHOQ_R  ] = 0.0;
-             cell->parameters[CellParams::P_11_R] = 0.0;
-             cell->parameters[CellParams::P_22_R] = 0.0;
-             cell->parameters[CellParams::P_33_R] = 0.0;
-          }
 
-          const Real dx = cell->parameters[CellParams::DX];
-          const Real dy = cell->parameters[CellParams::DY];
-          const Real dz = cell->parameters[CellParams::DZ];
-
-          vmesh::VelocityBlockContainer<vmesh::LocalID>& blockContainer = cell->get_velocity_blocks(popID);
-          if (blockContainer.size() == 0) continue;
-          const Real mass = getObjectWrapper().particleSpecies[popID].mass;
-          const Real charge = getObjectWrapper().particleSpecies[popID].charge;
-
-          // Create temporary buffers for the GPU data and push back to vector
-          v_data[cells.size() * popID + c] = new arch::buf<Realf>((Realf*)blockContainer.getData(), (uint)(blockContainer.size()*WID3*sizeof(Realf))); 
-          v_blockParams[cells.size() * popID + c] = new arch::buf<Real>((Real*)blockContainer.getParameters(), (uint)(blockContainer.size()*BlockParams::N_VELOCITY_BLOCK_PARAMS*sizeof(Real))); 
-
-          // Get pointers for easy access in the loop
-          arch::buf<Realf> data = *v_data[cells.size() * popID + c]; 
-          arch::buf<Real> blockParams = *v_blockParams[cells.size() * popID + c]; 
-
-          #ifdef DEBUG_MOMENTS
-          bool ok = true;
-          if (&data[0] == NULL && blockContainer.size() > 0) ok = false;
-          if (&blockParams[0] == NULL && blockContainer.size() > 0) ok = false;
-          if (ok == false) {
-             stringstream ss;
-             ss << "ERROR in moment calculation in " << __FILE__ << ":" << __LINE__ << endl;
-             ss << "\t &data = " << data << "\t &blockParams = " << &blockParams[0] << endl;
-             ss << "\t size = " << blockContainer.size() << endl;
-             cerr << ss.str();
-             exit(1);
-          }
-          #endif
-
-          // Temporary array where the moments for this species are accumulated
-          Real array[4] = {0};
-
-          // Calculate species' contribution to first velocity moments
-          blockVelocityFirstMoments(data,
-                                    blockParams,
-                                    array,
-                                    (uint)blockContainer.size());
+    phiprof::start("compute-moments-n");
 
-          // Store species' contribution to bulk velocity moments
-          Population &pop = cell->get_population(popID);
-          pop.RHO_R = array[0];
-          pop.V_R[0] = divideIfNonZero(array[1], array[0]);
-          pop.V_R[1] = divideIfNonZero(array[2], array[0]);
-          pop.V_R[2] = divideIfNonZero(array[3], array[0]);
-          
-          cell->parameters[CellParams::RHOM_R  ] += array[0]*mass;
-          cell->parameters[CellParams::VX_R] += array[1]*mass;
-          cell->parameters[CellParams::VY_R] += array[2]*mass;
-          cell->parameters[CellParams::VZ_R] += array[3]*mass;
-          cell->parameters[CellParams::RHOQ_R  ] += array[0]*charge;
-       } // for-loop over spatial cells
-    } // for-loop over particle species
-    
     #pragma omp parallel for
     for (size_t c=0; c<cells.size(); ++c) {
        SpatialCell* cell = mpiGrid[cells[c]];
+       
        if (cell->sysBoundaryFlag == sysboundarytype::DO_NOT_COMPUTE) {
           continue;
        }
-       cell->parameters[CellParams::VX_R] = divideIfNonZero(cell->parameters[CellParams::VX_R], cell->parameters[CellParams::RHOM_R]);
-       cell->parameters[CellParams::VY_R] = divideIfNonZero(cell->parameters[CellParams::VY_R], cell->parameters[CellParams::RHOM_R]);
-       cell->parameters[CellParams::VZ_R] = divideIfNonZero(cell->parameters[CellParams::VZ_R], cell->parameters[CellParams::RHOM_R]);
-    }
-
-   // Compute second moments only if requested.
-   if (computeSecond == false) {
-      phiprof::stop("compute-moments-n");
-      return;
-   }
-
-   for (uint popID=0; popID<getObjectWrapper().particleSpecies.size(); ++popID) {
-      #pragma omp parallel for
-      for (size_t c=0; c<cells.size(); ++c) {
-         SpatialCell* cell = mpiGrid[cells[c]];
-         
-         if (cell->sysBoundaryFlag == sysboundarytype::DO_NOT_COMPUTE) {
-            continue;
-         }
-         
-         vmesh::VelocityBlockContainer<vmesh::LocalID>& blockContainer = cell->get_velocity_blocks(popID);
-         if (blockContainer.size() == 0) continue;
-         const Real mass = getObjectWrapper().particleSpecies[popID].mass;
-
-         // Get pointers for easy access in the loop
-         arch::buf<Realf> data = *v_data[cells.size() * popID + c]; 
-         arch::buf<Real> blockParams = *v_blockParams[cells.size() * popID + c]; 
-
-         // Temporary array where species' contribution to 2nd moments is accumulated
-         Real array[3] = {0};
-
-         // Calculate species' contribution to second velocity moments
-         blockVelocitySecondMoments(data,
-                                    blockParams,
-                                    cell->parameters[CellParams::VX_R],
-                                    cell->parameters[CellParams::VY_R],
-                                    cell->parameters[CellParams::VZ_R],
-                                    array,
-                                    (uint)blockContainer.size());
-
-         // Store species' contribution to 2nd bulk velocity moments
-         Population &pop = cell->get_population(popID);
-         pop.P_R[0] = mass*array[0];
-         pop.P_R[1] = mass*array[1];
-         pop.P_R[2] = mass*array[2];
-         
-         cell->parameters[CellParams::P_11_R] += pop.P_R[0];
-         cell->parameters[CellParams::P_22_R] += pop.P_R[1];
-         cell->parameters[CellParams::P_33_R] += pop.P_R[2];
-      } // for-loop over spatial cells
-   } // for-loop over particle species
 
-   // Delete temporary device buffers
-   for(auto buf_data : v_data)
-     delete buf_data;
-   for(auto buf_blockParams : v_blockParams)
-     delete buf_blockParams;
+       // The previous bulk velocity is close to the new one, accumulating
+       // the sums relative to it keeps the second moments accurate.
+       const Real shift[3] = {cell->parameters[CellParams::VX_R],
+                              cell->parameters[CellParams::VY_R],
+                              cell->parameters[CellParams::VZ_R]};
+       calculateFusedCellMoments(cell, shift, computeSecond, CellParams::RHOM_R, CellParams::P_11_R,
+                                 &Population::RHO_R, &Population::V_R, &Population::P_R);
+    } // for-loop over spatial cells
 
-   phiprof::stop("compute-moments-n");
+    phiprof::stop("compute-moments-n");
 }
 
 /** Calculate zeroth, first, and (possibly) second bulk velocity moments for the 
@@ -330,140 +215,24 @@ void calculateMoments_V(
         dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
         const std::vector<CellID>& cells,
         const bool& computeSecond) {
- 
-   phiprof::start("Compute _V moments");
-
-   // Create vectors for device buffers
-   std::vector<arch::buf<Realf>*> v_data;
-   v_data.reserve(getObjectWrapper().particleSpecies.size() * cells.size()); 
-   std::vector<arch::buf<Real>*> v_blockParams;
-   v_blockParams.reserve(getObjectWrapper().particleSpecies.size() * cells.size());
- 
-   // Loop over all particle species
-   for (uint popID=0; popID<getObjectWrapper().particleSpecies.size(); ++popID) {
-      #pragma omp parallel for
-      for (size_t c=0; c<cells.size(); ++c) {
-         SpatialCell* cell = mpiGrid[cells[c]];
-         
-         if (cell->sysBoundaryFlag == sysboundarytype::DO_NOT_COMPUTE) {
-            continue;
-         }
-         
-         // Clear old moments to zero value
-         if (popID == 0) {
-             cell->parameters[CellParams::RHOM_V  ] = 0.0;
-             cell->parameters[CellParams::VX_V] = 0.0;
-             cell->parameters[CellParams::VY_V] = 0.0;
-             cell->parameters[CellParams::VZ_V] = 0.0;
-             cell->parameters[CellParams::RHOQ_V  ] = 0.0;
-             cell->parameters[CellParams::P_11_V] = 0.0;
-             cell->parameters[CellParams::P_22_V] = 0.0;
-             cell->parameters[CellParams::P_33_V] = 0.0;
-         }
-
-         vmesh::VelocityBlockContainer<vmesh::LocalID>& blockContainer = cell->get_velocity_blocks(popID);
-         if (blockContainer.size() == 0) continue;
-
-         const Real mass = getObjectWrapper().particleSpecies[popID].mass;
-         const Real charge = getObjectWrapper().particleSpecies[popID].charge;
 
-         // Create temporary buffers for the GPU data and push back to vector
-         v_data[cells.size() * popID + c] = new arch::buf<Realf>((Realf*)blockContainer.getData(), (uint)(blockContainer.size()*WID3*sizeof(Realf))); 
-         v_blockParams[cells.size() * popID + c] = new arch::buf<Real>((Real*)blockContainer.getParameters(), (uint)(blockContainer.size()*BlockParams::N_VELOCITY_BLOCK_PARAMS*sizeof(Real))); 
-
-         // Get pointers for easy access in the loop
-         arch::buf<Realf> data = *v_data[cells.size() * popID + c]; 
-         arch::buf<Real> blockParams = *v_blockParams[cells.size() * popID + c]; 
-
-         // Temporary array for storing moments
-         Real array[4] = {0};
+   phiprof::start("Compute _V moments");
 
-         // Calculate species' contribution to first velocity moments
-         blockVelocityFirstMoments(data,
-                                   blockParams,
-                                   array,
-                                   (uint)blockContainer.size());
-         
-         // Store species' contribution to bulk velocity moments
-         Population &pop = cell->get_population(popID);
-         pop.RHO_V = array[0];
-         pop.V_V[0] = divideIfNonZero(array[1], array[0]);
-         pop.V_V[1] = divideIfNonZero(array[2], array[0]);
-         pop.V_V[2] = divideIfNonZero(array[3], array[0]);
-         
-         cell->parameters[CellParams::RHOM_V  ] += array[0]*mass;
-         cell->parameters[CellParams::VX_V] += array[1]*mass;
-         cell->parameters[CellParams::VY_V] += array[2]*mass;
-         cell->parameters[CellParams::VZ_V] += array[3]*mass;
-         cell->parameters[CellParams::RHOQ_V  ] += array[0]*charge;
-         
-      } // for-loop over spatial cells
-   } // for-loop over particle species
-   
    #pragma omp parallel for
    for (size_t c=0; c<cells.size(); ++c) {
       SpatialCell* cell = mpiGrid[cells[c]];
+      
       if (cell->sysBoundaryFlag == sysboundarytype::DO_NOT_COMPUTE) {
          continue;
       }
-      cell->parameters[CellParams::VX_V] = divideIfNonZero(cell->parameters[CellParams::VX_V], cell->parameters[CellParams::RHOM_V]);
-      cell->parameters[CellParams::VY_V] = divideIfNonZero(cell->parameters[CellParams::VY_V], cell->parameters[CellParams::RHOM_V]);
-      cell->parameters[CellParams::VZ_V] = divideIfNonZero(cell->parameters[CellParams::VZ_V], cell->parameters[CellParams::RHOM_V]);
-   }
-
-   // Compute second moments only if requested
-   if (computeSecond == false) {
-      phiprof::stop("Compute _V moments");
-      return;
-   }
-
-   for (uint popID=0; popID<getObjectWrapper().particleSpecies.size(); ++popID) {
-      #pragma omp parallel for
-      for (size_t c=0; c<cells.size(); ++c) {
-         SpatialCell* cell = mpiGrid[cells[c]];
-         
-         if (cell->sysBoundaryFlag == sysboundarytype::DO_NOT_COMPUTE) {
-            continue;
-         }
-
-         vmesh::VelocityBlockContainer<vmesh::LocalID>& blockContainer = cell->get_velocity_blocks(popID);
-         if (blockContainer.size() == 0) continue;
-         const Real mass = getObjectWrapper().particleSpecies[popID].mass;
-
-         // Get pointers for easy access in the loop
-         arch::buf<Realf> data = *v_data[cells.size() * popID + c]; 
-         arch::buf<Real> blockParams = *v_blockParams[cells.size() * popID + c]; 
-
-         // Temporary array where moments are stored
-         Real array[3] = {0};
-
-         // Calculate species' contribution to second velocity moments
-         blockVelocitySecondMoments(data,
-                                    blockParams,
-                                    cell->parameters[CellParams::VX_R],
-                                    cell->parameters[CellParams::VY_R],
-                                    cell->parameters[CellParams::VZ_R],
-                                    array,
-                                    (uint)blockContainer.size());
-         
-         // Store species' contribution to 2nd bulk velocity moments
-         Population &pop = cell->get_population(popID);
-         pop.P_V[0] = mass*array[0];
-         pop.P_V[1] = mass*array[1];
-         pop.P_V[2] = mass*array[2];
-         
-         cell->parameters[CellParams::P_11_V] += pop.P_V[0];
-         cell->parameters[CellParams::P_22_V] += pop.P_V[1];
-         cell->parameters[CellParams::P_33_V] += pop.P_V[2];
-         
-      } // for-loop over spatial cells
-   } // for-loop over particle species
 
-   // Delete temporary device buffers
-   for(auto buf_data : v_data)
-     delete buf_data;
-   for(auto buf_blockParams : v_blockParams)
-     delete buf_blockParams;
+      // Second moments are relative to the _R bulk velocity, so the sums are too
+      const Real shift[3] = {cell->parameters[CellParams::VX_R],
+                             cell->parameters[CellParams::VY_R],
+                             cell->parameters[CellParams::VZ_R]};
+      calculateFusedCellMoments(cell, shift, computeSecond, CellParams::RHOM_V, CellParams::P_11_V,
+                                &Population::RHO_V, &Population::V_V, &Population::P_V);
+   } // for-loop over spatial cells
 
    phiprof::stop("Compute _V moments");
 }
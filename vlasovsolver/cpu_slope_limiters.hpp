@@ -119,17 +119,17 @@ static ARCH_HOSTDEV inline void slope_limiter(const Vec& l,const Vec& m, const V
 
 
 /**** 
-      Define functions for Realf instead of Vec 
+      Define functions for Realv instead of Vec 
 ***/
 
-static ARCH_DEV inline Realf minmod(const Realf slope1, const Realf slope2)
+static ARCH_DEV inline Realv minmod(const Realv slope1, const Realv slope2)
 {
-  Realf slope = (abs(slope1) < abs(slope2)) ? slope1 : slope2;
+  Realv slope = (abs(slope1) < abs(slope2)) ? slope1 : slope2;
   return (slope1 * slope2 <= 0) ? 0 : slope;
 }
-static ARCH_DEV inline Realf maxmod(const Realf slope1, const Realf slope2)
+static ARCH_DEV inline Realv maxmod(const Realv slope1, const Realv slope2)
 {
-  Realf slope = (abs(slope1) > abs(slope2)) ? slope1 : slope2;
+  Realv slope = (abs(slope1) > abs(slope2)) ? slope1 : slope2;
   return (slope1 * slope2 <= 0) ? 0 : slope;
 }
 
@@ -137,12 +137,12 @@ static ARCH_DEV inline Realf maxmod(const Realf slope1, const Realf slope2)
   Superbee slope limiter
 */
 
-static ARCH_DEV inline Realf slope_limiter_sb(const Realf &l, const Realf &m, const Realf &r)
+static ARCH_DEV inline Realv slope_limiter_sb(const Realv &l, const Realv &m, const Realv &r)
 {
-  Realf a = r-m;
-  Realf b = m-l;
-  const Realf slope1 = minmod(a, 2*b);
-  const Realf slope2 = minmod(2*a, b);
+  Realv a = r-m;
+  Realv b = m-l;
+  const Realv slope1 = minmod(a, 2*b);
+  const Realv slope2 = minmod(2*a, b);
   return maxmod(slope1, slope2);
 }
 
@@ -150,10 +150,10 @@ static ARCH_DEV inline Realf slope_limiter_sb(const Realf &l, const Realf &m, co
   Minmod slope limiter
 */
 
-static ARCH_DEV inline Realf slope_limiter_minmod(const Realf& l,const Realf& m, const Realf& r)
+static ARCH_DEV inline Realv slope_limiter_minmod(const Realv& l,const Realv& m, const Realv& r)
 {
-   Realf a=r-m;
-   Realf b=m-l;
+   Realv a=r-m;
+   Realv b=m-l;
    return minmod(a,b);
 }
 
@@ -161,28 +161,28 @@ static ARCH_DEV inline Realf slope_limiter_minmod(const Realf& l,const Realf& m,
   MC slope limiter
 */
 
-static ARCH_DEV inline Realf slope_limiter_mc(const Realf& l,const Realf& m, const Realf& r)
+static ARCH_DEV inline Realv slope_limiter_mc(const Realv& l,const Realv& m, const Realv& r)
 {
-  Realf a=r-m;
-  Realf b=m-l;
-  Realf minval=min(2*abs(a),2*abs(b));
-  minval=min(minval,(Realf)0.5*abs(a+b));
+  Realv a=r-m;
+  Realv b=m-l;
+  Realv minval=min(2*abs(a),2*abs(b));
+  minval=min(minval,(Realv)0.5*abs(a+b));
 
   //check for extrema
-  Realf output = (a*b < 0) ? 0 : minval;
+  Realv output = (a*b < 0) ? 0 : minval;
   //set sign
   return (a + b < 0) ? -output : output;
 }
 
-static ARCH_DEV inline Realf slope_limiter_minmod_amr(const Realf& l,const Realf& m, const Realf& r,const Realf& a,const Realf& b)
+static ARCH_DEV inline Realv slope_limiter_minmod_amr(const Realv& l,const Realv& m, const Realv& r,const Realv& a,const Realv& b)
 {
-   Realf J = r-l;
-   Realf f = (m-l)/J;
-   f = min((Realf)1.0,f);
-   return min((Realf)f/(1+a),(Realf)(1.-f)/(1+b))*2*J;
+   Realv J = r-l;
+   Realv f = (m-l)/J;
+   f = min((Realv)1.0,f);
+   return min((Realv)f/(1+a),(Realv)(1.-f)/(1+b))*2*J;
 }
 
-static ARCH_DEV inline Realf slope_limiter(const Realf &l, const Realf &m, const Realf &r)
+static ARCH_DEV inline Realv slope_limiter(const Realv &l, const Realv &m, const Realv &r)
 {
    return slope_limiter_sb(l,m,r);
    //return slope_limiter_minmod(l,m,r);
@@ -192,15 +192,15 @@ static ARCH_DEV inline Realf slope_limiter(const Realf &l, const Realf &m, const
  * @param a Cell size fraction dx[i-1]/dx[i] = 1/2, 1, or 2.
  * @param b Cell size fraction dx[i+1]/dx[i] = 1/2, 1, or 2.
  * @return Limited value of slope.*/
-static ARCH_DEV inline Realf slope_limiter_amr(const Realf& l,const Realf& m, const Realf& r,const Realf& dx_left,const Realf& dx_rght)
+static ARCH_DEV inline Realv slope_limiter_amr(const Realv& l,const Realv& m, const Realv& r,const Realv& dx_left,const Realv& dx_rght)
 {
    return slope_limiter_minmod_amr(l,m,r,dx_left,dx_rght);
 }
 
 /* Slope limiter with abs and sign separatelym, uses the currently active slope limiter*/
-static ARCH_DEV inline void slope_limiter(const Realf& l,const Realf& m, const Realf& r, Realf& slope_abs, Realf& slope_sign)
+static ARCH_DEV inline void slope_limiter(const Realv& l,const Realv& m, const Realv& r, Realv& slope_abs, Realv& slope_sign)
 {
-   const Realf slope = slope_limiter(l,m,r);
+   const Realv slope = slope_limiter(l,m,r);
    slope_abs = abs(slope);
    slope_sign = (slope > 0) ? 1 : -1.0;
 }
@@ -321,6 +321,107 @@ void copy_trans_block_data(
    }
 }
 
+/* Get the sorted union of the velocity blocks that exist in any of the given cells.
+
+   The block set of the cells does not change between the mappings in the
+   three dimensions, so this is computed once per population and shared by all
+   of them. Instead of hashing every block of every cell, blocks are flagged in
+   a dense bitmap over the velocity grid of the population and collected in
+   global ID order, which also gives the mapping loop a cache friendly block order.
+
+   @param mpiGrid DCCRG grid object
+   @param cells Cells whose blocks are collected (duplicates are allowed)
+   @param popID Particle population ID
+   @param unionOfBlocks Sorted list of unique block global IDs (output)
+*/
+void computeUnionOfBlocks(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                          const vector<CellID>& cells,
+                          const uint popID,
+                          std::vector<vmesh::GlobalID>& unionOfBlocks) {
+   phiprof::start("buildBlockList");
+   unionOfBlocks.clear();
+   if (cells.size() == 0) {
+      phiprof::stop("buildBlockList");
+      return;
+   }
+
+   const vmesh::GlobalID maxBlocks = mpiGrid[cells[0]]->get_velocity_mesh(popID).getMaxVelocityBlocks();
+   std::vector<uint8_t> blockExists(maxBlocks, 0);
+
+#pragma omp parallel for schedule(dynamic,1)
+   for (uint celli = 0; celli < cells.size(); celli++) {
+      const vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh = mpiGrid[cells[celli]]->get_velocity_mesh(popID);
+      for (vmesh::LocalID block_i=0; block_i< vmesh.size(); ++block_i) {
+#pragma omp atomic write
+         blockExists[vmesh.getGlobalID(block_i)] = 1;
+      }
+   }
+
+   for (vmesh::GlobalID blockGID = 0; blockGID < maxBlocks; blockGID++) {
+      if (blockExists[blockGID]) {
+         unionOfBlocks.push_back(blockGID);
+      }
+   }
+   phiprof::stop("buildBlockList");
+}
+
+/* Split a block union into blocks that take no part in the stencil data
+   transfer of the given neighborhood and blocks that do.
+
+   A block is on the process boundary if it exists in any cell that is sent or
+   received when copies of remote neighbors are updated in the neighborhood.
+   The transfer neither reads nor writes the data of the other blocks, so they
+   can be mapped while it is in flight. Both output lists keep the order of
+   unionOfBlocks.
+
+   @param mpiGrid DCCRG grid object
+   @param neighborhood ID of the neighborhood used for the stencil data transfer
+   @param unionOfBlocks Blocks to split
+   @param popID Particle population ID
+   @param innerBlocks Blocks not on the process boundary (output)
+   @param boundaryBlocks Blocks on the process boundary (output)
+*/
+void splitBlocksOnProcessBoundary(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                                  const int neighborhood,
+                                  const std::vector<vmesh::GlobalID>& unionOfBlocks,
+                                  const uint popID,
+                                  std::vector<vmesh::GlobalID>& innerBlocks,
+                                  std::vector<vmesh::GlobalID>& boundaryBlocks) {
+   phiprof::start("splitBlockList");
+   innerBlocks.clear();
+   boundaryBlocks.clear();
+
+   vector<CellID> transferCells = mpiGrid.get_remote_cells_on_process_boundary(neighborhood);
+   const vector<CellID> localBoundaryCells = mpiGrid.get_local_cells_on_process_boundary(neighborhood);
+   transferCells.insert(transferCells.end(), localBoundaryCells.begin(), localBoundaryCells.end());
+   if (transferCells.size() == 0) {
+      innerBlocks = unionOfBlocks;
+      phiprof::stop("splitBlockList");
+      return;
+   }
+
+   const vmesh::GlobalID maxBlocks = mpiGrid[transferCells[0]]->get_velocity_mesh(popID).getMaxVelocityBlocks();
+   std::vector<uint8_t> onBoundary(maxBlocks, 0);
+
+#pragma omp parallel for schedule(dynamic,1)
+   for (uint celli = 0; celli < transferCells.size(); celli++) {
+      const vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh = mpiGrid[transferCells[celli]]->get_velocity_mesh(popID);
+      for (vmesh::LocalID block_i=0; block_i< vmesh.size(); ++block_i) {
+#pragma omp atomic write
+         onBoundary[vmesh.getGlobalID(block_i)] = 1;
+      }
+   }
+
+   for (const vmesh::GlobalID blockGID : unionOfBlocks) {
+      if (onBoundary[blockGID]) {
+         boundaryBlocks.push_back(blockGID);
+      } else {
+         innerBlocks.push_back(blockGID);
+      }
+   }
+   phiprof::stop("splitBlockList");
+}
+
 /*
    Here we map from the current time step grid, to a target grid which
    is the lagrangian departure grid (so th grid at timestep +dt,
@@ -333,6 +434,7 @@ void copy_trans_block_data(
 bool trans_map_1d(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
                   const vector<CellID>& localPropagatedCells,
                   const vector<CellID>& remoteTargetCells,
+                  const std::vector<vmesh::GlobalID>& unionOfBlocks,
                   const uint dimension,
                   const Realv dt,
                   const uint popID) {
@@ -371,30 +473,6 @@ bool trans_map_1d(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpi
    }
 
 
-   //Get a unique sorted list of blockids that are in any of the
-   // propagated cells. First use set for this, then add to vector (may not
-   // be the most nice way to do this and in any case we could do it along
-   // dimension for data locality reasons => copy acc map column code, TODO: FIXME
-   std::unordered_set<vmesh::GlobalID> unionOfBlocksSet;
-
-
-
-   for(uint celli = 0; celli < allCellsPointer.size(); celli++) {
-      vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh = allCellsPointer[celli]->get_velocity_mesh(popID);
-      for (vmesh::LocalID block_i=0; block_i< vmesh.size(); ++block_i) {
-         unionOfBlocksSet.insert(vmesh.getGlobalID(block_i));
-      }
-   }
-
-   std::vector<vmesh::GlobalID> unionOfBlocks;
-   unionOfBlocks.reserve(unionOfBlocksSet.size());
-   for(const auto blockGID:  unionOfBlocksSet) {
-      unionOfBlocks.push_back(blockGID);
-   }
-
-
-
-
    const uint8_t REFLEVEL=0;
    const vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh = allCellsPointer[0]->get_velocity_mesh(popID);
    // set cell size in dimension direction
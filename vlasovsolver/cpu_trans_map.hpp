@@ -45,9 +45,20 @@ void store_trans_block_data(SpatialCell** target_neighbors,const vmesh::GlobalID
                             const unsigned char* const cellid_transpose,const uint popID);
 
 bool do_translate_cell(spatial_cell::SpatialCell* SC);
+void computeUnionOfBlocks(const dccrg::Dccrg<spatial_cell::SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                          const std::vector<CellID>& cells,
+                          const uint popID,
+                          std::vector<vmesh::GlobalID>& unionOfBlocks);
+void splitBlocksOnProcessBoundary(const dccrg::Dccrg<spatial_cell::SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                                  const int neighborhood,
+                                  const std::vector<vmesh::GlobalID>& unionOfBlocks,
+                                  const uint popID,
+                                  std::vector<vmesh::GlobalID>& innerBlocks,
+                                  std::vector<vmesh::GlobalID>& boundaryBlocks);
 bool trans_map_1d(const dccrg::Dccrg<spatial_cell::SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
                   const std::vector<CellID>& localPropagatedCells,
                   const std::vector<CellID>& remoteTargetCells,
+                  const std::vector<vmesh::GlobalID>& unionOfBlocks,
                   const uint dimension,
                   const Realv dt,
                   const uint popID);
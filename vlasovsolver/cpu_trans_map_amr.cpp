@@ -1,4 +1,6 @@
 //#include "cpu_1d_ppm_nonuniform_conserving.hpp"
+#include <algorithm>
+#include <iterator>
 #include "../grid.h"
 #include "../object_wrapper.h"
 #include "../memoryallocation.h"
@@ -493,8 +495,8 @@ CellID selectNeighbor(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>
  *             The pencil will continue in the + direction in the given dimension until an end condition is met
  * @param [in] dimension Spatial dimension
  * @param [in] path Integer value that determines which neighbor is added to the pencil when a higher refinement level is met
- * @param [in] endIds Prescribed end conditions for the pencil. If any of these cell ids is about to be added to the pencil,
- *             the builder terminates.
+ * @param [in] endIds Prescribed end conditions for the pencil, sorted. If any of these cell ids is about to be added
+ *             to the pencil, the builder terminates.
  */
 setOfPencils buildPencilsWithNeighbors( const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry> &grid, 
 					setOfPencils &pencils, const CellID seedId,
@@ -653,7 +655,7 @@ setOfPencils buildPencilsWithNeighbors( const dccrg::Dccrg<SpatialCell,dccrg::Ca
             std::cout << " Next neighbor is " << nextNeighbor << "." << std::endl;
          }
 
-         if ( std::any_of(endIds.begin(), endIds.end(), [nextNeighbor](uint i){return i == nextNeighbor;}) ||
+         if ( std::binary_search(endIds.begin(), endIds.end(), nextNeighbor) ||
               !do_translate_cell(grid[nextNeighbor])) {
             
             nextNeighbor = INVALID_CELLID;
@@ -1033,7 +1035,7 @@ bool copy_trans_block_data_amr(
    //  Copy volume averages of this block from all spatial cells:
    for (int b = -VLASOV_STENCIL_WIDTH; b < lengthOfPencil + VLASOV_STENCIL_WIDTH; b++) {
       if(blockDataPointer[b + VLASOV_STENCIL_WIDTH] != NULL) {
-         Realf blockValues[WID3];
+         Realv blockValues[WID3];
          const Realf* block_data = blockDataPointer[b + VLASOV_STENCIL_WIDTH];
          // Copy data to a temporary array and transpose values so that mapping is along k direction.
          // spatial source_neighbors already taken care of when
@@ -1302,8 +1304,128 @@ void printPencilsFunc(const setOfPencils& pencils, const uint dimension, const i
    MPI_Barrier(MPI_COMM_WORLD);
 }
 
+/* Offsets of the pencils of one dimension in the contiguous buffers used by
+ * trans_map_1d_amr. Recomputed whenever the pencils are rebuilt.
+ */
+struct PencilBufferLayout {
+   std::vector<uint> sourceStart; // Start of each pencil in the source cell and dz buffers
+   uint sumOfSourceLengths;       // Size of the source cell and dz buffers
+   uint maxLength;                // Length of the longest pencil, sizes the per-thread buffers
+
+   PencilBufferLayout() {
+      sumOfSourceLengths = 0;
+      maxLength = 0;
+   }
+};
+
+static std::array<PencilBufferLayout,3> pencilBufferLayouts;
+
+// Sorted local propagated cells and seed ids of the last pencil build in each dimension,
+// used to rebuild only the pencils affected by migrated cells.
+static std::array<std::vector<CellID>,3> pencilBuildCells;
+static std::array<std::vector<CellID>,3> pencilBuildSeedIds;
+static std::array<bool,3> pencilsBuilt = {{false, false, false}};
+
+/* Compute the buffer layout of the pencils of one dimension.
+ *
+ * @param [in] pencils Pencil data struct
+ * @param [out] layout Buffer layout of the pencils
+ */
+void computePencilBufferLayout(const setOfPencils& pencils, PencilBufferLayout& layout) {
+   layout.sourceStart.resize(pencils.N);
+   layout.sumOfSourceLengths = 0;
+   layout.maxLength = 0;
+   for (uint pencili = 0; pencili < pencils.N; ++pencili) {
+      layout.sourceStart[pencili] = layout.sumOfSourceLengths;
+      layout.sumOfSourceLengths += pencils.lengthOfPencils[pencili] + 2 * VLASOV_STENCIL_WIDTH;
+      layout.maxLength = max(layout.maxLength, pencils.lengthOfPencils[pencili]);
+   }
+}
+
+/* Find the seed ids from which pencils have to be built after the local cells changed,
+ * and remove the pencils starting from them. A pencil depends only on its seed, on the
+ * ownership and seed status of its cells and of their neighbors in the pencil dimension,
+ * and on the refinement of the grid, which is not changed after initialization. All
+ * pencils starting from a seed are rebuilt together if any of their cells is affected.
+ *
+ * @param [in] mpiGrid DCCRG grid object
+ * @param [in] sortedCells Sorted local propagated cells
+ * @param [in] seedIds Sorted seed ids of the current cells
+ * @param [in] dimension Spatial dimension
+ * @param [in,out] pencils Pencil data struct, the affected pencils are removed
+ * @param [out] buildSeedIds Seed ids from which pencils have to be built
+ */
+void removeChangedPencils(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+                          const vector<CellID>& sortedCells,
+                          const vector<CellID>& seedIds,
+                          const uint dimension,
+                          setOfPencils& pencils,
+                          vector<CellID>& buildSeedIds) {
+
+   const vector<CellID>& previousCells = pencilBuildCells[dimension];
+   const vector<CellID>& previousSeedIds = pencilBuildSeedIds[dimension];
+
+   vector<CellID> departedCells, arrivedCells, changedSeedIds;
+   std::set_difference(previousCells.begin(), previousCells.end(), sortedCells.begin(), sortedCells.end(),
+                       std::back_inserter(departedCells));
+   std::set_difference(sortedCells.begin(), sortedCells.end(), previousCells.begin(), previousCells.end(),
+                       std::back_inserter(arrivedCells));
+   std::set_symmetric_difference(previousSeedIds.begin(), previousSeedIds.end(), seedIds.begin(), seedIds.end(),
+                                 std::back_inserter(changedSeedIds));
+
+   // Cells whose pencils are affected: departed cells, cells whose seed status changed,
+   // and the local neighbors in the pencil dimension of arrived cells and of changed seeds.
+   vector<CellID> dirtyCells(departedCells);
+   dirtyCells.insert(dirtyCells.end(), changedSeedIds.begin(), changedSeedIds.end());
+   vector<CellID> changedCells(arrivedCells);
+   changedCells.insert(changedCells.end(), changedSeedIds.begin(), changedSeedIds.end());
+   for (const auto cell : changedCells) {
+      if (!mpiGrid.is_local(cell)) continue;
+      for (const auto faceNbrPair : mpiGrid.get_face_neighbors_of(cell)) {
+         if (abs(faceNbrPair.second) == (int)dimension + 1 && mpiGrid.is_local(faceNbrPair.first)) {
+            dirtyCells.push_back(faceNbrPair.first);
+         }
+      }
+   }
+   std::sort(dirtyCells.begin(), dirtyCells.end());
+   dirtyCells.erase(std::unique(dirtyCells.begin(), dirtyCells.end()), dirtyCells.end());
+
+   vector<CellID> dirtySeedIds;
+   for (uint pencili = 0; pencili < pencils.N; ++pencili) {
+      auto ibeg = pencils.ids.begin() + pencils.idsStart[pencili];
+      auto iend = ibeg + pencils.lengthOfPencils[pencili];
+      if (std::any_of(ibeg, iend, [&dirtyCells](CellID id){return std::binary_search(dirtyCells.begin(), dirtyCells.end(), id);})) {
+         dirtySeedIds.push_back(*ibeg);
+      }
+   }
+   std::sort(dirtySeedIds.begin(), dirtySeedIds.end());
+   dirtySeedIds.erase(std::unique(dirtySeedIds.begin(), dirtySeedIds.end()), dirtySeedIds.end());
+
+   setOfPencils keptPencils;
+   vector<CellID> keptSeedIds;
+   for (uint pencili = 0; pencili < pencils.N; ++pencili) {
+      const CellID seedId = pencils.ids[pencils.idsStart[pencili]];
+      if (std::binary_search(dirtySeedIds.begin(), dirtySeedIds.end(), seedId)) continue;
+      keptPencils.addPencil(pencils.getIds(pencili), pencils.x[pencili], pencils.y[pencili],
+                            pencils.periodic[pencili], pencils.path[pencili]);
+      keptSeedIds.push_back(seedId);
+   }
+   std::sort(keptSeedIds.begin(), keptSeedIds.end());
+   keptSeedIds.erase(std::unique(keptSeedIds.begin(), keptSeedIds.end()), keptSeedIds.end());
+   pencils = keptPencils;
+
+   buildSeedIds.clear();
+   for (const auto seedId : seedIds) {
+      if (!std::binary_search(keptSeedIds.begin(), keptSeedIds.end(), seedId)) {
+         buildSeedIds.push_back(seedId);
+      }
+   }
+}
+
 /* Wrapper function for calling seed ID selection and pencil generation, per dimension.
  * Includes threading and gathering of pencils into thread-containers.
+ * After the first call only the pencils affected by cells that migrated since the
+ * previous call are rebuilt.
  *
  * @param [in] mpiGrid DCCRG grid object
  * @param [in] dimension Spatial dimension
@@ -1328,14 +1450,24 @@ void prepareSeedIdsAndPencils(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Ge
    phiprof::start("getSeedIds");
    vector<CellID> seedIds;
    getSeedIds(mpiGrid, localPropagatedCells, dimension, seedIds);
+   // Sorted for the end id search of buildPencilsWithNeighbors
+   std::sort(seedIds.begin(), seedIds.end());
    phiprof::stop("getSeedIds");
 
    phiprof::start("buildPencils");
-   // Output vectors for ready pencils
-   //setOfPencils pencils;
+   std::sort(localPropagatedCells.begin(), localPropagatedCells.end());
+
+   // Seeds whose pencils are (re)built
+   vector<CellID> buildSeedIds;
+   if (pencilsBuilt[dimension]) {
+      removeChangedPencils(mpiGrid, localPropagatedCells, seedIds, dimension, DimensionPencils[dimension], buildSeedIds);
+   } else {
+      DimensionPencils[dimension].removeAllPencils();
+      buildSeedIds = seedIds;
+   }
 
-   // Clear previous set
-   DimensionPencils[dimension].removeAllPencils();
+   // Output vectors for ready pencils
+   setOfPencils pencils;
    
 #pragma omp parallel
    {
@@ -1350,8 +1482,8 @@ void prepareSeedIdsAndPencils(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Ge
       std::vector<CellID>::iterator ibeg, iend;
 
 #pragma omp for schedule(guided)
-      for (uint i=0; i<seedIds.size(); i++) {
-         cuint seedId = seedIds[i];
+      for (uint i=0; i<buildSeedIds.size(); i++) {
+         cuint seedId = buildSeedIds[i];
          // Construct pencils from the seedIds into a set of pencils.
          thread_pencils = buildPencilsWithNeighbors(mpiGrid, thread_pencils, seedId, ids, dimension, path, seedIds);
       }
@@ -1364,16 +1496,25 @@ void prepareSeedIdsAndPencils(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Ge
             ibeg = thread_pencils.ids.begin() + thread_pencils.idsStart[i];
             iend = ibeg + thread_pencils.lengthOfPencils[i];
             std::vector<CellID> pencilIds(ibeg, iend);
-            DimensionPencils[dimension].addPencil(pencilIds,thread_pencils.x[i],thread_pencils.y[i],thread_pencils.periodic[i],thread_pencils.path[i]);
+            pencils.addPencil(pencilIds,thread_pencils.x[i],thread_pencils.y[i],thread_pencils.periodic[i],thread_pencils.path[i]);
          }
       }
    }
 
    phiprof::start("check_ghost_cells");
-   // Check refinement of two ghost cells on each end of each pencil
-   check_ghost_cells(mpiGrid,DimensionPencils[dimension],dimension);
+   // Check refinement of two ghost cells on each end of each new pencil
+   check_ghost_cells(mpiGrid,pencils,dimension);
    phiprof::stop("check_ghost_cells");
 
+   for (uint i=0; i<pencils.N; i++) {
+      DimensionPencils[dimension].addPencil(pencils.getIds(i),pencils.x[i],pencils.y[i],pencils.periodic[i],pencils.path[i]);
+   }
+
+   pencilBuildCells[dimension].swap(localPropagatedCells);
+   pencilBuildSeedIds[dimension].swap(seedIds);
+   pencilsBuilt[dimension] = true;
+   computePencilBufferLayout(DimensionPencils[dimension], pencilBufferLayouts[dimension]);
+
    // ****************************************************************************
 
    if(printPencils) printPencilsFunc(DimensionPencils[dimension],dimension,myRank);
@@ -1388,6 +1529,7 @@ void prepareSeedIdsAndPencils(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Ge
  * @param [in] localPropagatedCells List of local cells that get propagated
  * ie. not boundary or DO_NOT_COMPUTE
  * @param [in] remoteTargetCells List of non-local target cells
+ * @param [in] unionOfBlocks Sorted list of blocks existing in any of the cells, see computeUnionOfBlocks
  * @param [in] dimension Spatial dimension
  * @param [in] dt Time step
  * @param [in] popId Particle population ID
@@ -1395,6 +1537,7 @@ void prepareSeedIdsAndPencils(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Ge
 bool trans_map_1d_amr(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
                       const vector<CellID>& localPropagatedCells,
                       const vector<CellID>& remoteTargetCells,
+                      const std::vector<vmesh::GlobalID>& unionOfBlocks,
                       std::vector<uint>& nPencils,
                       const uint dimension,
                       const Realv dt,
@@ -1478,8 +1621,11 @@ bool trans_map_1d_amr(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
    // }
    
    if (Parameters::prepareForRebalance == true) {
+      std::vector<CellID> sortedPencilIds(DimensionPencils[dimension].ids);
+      std::sort(sortedPencilIds.begin(), sortedPencilIds.end());
       for (uint i=0; i<localPropagatedCells.size(); i++) {
-         cuint myPencilCount = std::count(DimensionPencils[dimension].ids.begin(), DimensionPencils[dimension].ids.end(), localPropagatedCells[i]);
+         const auto range = std::equal_range(sortedPencilIds.begin(), sortedPencilIds.end(), localPropagatedCells[i]);
+         cuint myPencilCount = std::distance(range.first, range.second);
          nPencils[i] += myPencilCount;
          nPencils[nPencils.size()-1] += myPencilCount;
       }
@@ -1488,37 +1634,6 @@ bool trans_map_1d_amr(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
    // Get a pointer to the velocity mesh of the first spatial cell
    const vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& vmesh = allCellsPointer[0]->get_velocity_mesh(popID);
    
-   phiprof::start("buildBlockList");
-   // Get a unique sorted list of blockids that are in any of the
-   // propagated cells. First use set for this, then add to vector (may not
-   // be the most nice way to do this and in any case we could do it along
-   // dimension for data locality reasons => copy acc map column code, TODO: FIXME
-   // TODO: Do this separately for each pencil?
-   std::vector<vmesh::GlobalID> unionOfBlocks;
-   std::unordered_set<vmesh::GlobalID> unionOfBlocksSet;
-//   unionOfBlocks.reserve(unionOfBlocksSet.size());
-#pragma omp parallel
-   {
-      std::unordered_set<vmesh::GlobalID> thread_unionOfBlocksSet;
-      
-#pragma omp for
-      for(unsigned int i=0; i<allCellsPointer.size(); i++) {
-         auto cell = &allCellsPointer[i];
-         vmesh::VelocityMesh<vmesh::GlobalID,vmesh::LocalID>& cvmesh = (*cell)->get_velocity_mesh(popID);
-         for (vmesh::LocalID block_i=0; block_i< cvmesh.size(); ++block_i) {
-            thread_unionOfBlocksSet.insert(cvmesh.getGlobalID(block_i));
-         }
-      }
-
-#pragma omp critical
-      {
-         unionOfBlocksSet.insert(thread_unionOfBlocksSet.begin(), thread_unionOfBlocksSet.end());
-      } // pragma omp critical
-   } // pragma omp parallel
-   
-   unionOfBlocks.insert(unionOfBlocks.end(), unionOfBlocksSet.begin(), unionOfBlocksSet.end());
-   
-   phiprof::stop("buildBlockList");
    // ****************************************************************************
    
    // Assuming 1 neighbor in the target array because of the CFL condition
@@ -1532,6 +1647,29 @@ bool trans_map_1d_amr(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
    computeSpatialTargetCellsForPencilsWithFaces(mpiGrid, DimensionPencils[dimension], dimension, targetCells.data());
    phiprof::stop("computeSpatialTargetCellsForPencils");
    
+   // Compute spatial neighbors for the source cells of the pencils, and the cell sizes in the
+   // direction of the pencils. In source cells we have a wider stencil and take into account
+   // boundaries. The buffers are shared by the threads and only grow.
+   phiprof::start("computeSpatialSourceCellsForPencils");
+   const setOfPencils& pencils = DimensionPencils[dimension];
+   const PencilBufferLayout& layout = pencilBufferLayouts[dimension];
+   static std::vector<SpatialCell*> pencilSourceCells;
+   static std::vector<Vec, aligned_allocator<Vec,WID3>> pencildz;
+   if (pencilSourceCells.size() < layout.sumOfSourceLengths) {
+      pencilSourceCells.resize(layout.sumOfSourceLengths);
+      pencildz.resize(layout.sumOfSourceLengths);
+   }
+   #pragma omp parallel for schedule(guided)
+   for(uint pencili = 0; pencili < pencils.N; ++pencili) {
+      cuint sourceLength = pencils.lengthOfPencils[pencili] + 2 * VLASOV_STENCIL_WIDTH;
+      SpatialCell** sourceCells = pencilSourceCells.data() + layout.sourceStart[pencili];
+      computeSpatialSourceCellsForPencil(mpiGrid, DimensionPencils[dimension], pencili, dimension, sourceCells);
+      Vec* dz = pencildz.data() + layout.sourceStart[pencili];
+      for(uint i = 0; i < sourceLength; ++i) {
+         dz[i] = sourceCells[i]->parameters[CellParams::DX+dimension];
+      }
+   }
+   phiprof::stop("computeSpatialSourceCellsForPencils");
    
    phiprof::stop("setup");
    
@@ -1540,41 +1678,18 @@ bool trans_map_1d_amr(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
    
    #pragma omp parallel
    {
-      // declarations for variables needed by the threads
-      std::vector<Realf, aligned_allocator<Realf, WID3>> targetBlockData((DimensionPencils[dimension].sumOfLengths + 2 * nTargetNeighborsPerPencil * DimensionPencils[dimension].N) * WID3);
-      std::vector<std::vector<SpatialCell*>> pencilSourceCells;
-      
-      // Allocate aligned vectors which are needed once per pencil to avoid reallocating once per block loop + pencil loop iteration
-      std::vector<std::vector<Vec, aligned_allocator<Vec,WID3>>> pencilTargetValues;
-      std::vector<std::vector<Vec, aligned_allocator<Vec,WID3>>> pencilSourceVecData;
-      std::vector<std::vector<Vec, aligned_allocator<Vec,WID3>>> pencildz;
-      
-      for(uint pencili = 0; pencili < DimensionPencils[dimension].N; ++pencili) {
-         
-         cint L = DimensionPencils[dimension].lengthOfPencils[pencili];
-         cuint sourceLength = L + 2 * VLASOV_STENCIL_WIDTH;
-         
-         // Vector buffer where we write data, initialized to 0*/
-         std::vector<Vec, aligned_allocator<Vec,WID3>> targetValues((L + 2 * nTargetNeighborsPerPencil) * WID3 / VECL);
-         pencilTargetValues.push_back(targetValues);
-         // Allocate source data: sourcedata<length of pencil * WID3)
-         // Add padding by 2 * VLASOV_STENCIL_WIDTH
-         std::vector<Vec, aligned_allocator<Vec,WID3>> sourceVecData(sourceLength * WID3 / VECL);
-         pencilSourceVecData.push_back(sourceVecData);
-
-         // Compute spatial neighbors for the source cells of the pencil. In
-         // source cells we have a wider stencil and take into account boundaries.
-         std::vector<SpatialCell*> sourceCells(sourceLength);
-         computeSpatialSourceCellsForPencil(mpiGrid, DimensionPencils[dimension], pencili, dimension, sourceCells.data());
-         pencilSourceCells.push_back(sourceCells);
-
-         // dz is the cell size in the direction of the pencil
-         std::vector<Vec, aligned_allocator<Vec,WID3>> dz(sourceLength);
-         for(uint i = 0; i < sourceCells.size(); ++i) {
-            dz[i] = sourceCells[i]->parameters[CellParams::DX+dimension];
-         }
-         pencildz.push_back(dz);
-      }
+      // Per-thread buffers, reused between calls. Pencils are mapped one at a time, so the
+      // source and target values only need room for the longest pencil. The target block data
+      // holds the results of all pencils until they are stored.
+      static thread_local std::vector<Realf, aligned_allocator<Realf, WID3>> targetBlockData;
+      static thread_local std::vector<Vec, aligned_allocator<Vec,WID3>> targetValues;
+      static thread_local std::vector<Vec, aligned_allocator<Vec,WID3>> sourceVecData;
+      const size_t targetBlockDataSize = (pencils.sumOfLengths + 2 * nTargetNeighborsPerPencil * pencils.N) * WID3;
+      const size_t targetValuesSize = (layout.maxLength + 2 * nTargetNeighborsPerPencil) * WID3 / VECL;
+      const size_t sourceVecDataSize = (layout.maxLength + 2 * VLASOV_STENCIL_WIDTH) * WID3 / VECL;
+      if (targetBlockData.size() < targetBlockDataSize) targetBlockData.resize(targetBlockDataSize);
+      if (targetValues.size() < targetValuesSize) targetValues.resize(targetValuesSize);
+      if (sourceVecData.size() < sourceVecDataSize) sourceVecData.resize(sourceVecDataSize);
       
       // Loop over velocity space blocks. Thread this loop (over vspace blocks) with OpenMP.
       #pragma omp for schedule(guided)
@@ -1595,17 +1710,21 @@ bool trans_map_1d_amr(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
                //uint sourceLength = L + 2 * VLASOV_STENCIL_WIDTH;
                               
                // load data(=> sourcedata) / (proper xy reconstruction in future)
-               bool pencil_has_data = copy_trans_block_data_amr(pencilSourceCells[pencili].data(), blockGID, L, pencilSourceVecData[pencili].data(),
+               SpatialCell** sourceCells = pencilSourceCells.data() + layout.sourceStart[pencili];
+               bool pencil_has_data = copy_trans_block_data_amr(sourceCells, blockGID, L, sourceVecData.data(),
                                          cellid_transpose, popID);
 
                if(!pencil_has_data) {
+                  // The buffer is reused, clear what an earlier block left in it
+                  std::fill(targetBlockData.begin() + totalTargetLength * WID3,
+                            targetBlockData.begin() + (totalTargetLength + targetLength) * WID3, 0.0);
                   totalTargetLength += targetLength;
                   continue;
                }
 
                // Dz and sourceVecData are both padded by VLASOV_STENCIL_WIDTH
                // Dz has 1 value/cell, sourceVecData has WID3 values/cell
-               propagatePencil(pencildz[pencili].data(), pencilSourceVecData[pencili].data(), pencilTargetValues[pencili].data(), dimension, blockGID, dt, vmesh, L, pencilSourceCells[pencili][0]->getVelocityBlockMinValue(popID));
+               propagatePencil(pencildz.data() + layout.sourceStart[pencili], sourceVecData.data(), targetValues.data(), dimension, blockGID, dt, vmesh, L, sourceCells[0]->getVelocityBlockMinValue(popID));
 
                // sourceVecData => targetBlockData[this pencil])
 
@@ -1617,9 +1736,8 @@ bool trans_map_1d_amr(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
                      for(uint planeVector = 0; planeVector < VEC_PER_PLANE; planeVector++){
 
                         // Unpack the vector data
-                        Realf vector[VECL];
-                        //pencilSourceVecData[pencili][i_trans_ps_blockv_pencil(planeVector, k, icell - 1, L)].store(vector);
-                        pencilTargetValues[pencili][i_trans_pt_blockv(planeVector, k, icell - 1)].store(vector);
+                        Realv vector[VECL];
+                        targetValues[i_trans_pt_blockv(planeVector, k, icell - 1)].store(vector);
 
                         // Loop over 3rd (vectorized) vspace dimension
                         for (uint iv = 0; iv < VECL; iv++) {
@@ -1634,7 +1752,7 @@ bool trans_map_1d_amr(const dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
                }
                totalTargetLength += targetLength;
                
-            } // Closes loop over pencils. SourceVecData gets implicitly deallocated here.
+            } // Closes loop over pencils.
 
             phiprof::stop(t1);
             phiprof::start(t2);
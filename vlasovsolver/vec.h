@@ -195,6 +195,41 @@ const Vec one_twelfth(1.0/12.0);
 const Vec seven_twelfth(7.0/12.0);
 const Vec one_third(1.0/3.0);
 
+/* Loads and stores of distribution function data. With 16-bit storage
+   (HPF) the values are converted between Realf and the vector precision,
+   otherwise these are plain vector loads and stores.*/
+inline void load_realf(Vec& v, const Realf* p) {
+#ifdef HPF
+   Realv values[VECL];
+   for (int i = 0; i < VECL; ++i) {
+      values[i] = p[i];
+   }
+   v.load(values);
+#else
+   v.load(p);
+#endif
+}
+
+inline void load_realf_a(Vec& v, const Realf* p) {
+#ifdef HPF
+   load_realf(v, p);
+#else
+   v.load_a(p);
+#endif
+}
+
+inline void store_realf_a(const Vec& v, Realf* p) {
+#ifdef HPF
+   Realv values[VECL];
+   v.store(values);
+   for (int i = 0; i < VECL; ++i) {
+      p[i] = values[i];
+   }
+#else
+   v.store_a(p);
+#endif
+}
+
 
 
 
@@ -54,6 +54,53 @@ using namespace std;
 using namespace spatial_cell;
 
 
+/** Transfers the stencil data of one dimension and maps the distribution
+    function along it, overlapping the two.
+
+    Velocity blocks that exist in none of the cells sent or received by the
+    transfer are mapped while it is in flight, the rest once it has completed.
+    Only used without AMR.
+*/
+static void overlapStencilTransferAndMapping(
+        dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
+        const vector<CellID>& local_propagated_cells,
+        const vector<CellID>& remoteTargetCells,
+        const vector<vmesh::GlobalID>& unionOfBlocks,
+        const uint dimension,
+        const int neighborhood,
+        creal dt,
+        const uint popID,
+        Real &time
+) {
+   const string dimName(1, "xyz"[dimension]);
+   vector<vmesh::GlobalID> innerBlocks;
+   vector<vmesh::GlobalID> boundaryBlocks;
+   splitBlocksOnProcessBoundary(mpiGrid, neighborhood, unionOfBlocks, popID, innerBlocks, boundaryBlocks);
+
+   int trans_timer=phiprof::initializeTimer("transfer-stencil-data-"+dimName,"MPI");
+   phiprof::start(trans_timer);
+   SpatialCell::set_mpi_transfer_direction(dimension);
+   SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_DATA,false,false);
+   mpiGrid.start_remote_neighbor_copy_updates(neighborhood);
+   phiprof::stop(trans_timer);
+
+   double t1 = MPI_Wtime();
+   phiprof::start("compute-mapping-"+dimName+"-inner");
+   trans_map_1d(mpiGrid,local_propagated_cells, remoteTargetCells, innerBlocks, dimension, dt, popID);
+   phiprof::stop("compute-mapping-"+dimName+"-inner");
+   time += MPI_Wtime() - t1;
+
+   phiprof::start(trans_timer);
+   mpiGrid.wait_remote_neighbor_copy_updates(neighborhood);
+   phiprof::stop(trans_timer);
+
+   t1 = MPI_Wtime();
+   phiprof::start("compute-mapping-"+dimName+"-boundary");
+   trans_map_1d(mpiGrid,local_propagated_cells, remoteTargetCells, boundaryBlocks, dimension, dt, popID);
+   phiprof::stop("compute-mapping-"+dimName+"-boundary");
+   time += MPI_Wtime() - t1;
+}
+
 /** Propagates the distribution function in spatial space.
 
     Based on SLICE-3D algorithm: Zerroukat, M., and T. Allen. "A
@@ -76,6 +123,15 @@ void calculateSpatialTranslation(
         Real &time
 ) {
 
+    // Blocks existing in the propagated cells or in any of the remote target cells.
+    // Block lists do not change during translation, so this is shared by all dimensions.
+    vector<CellID> unionCells(local_propagated_cells);
+    unionCells.insert(unionCells.end(), remoteTargetCellsx.begin(), remoteTargetCellsx.end());
+    unionCells.insert(unionCells.end(), remoteTargetCellsy.begin(), remoteTargetCellsy.end());
+    unionCells.insert(unionCells.end(), remoteTargetCellsz.begin(), remoteTargetCellsz.end());
+    vector<vmesh::GlobalID> unionOfBlocks;
+    computeUnionOfBlocks(mpiGrid, unionCells, popID, unionOfBlocks);
+
     int trans_timer;
     //bool localTargetGridGenerated = false;
     bool AMRtranslationActive = false;
@@ -94,28 +150,33 @@ void calculateSpatialTranslation(
     // ------------- SLICE - map dist function in Z --------------- //
    if(meshParams.zcells_ini > 1){
 
-      trans_timer=phiprof::initializeTimer("transfer-stencil-data-z","MPI");
-      phiprof::start(trans_timer);
-      //updateRemoteVelocityBlockLists(mpiGrid,popID,VLASOV_SOLVER_Z_NEIGHBORHOOD_ID);
-      SpatialCell::set_mpi_transfer_direction(2);
-      SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_DATA,false,AMRtranslationActive);
-      mpiGrid.update_copies_of_remote_neighbors(VLASOV_SOLVER_Z_NEIGHBORHOOD_ID);
-      phiprof::stop(trans_timer);
-
-      // bt=phiprof::initializeTimer("barrier-trans-pre-trans_map_1d-z","Barriers","MPI");
-      // phiprof::start(bt);
-      // MPI_Barrier(MPI_COMM_WORLD);
-      // phiprof::stop(bt);
-
-      t1 = MPI_Wtime();
-      phiprof::start("compute-mapping-z");
-      if(P::amrMaxSpatialRefLevel == 0) {
-         trans_map_1d(mpiGrid,local_propagated_cells, remoteTargetCellsz, 2, dt,popID); // map along z//
+      if (P::overlapTranslationHalo && P::amrMaxSpatialRefLevel == 0) {
+         overlapStencilTransferAndMapping(mpiGrid, local_propagated_cells, remoteTargetCellsz, unionOfBlocks,
+                                          2, VLASOV_SOLVER_Z_NEIGHBORHOOD_ID, dt, popID, time);
       } else {
-         trans_map_1d_amr(mpiGrid,local_propagated_cells, remoteTargetCellsz, nPencils, 2, dt,popID); // map along z//
+         trans_timer=phiprof::initializeTimer("transfer-stencil-data-z","MPI");
+         phiprof::start(trans_timer);
+         //updateRemoteVelocityBlockLists(mpiGrid,popID,VLASOV_SOLVER_Z_NEIGHBORHOOD_ID);
+         SpatialCell::set_mpi_transfer_direction(2);
+         SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_DATA,false,AMRtranslationActive);
+         mpiGrid.update_copies_of_remote_neighbors(VLASOV_SOLVER_Z_NEIGHBORHOOD_ID);
+         phiprof::stop(trans_timer);
+
+         // bt=phiprof::initializeTimer("barrier-trans-pre-trans_map_1d-z","Barriers","MPI");
+         // phiprof::start(bt);
+         // MPI_Barrier(MPI_COMM_WORLD);
+         // phiprof::stop(bt);
+
+         t1 = MPI_Wtime();
+         phiprof::start("compute-mapping-z");
+         if(P::amrMaxSpatialRefLevel == 0) {
+            trans_map_1d(mpiGrid,local_propagated_cells, remoteTargetCellsz, unionOfBlocks, 2, dt,popID); // map along z//
+         } else {
+            trans_map_1d_amr(mpiGrid,local_propagated_cells, remoteTargetCellsz, unionOfBlocks, nPencils, 2, dt,popID); // map along z//
+         }
+         phiprof::stop("compute-mapping-z");
+         time += MPI_Wtime() - t1;
       }
-      phiprof::stop("compute-mapping-z");
-      time += MPI_Wtime() - t1;
 
       // bt=phiprof::initializeTimer("barrier-trans-pre-update_remote-z","Barriers","MPI");
       // phiprof::start(bt);
@@ -143,28 +204,33 @@ void calculateSpatialTranslation(
    // ------------- SLICE - map dist function in X --------------- //
    if(meshParams.xcells_ini > 1){
 
-      trans_timer=phiprof::initializeTimer("transfer-stencil-data-x","MPI");
-      phiprof::start(trans_timer);
-      //updateRemoteVelocityBlockLists(mpiGrid,popID,VLASOV_SOLVER_X_NEIGHBORHOOD_ID);
-      SpatialCell::set_mpi_transfer_direction(0);
-      SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_DATA,false,AMRtranslationActive);
-      mpiGrid.update_copies_of_remote_neighbors(VLASOV_SOLVER_X_NEIGHBORHOOD_ID);
-      phiprof::stop(trans_timer);
-      
-      // bt=phiprof::initializeTimer("barrier-trans-pre-trans_map_1d-x","Barriers","MPI");
-      // phiprof::start(bt);
-      // MPI_Barrier(MPI_COMM_WORLD);
-      // phiprof::stop(bt);
-
-      t1 = MPI_Wtime();
-      phiprof::start("compute-mapping-x");
-      if(P::amrMaxSpatialRefLevel == 0) {
-         trans_map_1d(mpiGrid,local_propagated_cells, remoteTargetCellsx, 0,dt,popID); // map along x//
+      if (P::overlapTranslationHalo && P::amrMaxSpatialRefLevel == 0) {
+         overlapStencilTransferAndMapping(mpiGrid, local_propagated_cells, remoteTargetCellsx, unionOfBlocks,
+                                          0, VLASOV_SOLVER_X_NEIGHBORHOOD_ID, dt, popID, time);
       } else {
-         trans_map_1d_amr(mpiGrid,local_propagated_cells, remoteTargetCellsx, nPencils, 0,dt,popID); // map along x//
+         trans_timer=phiprof::initializeTimer("transfer-stencil-data-x","MPI");
+         phiprof::start(trans_timer);
+         //updateRemoteVelocityBlockLists(mpiGrid,popID,VLASOV_SOLVER_X_NEIGHBORHOOD_ID);
+         SpatialCell::set_mpi_transfer_direction(0);
+         SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_DATA,false,AMRtranslationActive);
+         mpiGrid.update_copies_of_remote_neighbors(VLASOV_SOLVER_X_NEIGHBORHOOD_ID);
+         phiprof::stop(trans_timer);
+         
+         // bt=phiprof::initializeTimer("barrier-trans-pre-trans_map_1d-x","Barriers","MPI");
+         // phiprof::start(bt);
+         // MPI_Barrier(MPI_COMM_WORLD);
+         // phiprof::stop(bt);
+
+         t1 = MPI_Wtime();
+         phiprof::start("compute-mapping-x");
+         if(P::amrMaxSpatialRefLevel == 0) {
+            trans_map_1d(mpiGrid,local_propagated_cells, remoteTargetCellsx, unionOfBlocks, 0,dt,popID); // map along x//
+         } else {
+            trans_map_1d_amr(mpiGrid,local_propagated_cells, remoteTargetCellsx, unionOfBlocks, nPencils, 0,dt,popID); // map along x//
+         }
+         phiprof::stop("compute-mapping-x");
+         time += MPI_Wtime() - t1;
       }
-      phiprof::stop("compute-mapping-x");
-      time += MPI_Wtime() - t1;
 
       // bt=phiprof::initializeTimer("barrier-trans-pre-update_remote-x","Barriers","MPI");
       // phiprof::start(bt);
@@ -192,28 +258,33 @@ void calculateSpatialTranslation(
    // ------------- SLICE - map dist function in Y --------------- //
    if(meshParams.ycells_ini > 1) {
 
-      trans_timer=phiprof::initializeTimer("transfer-stencil-data-y","MPI");
-      phiprof::start(trans_timer);
-      //updateRemoteVelocityBlockLists(mpiGrid,popID,VLASOV_SOLVER_Y_NEIGHBORHOOD_ID);
-      SpatialCell::set_mpi_transfer_direction(1);
-      SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_DATA,false,AMRtranslationActive);
-      mpiGrid.update_copies_of_remote_neighbors(VLASOV_SOLVER_Y_NEIGHBORHOOD_ID);
-      phiprof::stop(trans_timer);
-      
-      // bt=phiprof::initializeTimer("barrier-trans-pre-trans_map_1d-y","Barriers","MPI");
-      // phiprof::start(bt);
-      // MPI_Barrier(MPI_COMM_WORLD);
-      // phiprof::stop(bt);
-
-      t1 = MPI_Wtime();
-      phiprof::start("compute-mapping-y");
-      if(P::amrMaxSpatialRefLevel == 0) {
-         trans_map_1d(mpiGrid,local_propagated_cells, remoteTargetCellsy, 1,dt,popID); // map along y//
+      if (P::overlapTranslationHalo && P::amrMaxSpatialRefLevel == 0) {
+         overlapStencilTransferAndMapping(mpiGrid, local_propagated_cells, remoteTargetCellsy, unionOfBlocks,
+                                          1, VLASOV_SOLVER_Y_NEIGHBORHOOD_ID, dt, popID, time);
       } else {
-         trans_map_1d_amr(mpiGrid,local_propagated_cells, remoteTargetCellsy, nPencils, 1,dt,popID); // map along y//
+         trans_timer=phiprof::initializeTimer("transfer-stencil-data-y","MPI");
+         phiprof::start(trans_timer);
+         //updateRemoteVelocityBlockLists(mpiGrid,popID,VLASOV_SOLVER_Y_NEIGHBORHOOD_ID);
+         SpatialCell::set_mpi_transfer_direction(1);
+         SpatialCell::set_mpi_transfer_type(Transfer::VEL_BLOCK_DATA,false,AMRtranslationActive);
+         mpiGrid.update_copies_of_remote_neighbors(VLASOV_SOLVER_Y_NEIGHBORHOOD_ID);
+         phiprof::stop(trans_timer);
+         
+         // bt=phiprof::initializeTimer("barrier-trans-pre-trans_map_1d-y","Barriers","MPI");
+         // phiprof::start(bt);
+         // MPI_Barrier(MPI_COMM_WORLD);
+         // phiprof::stop(bt);
+
+         t1 = MPI_Wtime();
+         phiprof::start("compute-mapping-y");
+         if(P::amrMaxSpatialRefLevel == 0) {
+            trans_map_1d(mpiGrid,local_propagated_cells, remoteTargetCellsy, unionOfBlocks, 1,dt,popID); // map along y//
+         } else {
+            trans_map_1d_amr(mpiGrid,local_propagated_cells, remoteTargetCellsy, unionOfBlocks, nPencils, 1,dt,popID); // map along y//
+         }
+         phiprof::stop("compute-mapping-y");
+         time += MPI_Wtime() - t1;
       }
-      phiprof::stop("compute-mapping-y");
-      time += MPI_Wtime() - t1;
       
       // bt=phiprof::initializeTimer("barrier-trans-pre-update_remote-y","Barriers","MPI");
       // phiprof::start(bt);
@@ -325,24 +396,44 @@ void calculateSpatialTranslation(
    }
 
    if (Parameters::prepareForRebalance == true) {
+      // The mapping loops over all cells block by block, so the measured
+      // mapping time is shared out in proportion to the per-cell counter.
       if(P::amrMaxSpatialRefLevel == 0) {
 //          const double deltat = (MPI_Wtime() - t1) / local_propagated_cells.size();
+         vector<Real> counters(localCells.size(), 0.0);
+         Real totalCounter = 0.0;
          for (size_t c=0; c<localCells.size(); ++c) {
 //            mpiGrid[localCells[c]]->parameters[CellParams::LBWEIGHTCOUNTER] += time / localCells.size();
             for (uint popID=0; popID<getObjectWrapper().particleSpecies.size(); ++popID) {
-               mpiGrid[localCells[c]]->parameters[CellParams::LBWEIGHTCOUNTER] += mpiGrid[localCells[c]]->get_number_of_velocity_blocks(popID);
+               counters[c] += mpiGrid[localCells[c]]->get_number_of_velocity_blocks(popID);
+            }
+            mpiGrid[localCells[c]]->parameters[CellParams::LBWEIGHTCOUNTER] += counters[c];
+            totalCounter += counters[c];
+         }
+         if (totalCounter > 0.0) {
+            for (size_t c=0; c<localCells.size(); ++c) {
+               mpiGrid[localCells[c]]->parameters[CellParams::LBWEIGHTTIME] += time * counters[c] / totalCounter;
             }
          }
       } else {
 //          const double deltat = MPI_Wtime() - t1;
+         vector<Real> counters(local_propagated_cells.size(), 0.0);
+         Real totalCounter = 0.0;
          for (size_t c=0; c<local_propagated_cells.size(); ++c) {
             Real counter = 0;
             for (uint popID=0; popID<getObjectWrapper().particleSpecies.size(); ++popID) {
                counter += mpiGrid[local_propagated_cells[c]]->get_number_of_velocity_blocks(popID);
             }
-            mpiGrid[local_propagated_cells[c]]->parameters[CellParams::LBWEIGHTCOUNTER] += nPencils[c] * counter;
+            counters[c] = nPencils[c] * counter;
+            mpiGrid[local_propagated_cells[c]]->parameters[CellParams::LBWEIGHTCOUNTER] += counters[c];
+            totalCounter += counters[c];
 //            mpiGrid[localCells[c]]->parameters[CellParams::LBWEIGHTCOUNTER] += time / localCells.size();
          }
+         if (totalCounter > 0.0) {
+            for (size_t c=0; c<local_propagated_cells.size(); ++c) {
+               mpiGrid[local_propagated_cells[c]]->parameters[CellParams::LBWEIGHTTIME] += time * counters[c] / totalCounter;
+            }
+         }
       }
    }
 
@@ -366,11 +457,15 @@ momentCalculation:
  * @param step The current subcycle step.
  * @param mpiGrid Parallel grid library.
  * @param propagatedCells List of cells in which the population is accelerated.
- * @param dt Timestep.*/
+ * @param dt Timestep.
+ * @param localSubcycling If true, every cell is accelerated over all of its subcycles, with
+ * a block adjustment based on its own velocity space between them. step and globalMaxSubcycles
+ * are then ignored.*/
 void calculateAcceleration(const uint popID,const uint globalMaxSubcycles,const uint step,
                            dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>& mpiGrid,
                            const std::vector<CellID>& propagatedCells,
-                           const Real& dt) {
+                           const Real& dt,
+                           const bool localSubcycling=false) {
    // Set active population
    SpatialCell::setCommunicatedSpecies(popID);
 
@@ -383,16 +478,41 @@ void calculateAcceleration(const uint popID,const uint globalMaxSubcycles,const
    std::size_t rndInt = std::hash<uint>()(P::tstep);
    uint map_order=rndInt%3;
 
-   // Semi-Lagrangian acceleration for those cells which are subcycled,
-   // dimension-by-dimension
-   #pragma omp parallel
-   {
-      // Start parallel acceleration region.
-      #pragma omp for schedule(dynamic,1)
-      for (size_t c=0; c<propagatedCells.size(); ++c) {
-         const CellID cellID = propagatedCells[c];
-         const Real maxVdt = mpiGrid[cellID]->get_max_v_dt(popID);
+   // Cells with many more blocks than the rest would keep one thread busy
+   // while the others idle at the end of the loop. Those are accelerated
+   // with the block column sets of each mapping split into tasks, shared
+   // among all threads, while light cells are accelerated one per thread.
+   vector<CellID> lightCells;
+   vector<CellID> heavyCells;
+#ifdef USE_CUDA
+   lightCells = propagatedCells;
+#else
+   size_t splitThreshold = P::accelerationSplitThreshold;
+   if (splitThreshold == 0 && propagatedCells.size() > 0) {
+      size_t totalBlocks = 0;
+      for (const CellID cellID : propagatedCells) {
+         totalBlocks += mpiGrid[cellID]->get_number_of_velocity_blocks(popID);
+      }
+      splitThreshold = 8 * totalBlocks / propagatedCells.size();
+   }
+   for (const CellID cellID : propagatedCells) {
+      if (mpiGrid[cellID]->get_number_of_velocity_blocks(popID) > splitThreshold) {
+         heavyCells.push_back(cellID);
+      } else {
+         lightCells.push_back(cellID);
+      }
+   }
+#endif
+
+   auto accelerateCell = [&](const CellID cellID, const bool splitColumnSets) {
+      SpatialCell* SC = mpiGrid[cellID];
+      const Real maxVdt = SC->get_max_v_dt(popID);
+      const uint firstStep = localSubcycling ? 0 : step;
+      const uint endStep = localSubcycling ? SC->get_population(popID).ACCSUBCYCLES : step + 1;
 
+      phiprof::start("cell-semilag-acc");
+      const double t1 = MPI_Wtime();
+      for (uint cellStep=firstStep; cellStep<endStep; ++cellStep) {
          //compute subcycle dt. The length is maxVdt on all steps
          //except the last one. This is to keep the neighboring
          //spatial cells in sync, so that two neighboring cells with
@@ -401,20 +521,49 @@ void calculateAcceleration(const uint popID,const uint globalMaxSubcycles,const
          //spatial block neighbors as much in sync as possible for
          //adjust blocks.
          Real subcycleDt;
-         if( (step + 1) * maxVdt > fabs(dt)) {
-            subcycleDt = max(fabs(dt) - step * maxVdt, 0.0);
+         if( (cellStep + 1) * maxVdt > fabs(dt)) {
+            subcycleDt = max(fabs(dt) - cellStep * maxVdt, 0.0);
          } else{
             subcycleDt = maxVdt;
          }
          if (dt<0) subcycleDt = -subcycleDt;
 
-         phiprof::start("cell-semilag-acc");
+         //with local subcycling blocks are added between the subcycles
+         //of this cell only, empty ones are removed by the final adjust
+         //done by the caller. The moments used in the transform are kept fixed for the
+         //whole step, as in the globally synchronised subcycling.
+         if (cellStep > firstStep) {
+            adjustLocalVelocityBlocks(SC, popID);
+         }
 #ifdef USE_CUDA
-         cuda_accelerate_cell(mpiGrid[cellID],popID,map_order,subcycleDt);
+         cuda_accelerate_cell(SC,popID,map_order,subcycleDt);
 #else
-         cpu_accelerate_cell(mpiGrid[cellID],popID,map_order,subcycleDt);
+         cpu_accelerate_cell(SC,popID,map_order,subcycleDt,splitColumnSets);
 #endif
-         phiprof::stop("cell-semilag-acc");
+      }
+      if (P::prepareForRebalance == true) {
+         SC->parameters[CellParams::LBWEIGHTTIME] += MPI_Wtime() - t1;
+      }
+      phiprof::stop("cell-semilag-acc");
+   };
+
+   // Semi-Lagrangian acceleration for those cells which are subcycled,
+   // dimension-by-dimension
+   #pragma omp parallel
+   {
+      // Heavy cells are queued as tasks, which threads pick up (together
+      // with the column set tasks they spawn) once they run out of light cells.
+      #pragma omp single nowait
+      for (size_t c=0; c<heavyCells.size(); ++c) {
+         const CellID cellID = heavyCells[c];
+         #pragma omp task firstprivate(cellID)
+         accelerateCell(cellID, true);
+      }
+
+      // Start parallel acceleration region.
+      #pragma omp for schedule(dynamic,1)
+      for (size_t c=0; c<lightCells.size(); ++c) {
+         accelerateCell(lightCells[c], false);
       }
    }
    //global adjust after each subcycle to keep number of blocks managable. Even the ones not
@@ -425,7 +574,8 @@ void calculateAcceleration(const uint popID,const uint globalMaxSubcycles,const
    //- All cells update and communicate their lists of content blocks
    //- Only cells which were accerelated on this step need to be adjusted (blocks removed or added).
    //- Not done here on last step (done after loop)
-   if(step < (globalMaxSubcycles - 1)) adjustVelocityBlocks(mpiGrid, propagatedCells, false, popID);
+   //- Not done at all with local subcycling, cells were adjusted between their own subcycles
+   if(!localSubcycling && step < (globalMaxSubcycles - 1)) adjustVelocityBlocks(mpiGrid, propagatedCells, false, popID);
 }
 
 /** Accelerate all particle populations to new time t+dt.
@@ -498,6 +648,14 @@ void calculateAcceleration(dccrg::Dccrg<SpatialCell,dccrg::Cartesian_Geometry>&
        cuda_acc_allocate(cudaMaxBlockCount);
 #endif
 
+       if (P::localAccelerationSubcycling) {
+          // Every cell runs all of its subcycles at once, no global
+          // synchronisation is needed until the final adjust below.
+          calculateAcceleration(popID,(uint)maxSubcycles,0,mpiGrid,propagatedCells,dt,true);
+          adjustVelocityBlocks(mpiGrid, cells, true, popID);
+          continue;
+       }
+
        // Compute global maximum for number of subcycles
        MPI_Allreduce(&maxSubcycles, &globalMaxSubcycles, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
 